@@ -0,0 +1,399 @@
+#include "BarnesHut.h"
+#include "Parallel.h"
+#include "Simd.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace {
+
+// Eksen bana 21 bit: 63 bitlik Morton kodu, her lde x en yksek bittir
+const int kTreeLevels = 21;
+// Bu derinlikteki hcreler ayr alt aalar olarak paralel kurulur (en fazla 8^2 = 64 grev)
+const int kParallelLevel = 2;
+
+uint64_t spreadBits(uint64_t value) {
+    value &= 0x1fffff;
+    value = (value | value << 32) & 0x1f00000000ffffULL;
+    value = (value | value << 16) & 0x1f0000ff0000ffULL;
+    value = (value | value << 8) & 0x100f00f00f00f00fULL;
+    value = (value | value << 4) & 0x10c30c30c30c30c3ULL;
+    value = (value | value << 2) & 0x1249249249249249ULL;
+    return value;
+}
+
+// Kk kp: krelerin snr kutusunu saran en kk kp
+void computeRootCell(const std::vector<Sphere>& spheres, glm::vec3& center, float& halfSize) {
+    const int threads = parallelThreadCount();
+    std::vector<glm::vec3> lower(threads, glm::vec3(1e30f)), upper(threads, glm::vec3(-1e30f));
+    parallelFor(spheres.size(), [&](size_t begin, size_t end, int thread) {
+        glm::vec3 low(1e30f), high(-1e30f);
+        for (size_t i = begin; i < end; ++i) {
+            low = glm::min(low, spheres[i].position);
+            high = glm::max(high, spheres[i].position);
+        }
+        lower[thread] = low;
+        upper[thread] = high;
+    });
+    glm::vec3 low(1e30f), high(-1e30f);
+    for (int t = 0; t < threads; ++t) {
+        low = glm::min(low, lower[t]);
+        high = glm::max(high, upper[t]);
+    }
+    glm::vec3 extent = high - low;
+    center = (low + high) * 0.5f;
+    halfSize = std::max(std::max(extent.x, extent.y), std::max(extent.z, 1e-6f)) * 0.5f * 1.001f;
+}
+
+// 8 bitlik basamaklarla kararl LSD taban sralamas. Dizi sabit paralara blnr, her para
+// kendi saya satrn doldurur ve (basamak, para) srasndaki nek toplamyla yerine yazar.
+// Tm anahtarlarn ayn basamakta olduu geiler atlanr.
+void sortByKey(BarnesHutState& state, size_t count) {
+    const size_t parts = std::max<size_t>(1, std::min<size_t>(parallelThreadCount(), count / 4096));
+    state.histograms.resize(parts * 256);
+    state.sortedKeys.resize(count);
+    state.sortedOrder.resize(count);
+
+    for (int shift = 0; shift < 3 * kTreeLevels; shift += 8) {
+        std::fill(state.histograms.begin(), state.histograms.end(), 0);
+        parallelFor(parts, [&](size_t begin, size_t end, int) {
+            for (size_t part = begin; part < end; ++part) {
+                size_t* histogram = &state.histograms[part * 256];
+                for (size_t i = count * part / parts; i < count * (part + 1) / parts; ++i) {
+                    ++histogram[(state.keys[i] >> shift) & 255];
+                }
+            }
+        }, 1);
+
+        bool uniform = false;
+        size_t offset = 0;
+        for (int digit = 0; digit < 256; ++digit) {
+            size_t digitTotal = 0;
+            for (size_t part = 0; part < parts; ++part) {
+                size_t value = state.histograms[part * 256 + digit];
+                state.histograms[part * 256 + digit] = offset;
+                offset += value;
+                digitTotal += value;
+            }
+            uniform = uniform || digitTotal == count;
+        }
+        if (uniform) continue;
+
+        parallelFor(parts, [&](size_t begin, size_t end, int) {
+            for (size_t part = begin; part < end; ++part) {
+                size_t* position = &state.histograms[part * 256];
+                for (size_t i = count * part / parts; i < count * (part + 1) / parts; ++i) {
+                    size_t target = position[(state.keys[i] >> shift) & 255]++;
+                    state.sortedKeys[target] = state.keys[i];
+                    state.sortedOrder[target] = state.order[i];
+                }
+            }
+        }, 1);
+        std::swap(state.keys, state.sortedKeys);
+        std::swap(state.order, state.sortedOrder);
+    }
+}
+
+void computeLeafMoments(OctreeNode& node, const BarnesHutState& state) {
+    float mass = 0.0f, x = 0.0f, y = 0.0f, z = 0.0f;
+    for (int i = node.begin; i < node.end; ++i) {
+        float m = state.bodyMass[i];
+        mass += m;
+        x += m * state.bodyX[i];
+        y += m * state.bodyY[i];
+        z += m * state.bodyZ[i];
+    }
+    node.mass = mass;
+    node.massX = x / mass;
+    node.massY = y / mass;
+    node.massZ = z / mass;
+}
+
+void computeInnerMoments(std::vector<OctreeNode>& nodes, int index) {
+    float mass = 0.0f, x = 0.0f, y = 0.0f, z = 0.0f;
+    const OctreeNode& node = nodes[index];
+    for (int c = node.firstChild; c < node.firstChild + node.childCount; ++c) {
+        float m = nodes[c].mass;
+        mass += m;
+        x += m * nodes[c].massX;
+        y += m * nodes[c].massY;
+        z += m * nodes[c].massZ;
+    }
+    OctreeNode& target = nodes[index];
+    target.mass = mass;
+    target.massX = x / mass;
+    target.massY = y / mass;
+    target.massZ = z / mass;
+}
+
+// nodes[index] hcresini Morton kodunun level. basamana gre en fazla 8 ocua bler. Kodlar sral
+// olduundan her ocuun aral ikili aramayla bulunur ve ocuklar ardk yerletirilir.
+// tasks verilmise kParallelLevel derinliindeki hcreler blnmek yerine greve dntrlr.
+void buildNode(std::vector<OctreeNode>& nodes, int index, int level, const BarnesHutState& state,
+    std::vector<int>* tasks) {
+    OctreeNode node = nodes[index];
+    if (node.end - node.begin <= state.settings.leafSize || level == kTreeLevels) {
+        nodes[index].childCount = 0;
+        computeLeafMoments(nodes[index], state);
+        return;
+    }
+    if (tasks && level == kParallelLevel) {
+        tasks->push_back(index);
+        return;
+    }
+
+    const int shift = 3 * (kTreeLevels - 1 - level);
+    const uint64_t* keys = state.keys.data();
+    int bounds[9];
+    bounds[0] = node.begin;
+    for (int digit = 0; digit < 8; ++digit) {
+        bounds[digit + 1] = static_cast<int>(std::upper_bound(keys + bounds[digit], keys + node.end, static_cast<uint64_t>(digit),
+            [shift](uint64_t digitValue, uint64_t key) { return digitValue < ((key >> shift) & 7); }) - keys);
+    }
+
+    int firstChild = static_cast<int>(nodes.size());
+    float quarter = node.halfSize * 0.5f;
+    for (int digit = 0; digit < 8; ++digit) {
+        if (bounds[digit] == bounds[digit + 1]) continue;
+        OctreeNode child = {};
+        child.centerX = node.centerX + ((digit & 4) ? quarter : -quarter);
+        child.centerY = node.centerY + ((digit & 2) ? quarter : -quarter);
+        child.centerZ = node.centerZ + ((digit & 1) ? quarter : -quarter);
+        child.halfSize = quarter;
+        child.begin = bounds[digit];
+        child.end = bounds[digit + 1];
+        nodes.push_back(child);
+    }
+    int childCount = static_cast<int>(nodes.size()) - firstChild;
+    nodes[index].firstChild = firstChild;
+    nodes[index].childCount = childCount;
+
+    for (int c = firstChild; c < firstChild + childCount; ++c) {
+        buildNode(nodes, c, level + 1, state, tasks);
+    }
+    if (!tasks) {
+        computeInnerMoments(nodes, index);
+    }
+}
+
+// st seviyeler seri kurulur; kParallelLevel derinliindeki alt aalar kendi dizilerinde paralel
+// kurulur ve indeksleri kaydrlarak ana diziye eklenir. st hcrelerin ktleleri en son toplanr.
+void buildOctree(BarnesHutState& state, const glm::vec3& center, float halfSize, int count) {
+    std::vector<OctreeNode>& nodes = state.nodes;
+    nodes.clear();
+    OctreeNode root = {};
+    root.centerX = center.x;
+    root.centerY = center.y;
+    root.centerZ = center.z;
+    root.halfSize = halfSize;
+    root.begin = 0;
+    root.end = count;
+    nodes.push_back(root);
+
+    std::vector<int> tasks;
+    buildNode(nodes, 0, 0, state, &tasks);
+    const int topCount = static_cast<int>(nodes.size());
+
+    if (state.subtreeNodes.size() < tasks.size()) {
+        state.subtreeNodes.resize(tasks.size());
+    }
+    parallelFor(tasks.size(), [&](size_t begin, size_t end, int) {
+        for (size_t t = begin; t < end; ++t) {
+            std::vector<OctreeNode>& subtree = state.subtreeNodes[t];
+            subtree.clear();
+            subtree.push_back(nodes[tasks[t]]);
+            buildNode(subtree, 0, kParallelLevel, state, nullptr);
+        }
+    }, 1);
+
+    // Alt aacn kk st aataki yerine, geri kalan sona yazlr: yerel l -> offset + l - 1
+    std::vector<int> offsets(tasks.size());
+    size_t total = topCount;
+    for (size_t t = 0; t < tasks.size(); ++t) {
+        offsets[t] = static_cast<int>(total);
+        total += state.subtreeNodes[t].size() - 1;
+    }
+    nodes.resize(total);
+    parallelFor(tasks.size(), [&](size_t begin, size_t end, int) {
+        for (size_t t = begin; t < end; ++t) {
+            const std::vector<OctreeNode>& subtree = state.subtreeNodes[t];
+            for (size_t l = 0; l < subtree.size(); ++l) {
+                OctreeNode node = subtree[l];
+                if (node.childCount > 0) node.firstChild += offsets[t] - 1;
+                nodes[l == 0 ? tasks[t] : offsets[t] + l - 1] = node;
+            }
+        }
+    }, 1);
+
+    // st aata ocuklar her zaman ebeveynden sonra eklendii iin ters srada toplanr
+    for (int index = topCount - 1; index >= 0; --index) {
+        if (nodes[index].childCount > 0) computeInnerMoments(nodes, index);
+    }
+
+    state.leaves.clear();
+    for (int index = 0; index < static_cast<int>(nodes.size()); ++index) {
+        if (nodes[index].childCount == 0) state.leaves.push_back(index);
+    }
+}
+
+void appendInteraction(BarnesHutState& state, int thread, float x, float y, float z, float mass) {
+    state.threadListX[thread].push_back(x);
+    state.threadListY[thread].push_back(y);
+    state.threadListZ[thread].push_back(z);
+    state.threadListMass[thread].push_back(mass);
+}
+
+// Aa her yaprak iin bir kez dolalr: alma lt hedef yapran hcresine olan en ksa
+// uzaklkla snanr, bylece kan etkileim listesi yapraktaki tm krelerde geerlidir.
+// Kabul edilen hcreler tek ktle, alan yapraklar tek tek kre olarak listeye girer.
+void buildInteractionList(BarnesHutState& state, int thread, const OctreeNode& target) {
+    const float thetaSquared = state.settings.theta * state.settings.theta;
+    std::vector<int>& stack = state.threadStack[thread];
+    state.threadListX[thread].clear();
+    state.threadListY[thread].clear();
+    state.threadListZ[thread].clear();
+    state.threadListMass[thread].clear();
+    stack.clear();
+    stack.push_back(0);
+
+    while (!stack.empty()) {
+        const OctreeNode& node = state.nodes[stack.back()];
+        stack.pop_back();
+
+        // Hedef yapra ieren hcre her zaman alr: ktle merkezi yapraktan uzak dse bile yapran
+        // kendi kreleri o tek ktlenin iinde kalrd. Hcreler ya i ie ya ayrk olduundan yapran
+        // merkezinin hcre iinde olmas yeterli bir snamadr.
+        bool containsTarget = std::abs(node.centerX - target.centerX) < node.halfSize
+            && std::abs(node.centerY - target.centerY) < node.halfSize
+            && std::abs(node.centerZ - target.centerZ) < node.halfSize;
+        float dx = std::max(std::abs(node.massX - target.centerX) - target.halfSize, 0.0f);
+        float dy = std::max(std::abs(node.massY - target.centerY) - target.halfSize, 0.0f);
+        float dz = std::max(std::abs(node.massZ - target.centerZ) - target.halfSize, 0.0f);
+        float size = 2.0f * node.halfSize;
+        if (!containsTarget && size * size < thetaSquared * (dx * dx + dy * dy + dz * dz)) {
+            appendInteraction(state, thread, node.massX, node.massY, node.massZ, node.mass);
+        } else if (node.childCount == 0) {
+            for (int i = node.begin; i < node.end; ++i) {
+                appendInteraction(state, thread, state.bodyX[i], state.bodyY[i], state.bodyZ[i], state.bodyMass[i]);
+            }
+        } else {
+            for (int c = node.firstChild; c < node.firstChild + node.childCount; ++c) {
+                stack.push_back(c);
+            }
+        }
+    }
+
+    // Dolgu: ktlesi sfr olan etkileimler ivmeye katk vermez
+    while (state.threadListX[thread].size() % SIMD_WIDTH != 0) {
+        appendInteraction(state, thread, 0.0f, 0.0f, 0.0f, 0.0f);
+    }
+}
+
+} // namespace
+
+
+void computeBarnesHutGravity(const std::vector<Sphere>& spheres, BarnesHutState& state) {
+    const size_t count = spheres.size();
+    state.accelerationX.assign(count, 0.0f);
+    state.accelerationY.assign(count, 0.0f);
+    state.accelerationZ.assign(count, 0.0f);
+    if (count < 2) return;
+
+    glm::vec3 center;
+    float halfSize;
+    computeRootCell(spheres, center, halfSize);
+
+    state.keys.resize(count);
+    state.order.resize(count);
+    parallelFor(count, [&](size_t begin, size_t end, int) {
+        const float scale = (1 << kTreeLevels) / (2.0f * halfSize);
+        const glm::vec3 corner = center - glm::vec3(halfSize);
+        const float largest = static_cast<float>((1 << kTreeLevels) - 1);
+        for (size_t i = begin; i < end; ++i) {
+            glm::vec3 cell = glm::clamp((spheres[i].position - corner) * scale, glm::vec3(0.0f), glm::vec3(largest));
+            state.keys[i] = spreadBits(static_cast<uint64_t>(cell.x)) << 2
+                | spreadBits(static_cast<uint64_t>(cell.y)) << 1
+                | spreadBits(static_cast<uint64_t>(cell.z));
+            state.order[i] = static_cast<int>(i);
+        }
+    });
+    sortByKey(state, count);
+
+    state.bodyX.resize(count);
+    state.bodyY.resize(count);
+    state.bodyZ.resize(count);
+    state.bodyMass.resize(count);
+    parallelFor(count, [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; ++i) {
+            const Sphere& sphere = spheres[state.order[i]];
+            state.bodyX[i] = sphere.position.x;
+            state.bodyY[i] = sphere.position.y;
+            state.bodyZ[i] = sphere.position.z;
+            state.bodyMass[i] = sphereMass(sphere.radius);
+        }
+    });
+
+    buildOctree(state, center, halfSize, static_cast<int>(count));
+
+    const int threads = parallelThreadCount();
+    for (std::vector<std::vector<float>>* lists : { &state.threadListX, &state.threadListY, &state.threadListZ, &state.threadListMass }) {
+        lists->resize(threads);
+    }
+    state.threadStack.resize(threads);
+
+    parallelFor(state.leaves.size(), [&](size_t begin, size_t end, int thread) {
+        const SimdFloat zero = simdSet(0.0f);
+        const SimdFloat tiny = simdSet(1e-20f);
+        const SimdFloat softeningSquared = simdSet(state.settings.softening * state.settings.softening);
+        alignas(32) float sums[3][SIMD_WIDTH];
+
+        for (size_t leaf = begin; leaf < end; ++leaf) {
+            const OctreeNode& target = state.nodes[state.leaves[leaf]];
+            buildInteractionList(state, thread, target);
+            const float* listX = state.threadListX[thread].data();
+            const float* listY = state.threadListY[thread].data();
+            const float* listZ = state.threadListZ[thread].data();
+            const float* listMass = state.threadListMass[thread].data();
+            const size_t listSize = state.threadListX[thread].size();
+
+            for (int i = target.begin; i < target.end; ++i) {
+                SimdFloat xi = simdSet(state.bodyX[i]), yi = simdSet(state.bodyY[i]), zi = simdSet(state.bodyZ[i]);
+                SimdFloat ax = zero, ay = zero, az = zero;
+                // a = sum m d / (|d|^2 + eps^2)^(3/2); krenin kendisi d = 0 olduu iin katk vermez
+                for (size_t k = 0; k < listSize; k += SIMD_WIDTH) {
+                    SimdFloat dx = simdLoad(listX + k) - xi;
+                    SimdFloat dy = simdLoad(listY + k) - yi;
+                    SimdFloat dz = simdLoad(listZ + k) - zi;
+                    SimdFloat distanceSquared = simdMax(simdDot(dx, dy, dz, dx, dy, dz) + softeningSquared, tiny);
+                    SimdFloat strength = simdLoad(listMass + k) / (distanceSquared * simdSqrt(distanceSquared));
+                    ax = ax + strength * dx;
+                    ay = ay + strength * dy;
+                    az = az + strength * dz;
+                }
+                simdStore(sums[0], ax);
+                simdStore(sums[1], ay);
+                simdStore(sums[2], az);
+                float totalX = 0.0f, totalY = 0.0f, totalZ = 0.0f;
+                for (int lane = 0; lane < SIMD_WIDTH; ++lane) {
+                    totalX += sums[0][lane];
+                    totalY += sums[1][lane];
+                    totalZ += sums[2][lane];
+                }
+                int original = state.order[i];
+                state.accelerationX[original] = state.settings.gravitationalConstant * totalX;
+                state.accelerationY[original] = state.settings.gravitationalConstant * totalY;
+                state.accelerationZ[original] = state.settings.gravitationalConstant * totalZ;
+            }
+        }
+    }, 4);
+}
+
+void applyBarnesHutGravity(std::vector<Sphere>& spheres, BarnesHutState& state, float deltaTime) {
+    computeBarnesHutGravity(spheres, state);
+    parallelFor(spheres.size(), [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; ++i) {
+            spheres[i].velocity += glm::vec3(state.accelerationX[i], state.accelerationY[i], state.accelerationZ[i]) * deltaTime;
+        }
+    });
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Sphere.h"
+#include <cstdint>
+#include <vector>
+
+
+struct BarnesHutSettings {
+    bool enabled = false;
+    float gravitationalConstant = 1e-3f;
+    float theta = 0.5f;      // Alma as: hcre boyu / uzaklk bundan kkse hcre tek ktle saylr
+    float softening = 0.01f; // Plummer yumuatma uzunluu; rten krelerde kuvvet sonsuza gitmez
+    int leafSize = 32;       // Bundan az kre ieren hcreler blnmez; yaprak ayn zamanda ortak etkileim listesi grubudur
+};
+
+// Sekizli aacn bir hcresi. ocuklar nodes dizisinde firstChild'dan balayarak ardktr;
+// yapraklarda childCount sfrdr ve kreler sral dizilerde [begin, end) aralndadr.
+struct OctreeNode {
+    float centerX, centerY, centerZ, halfSize; // Hcrenin geometrisi
+    float massX, massY, massZ, mass;           // Ktle merkezi ve toplam ktle
+    int firstChild, childCount;
+    int begin, end;
+};
+
+// Admlar arasnda yeniden kullanlan aa ve tamponlar
+struct BarnesHutState {
+    BarnesHutSettings settings;
+
+    // Kreler Morton koduna gre sralanr; body* dizileri bu sradadr, order zgn indeksleri verir
+    std::vector<uint64_t> keys, sortedKeys;
+    std::vector<int> order, sortedOrder;
+    std::vector<float> bodyX, bodyY, bodyZ, bodyMass;
+
+    std::vector<OctreeNode> nodes;
+    std::vector<int> leaves;
+
+    // zgn kre srasnda ivmeler
+    std::vector<float> accelerationX, accelerationY, accelerationZ;
+
+    // Paralel kurulan alt aalar; birletirilmeden nce her biri kendi dizisindedir
+    std::vector<std::vector<OctreeNode>> subtreeNodes;
+
+    //  parac bana etkileim listeleri ve taban sralamas sayalar
+    std::vector<std::vector<float>> threadListX, threadListY, threadListZ, threadListMass;
+    std::vector<std::vector<int>> threadStack;
+    std::vector<size_t> histograms;
+};
+
+// Kreler aras karlkl ekimi BarnesHut aacyla O(n log n) srede hesaplar
+void computeBarnesHutGravity(const std::vector<Sphere>& spheres, BarnesHutState& state);
+
+// vmeleri hesaplar ve hzlara deltaTime boyunca ekler
+void applyBarnesHutGravity(std::vector<Sphere>& spheres, BarnesHutState& state, float deltaTime);
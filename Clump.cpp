@@ -0,0 +1,230 @@
+#include "Clump.h"
+#include "Simd.h"
+#include "Sphere.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace {
+
+glm::mat3 worldInverseInertia(const ClumpSystem& clumps, size_t body) {
+    glm::mat3 inverse;
+    for (int row = 0; row < 3; ++row) {
+        for (int column = 0; column < 3; ++column) {
+            inverse[column][row] = clumps.inverseInertia[3 * row + column][body];
+        }
+    }
+    return inverse;
+}
+
+// d ynndeki etkin ters ktle: 1/m + (l x d) . I^-1 (l x d)
+float effectiveInverseMass(const ClumpSystem& clumps, size_t body, const glm::vec3& lever, const glm::vec3& direction) {
+    glm::vec3 arm = glm::cross(lever, direction);
+    return clumps.inverseMass[body] + glm::dot(arm, worldInverseInertia(clumps, body) * arm);
+}
+
+void padMembers(ClumpSystem& clumps, size_t size) {
+    clumps.owner.resize(size, 0);
+    clumps.offsetX.resize(size, 0.0f);
+    clumps.offsetY.resize(size, 0.0f);
+    clumps.offsetZ.resize(size, 0.0f);
+    clumps.memberRadius.resize(size, 0.0f);
+    clumps.worldX.resize(size, 0.0f);
+    clumps.worldY.resize(size, 0.0f);
+    clumps.worldZ.resize(size, 0.0f);
+}
+
+} // namespace
+
+
+int addClump(ClumpSystem& clumps, const std::vector<ClumpMember>& members, const glm::vec3& position,
+    const glm::vec3& velocity, int material, const glm::vec3& color) {
+    // Ktle merkezi, yeler krelerle ayn younlukta kabul edilerek
+    float mass = 0.0f;
+    glm::vec3 center(0.0f);
+    for (const ClumpMember& member : members) {
+        float memberMass = sphereMass(member.radius);
+        mass += memberMass;
+        center += member.offset * memberMass;
+    }
+    // yesiz ya da sfr yarapl gvdenin ktlesi ve eylemsizlii tanmszdr
+    if (!(mass > 0.0f)) return -1;
+    center /= mass;
+
+    glm::mat3 inertia(0.0f);
+    for (const ClumpMember& member : members) {
+        float memberMass = sphereMass(member.radius);
+        glm::vec3 d = member.offset - center;
+        inertia += glm::mat3(SPHERE_INERTIA_FACTOR * memberMass * member.radius * member.radius + memberMass * glm::dot(d, d))
+            - memberMass * glm::outerProduct(d, d);
+    }
+
+    int body = static_cast<int>(clumps.count++);
+    clumps.positionX.push_back(position.x);
+    clumps.positionY.push_back(position.y);
+    clumps.positionZ.push_back(position.z);
+    clumps.velocityX.push_back(velocity.x);
+    clumps.velocityY.push_back(velocity.y);
+    clumps.velocityZ.push_back(velocity.z);
+    clumps.inverseMass.push_back(1.0f / mass);
+    clumps.bodyInverseInertia.push_back(glm::inverse(inertia));
+    for (std::vector<float>& element : clumps.inverseInertia) {
+        element.push_back(0.0f);
+    }
+    clumps.material.push_back(material);
+    clumps.color.push_back(color);
+    resizeRotationState(clumps.rotation, clumps.count);
+
+    // nceki dolguyu at, yeleri ekle, yeniden tamamla
+    padMembers(clumps, clumps.memberCount);
+    for (const ClumpMember& member : members) {
+        clumps.owner.push_back(body);
+        clumps.offsetX.push_back(member.offset.x - center.x);
+        clumps.offsetY.push_back(member.offset.y - center.y);
+        clumps.offsetZ.push_back(member.offset.z - center.z);
+        clumps.memberRadius.push_back(member.radius);
+    }
+    clumps.memberCount += members.size();
+    padMembers(clumps, (clumps.memberCount + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH);
+
+    updateClumpMembers(clumps);
+    return body;
+}
+
+void integrateClumps(ClumpSystem& clumps, float deltaTime, const glm::vec3& impulse, float damping) {
+    for (size_t i = 0; i < clumps.count; ++i) {
+        clumps.velocityX[i] = clumps.velocityX[i] * damping + impulse.x;
+        clumps.velocityY[i] = clumps.velocityY[i] * damping + impulse.y;
+        clumps.velocityZ[i] = clumps.velocityZ[i] * damping + impulse.z;
+        clumps.positionX[i] += clumps.velocityX[i] * deltaTime;
+        clumps.positionY[i] += clumps.velocityY[i] * deltaTime;
+        clumps.positionZ[i] += clumps.velocityZ[i] * deltaTime;
+    }
+    integrateOrientations(clumps.rotation, deltaTime);
+}
+
+void updateClumpMembers(ClumpSystem& clumps) {
+    // I_dnya^-1 = R I_gvde^-1 R^T
+    for (size_t i = 0; i < clumps.count; ++i) {
+        glm::mat3 rotation = glm::mat3_cast(sphereOrientation(clumps.rotation, i));
+        glm::mat3 inverse = rotation * clumps.bodyInverseInertia[i] * glm::transpose(rotation);
+        for (int row = 0; row < 3; ++row) {
+            for (int column = 0; column < 3; ++column) {
+                clumps.inverseInertia[3 * row + column][i] = inverse[column][row];
+            }
+        }
+    }
+    if (clumps.memberCount == 0) return;
+
+    // ye konumu = merkez + q * offset; v' = v + w t + q.xyz x t, t = 2 (q.xyz x v)
+    const SimdFloat two = simdSet(2.0f);
+    for (size_t i = 0; i < clumps.owner.size(); i += SIMD_WIDTH) {
+        SimdInt body = simdLoadInt(&clumps.owner[i]);
+        SimdFloat qw = simdGather(clumps.rotation.orientationW.data(), body);
+        SimdFloat qx = simdGather(clumps.rotation.orientationX.data(), body);
+        SimdFloat qy = simdGather(clumps.rotation.orientationY.data(), body);
+        SimdFloat qz = simdGather(clumps.rotation.orientationZ.data(), body);
+        SimdFloat vx = simdLoad(&clumps.offsetX[i]);
+        SimdFloat vy = simdLoad(&clumps.offsetY[i]);
+        SimdFloat vz = simdLoad(&clumps.offsetZ[i]);
+
+        SimdFloat tx = two * (qy * vz - qz * vy);
+        SimdFloat ty = two * (qz * vx - qx * vz);
+        SimdFloat tz = two * (qx * vy - qy * vx);
+        simdStore(&clumps.worldX[i], simdGather(clumps.positionX.data(), body) + vx + qw * tx + (qy * tz - qz * ty));
+        simdStore(&clumps.worldY[i], simdGather(clumps.positionY.data(), body) + vy + qw * ty + (qz * tx - qx * tz));
+        simdStore(&clumps.worldZ[i], simdGather(clumps.positionZ.data(), body) + vz + qw * tz + (qx * ty - qy * tx));
+    }
+}
+
+void applyClumpImpulse(ClumpSystem& clumps, size_t body, const glm::vec3& point, const glm::vec3& impulse) {
+    float inverseMass = clumps.inverseMass[body];
+    clumps.velocityX[body] += impulse.x * inverseMass;
+    clumps.velocityY[body] += impulse.y * inverseMass;
+    clumps.velocityZ[body] += impulse.z * inverseMass;
+    glm::vec3 lever = point - clumpPosition(clumps, body);
+    addAngularVelocity(clumps.rotation, body, worldInverseInertia(clumps, body) * glm::cross(lever, impulse));
+}
+
+void checkClumpWallCollisions(ClumpSystem& clumps, float cubeSize, const Container& container, const MaterialTable& materials, int wallMaterial) {
+    float halfCubeSize = cubeSize / 2.0f;
+    const glm::mat3 basis = glm::mat3_cast(container.orientation);
+    const glm::mat3 toLocal = glm::transpose(basis);
+    for (size_t m = 0; m < clumps.memberCount; ++m) {
+        size_t body = clumps.owner[m];
+        int row = wallMaterial * MAX_MATERIALS + clumps.material[body];
+        float restitution = materials.restitution[row];
+        float friction = materials.friction[row];
+        glm::vec3 center = clumpMemberPosition(clumps, m);
+        glm::vec3 localCenter = toLocal * (center - container.position);
+        float radius = clumps.memberRadius[m];
+
+        for (int i = 0; i < 3; ++i) {
+            // Duvar normali kabn i. eksenidir (dnya erevesinde)
+            glm::vec3 normal;
+            if (localCenter[i] + radius > halfCubeSize) normal = basis[i];
+            else if (localCenter[i] - radius < -halfCubeSize) normal = -basis[i];
+            else continue;
+
+            // Temas noktasnn duvara gre, duvara doru hz; uzaklayorsa tepki yok
+            glm::vec3 point = center + normal * radius;
+            glm::vec3 lever = point - clumpPosition(clumps, body);
+            glm::vec3 pointVelocity = clumpVelocity(clumps, body) + glm::cross(sphereAngularVelocity(clumps.rotation, body), lever)
+                - containerPointVelocity(container, point);
+            float normalSpeed = glm::dot(pointVelocity, normal);
+            if (normalSpeed <= 0.0f) continue;
+
+            float normalImpulse = (1.0f + restitution) * normalSpeed / effectiveInverseMass(clumps, body, lever, normal);
+            glm::vec3 impulse = -normal * normalImpulse;
+
+            glm::vec3 slip = pointVelocity - normal * normalSpeed;
+            float slipSpeed = glm::length(slip);
+            if (slipSpeed > 0.0f) {
+                glm::vec3 tangent = slip / slipSpeed;
+                float stopImpulse = slipSpeed / effectiveInverseMass(clumps, body, lever, tangent);
+                impulse -= tangent * std::min(friction * normalImpulse, stopImpulse);
+            }
+            applyClumpImpulse(clumps, body, point, impulse);
+        }
+    }
+
+    // Duvara giren yeler gvdeyi ieri iter (kap erevesinde, eksen bana en derin yeye gre); kre
+    // duvar ekirdeindeki konum kstrmasnn karldr. yelerin dnya konumlar da ayn kadar kayar.
+    clumps.wallPush.assign(clumps.count, glm::vec3(0.0f));
+    for (size_t m = 0; m < clumps.memberCount; ++m) {
+        size_t body = clumps.owner[m];
+        glm::vec3 localCenter = toLocal * (clumpMemberPosition(clumps, m) - container.position);
+        float radius = clumps.memberRadius[m];
+        glm::vec3& push = clumps.wallPush[body];
+        for (int i = 0; i < 3; ++i) {
+            push[i] = std::min(push[i], halfCubeSize - (localCenter[i] + radius));
+            push[i] = std::max(push[i], -halfCubeSize - (localCenter[i] - radius));
+        }
+    }
+    for (size_t body = 0; body < clumps.count; ++body) {
+        glm::vec3 shift = basis * clumps.wallPush[body];
+        clumps.wallPush[body] = shift;
+        clumps.positionX[body] += shift.x;
+        clumps.positionY[body] += shift.y;
+        clumps.positionZ[body] += shift.z;
+    }
+    for (size_t m = 0; m < clumps.memberCount; ++m) {
+        const glm::vec3& shift = clumps.wallPush[clumps.owner[m]];
+        clumps.worldX[m] += shift.x;
+        clumps.worldY[m] += shift.y;
+        clumps.worldZ[m] += shift.z;
+    }
+}
+
+glm::vec3 clumpPosition(const ClumpSystem& clumps, size_t body) {
+    return glm::vec3(clumps.positionX[body], clumps.positionY[body], clumps.positionZ[body]);
+}
+
+glm::vec3 clumpVelocity(const ClumpSystem& clumps, size_t body) {
+    return glm::vec3(clumps.velocityX[body], clumps.velocityY[body], clumps.velocityZ[body]);
+}
+
+glm::vec3 clumpMemberPosition(const ClumpSystem& clumps, size_t member) {
+    return glm::vec3(clumps.worldX[member], clumps.worldY[member], clumps.worldZ[member]);
+}
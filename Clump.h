@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Container.h"
+#include "Material.h"
+#include "Rotation.h"
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <vector>
+
+
+// Gvdeyi oluturan krelerden biri; offset, gvdenin ktle merkezine gre gvde erevesinde
+struct ClumpMember {
+    glm::vec3 offset;
+    float radius;
+};
+
+// Birbirine kaynam krelerden oluan kat gvdeler. Gvde durumu gvde indeksine, ye verisi
+// ye indeksine gre ayr dizilerde (SoA) tutulur; yeler yalnzca sahip gvdenin durumunu okur.
+struct ClumpSystem {
+    size_t count = 0;
+    std::vector<float> positionX, positionY, positionZ; // Ktle merkezi
+    std::vector<float> velocityX, velocityY, velocityZ;
+    RotationState rotation;                             // Ynelim ve dnya erevesinde asal hz
+    std::vector<float> inverseMass;
+    std::vector<glm::mat3> bodyInverseInertia;          // Gvde erevesinde
+    std::vector<float> inverseInertia[9];               // Dnya erevesinde, satr dzeninde; her adm gncellenir
+    std::vector<int> material;
+    std::vector<glm::vec3> color;
+
+    // ye dizileri SIMD_WIDTH katna tamamlanr; dolgu yeleri 0. gvdeye ait ve sfr yarapldr
+    size_t memberCount = 0;
+    std::vector<int> owner;
+    std::vector<float> offsetX, offsetY, offsetZ, memberRadius;
+    std::vector<float> worldX, worldY, worldZ;
+
+    std::vector<glm::vec3> wallPush; // Duvar geiinin gvde bana konum dzeltmesi (ara tampon)
+};
+
+// ye konumlar ktle merkezine gre yeniden hesaplanr ve gvde position'a yerletirilir.
+// Eylemsizlik tensr yelerin kat kre tensrlerinin paralel eksen toplamdr (rtmeler ihmal edilir).
+// Gvde numarasn dndrr; ye listesi bosa ya da toplam ktle sfrsa gvde eklenmez ve -1 dner.
+int addClump(ClumpSystem& clumps, const std::vector<ClumpMember>& members, const glm::vec3& position,
+    const glm::vec3& velocity, int material, const glm::vec3& color);
+
+// Ktle merkezlerini ve ynelimleri ilerletir; dorusal hz nce damping ile leklenip impulse
+// (d alanlarn bu admdaki hz katks) kadar artar, asal hz temaslar arasnda sabit tutulur
+void integrateClumps(ClumpSystem& clumps, float deltaTime, const glm::vec3& impulse = glm::vec3(0.0f), float damping = 1.0f);
+
+// Dnya erevesindeki ters eylemsizlik tensrlerini ve tek SIMD geiinde ye dnya konumlarn retir
+void updateClumpMembers(ClumpSystem& clumps);
+
+// point noktasna (dnya) uygulanan itme hem teleme hem asal momentuma eklenir
+void applyClumpImpulse(ClumpSystem& clumps, size_t body, const glm::vec3& point, const glm::vec3& impulse);
+
+// yelerin kp duvarlaryla temas; itmeler gvdeye aktarlr, duvara giren gvde ieri itilir
+void checkClumpWallCollisions(ClumpSystem& clumps, float cubeSize, const Container& container, const MaterialTable& materials, int wallMaterial);
+
+glm::vec3 clumpPosition(const ClumpSystem& clumps, size_t body);
+glm::vec3 clumpVelocity(const ClumpSystem& clumps, size_t body);
+glm::vec3 clumpMemberPosition(const ClumpSystem& clumps, size_t member);
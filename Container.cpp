@@ -0,0 +1,210 @@
+#include "Container.h"
+#include "Parallel.h"
+#include "Simd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <glm/gtc/matrix_transform.hpp>
+
+
+namespace {
+
+// Sphere dizisini dz float dizisi olarak okuyan SIMD toplamalar iin alan konumlar
+const int kSphereStride = sizeof(Sphere) / sizeof(float);
+const int kPositionX = offsetof(Sphere, position) / sizeof(float);
+const int kRadius = offsetof(Sphere, radius) / sizeof(float);
+const int kVelocityX = offsetof(Sphere, velocity) / sizeof(float);
+const int kMaterial = offsetof(Sphere, material) / sizeof(int);
+
+// ereve dizilerini SIMD_WIDTH katna boyutlar ve temas listelerini boaltr; dolgulu boyu dndrr
+size_t prepareFrame(ContainerFrame& frame, size_t count) {
+    const size_t padded = (count + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH;
+    for (std::vector<float>* array : { &frame.positionX, &frame.positionY, &frame.positionZ,
+                                       &frame.velocityX, &frame.velocityY, &frame.velocityZ, &frame.radius,
+                                       &frame.impactX, &frame.impactY, &frame.impactZ }) {
+        array->resize(padded);
+    }
+    frame.contacts.clear();
+    frame.threadContacts.resize(parallelThreadCount());
+    for (std::vector<int>& contacts : frame.threadContacts) {
+        contacts.clear();
+    }
+    return padded;
+}
+
+// Statik bltrme sayesinde i parac sras kre srasdr
+void gatherFrameContacts(ContainerFrame& frame) {
+    for (const std::vector<int>& contacts : frame.threadContacts) {
+        frame.contacts.insert(frame.contacts.end(), contacts.begin(), contacts.end());
+    }
+}
+
+} // namespace
+
+
+void advanceContainer(Container& container, float deltaTime) {
+    container.position += container.velocity * deltaTime;
+    float angle = glm::length(container.angularVelocity) * deltaTime;
+    if (angle > 0.0f) {
+        glm::vec3 axis = glm::normalize(container.angularVelocity);
+        container.orientation = glm::normalize(glm::angleAxis(angle, axis) * container.orientation);
+    }
+}
+
+glm::mat4 containerTransform(const Container& container, float cubeSize) {
+    glm::mat4 model = glm::translate(glm::mat4(1.0f), container.position) * glm::mat4_cast(container.orientation);
+    return glm::scale(model, glm::vec3(cubeSize));
+}
+
+glm::vec3 containerPointVelocity(const Container& container, const glm::vec3& point) {
+    return container.velocity + glm::cross(container.angularVelocity, point - container.position);
+}
+
+void transformToContainerFrame(const std::vector<Sphere>& spheres, const Container& container, float halfCubeSize,
+    ContainerFrame& frame) {
+    const size_t count = spheres.size();
+    const size_t padded = prepareFrame(frame, count);
+    if (count == 0) return;
+
+    // Dnyadan kap erevesine: R^T (x - c). Satrlar R'nin stunlardr.
+    const glm::mat3 basis = glm::mat3_cast(container.orientation);
+    SimdFloat row[3][3];
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            row[i][j] = simdSet(basis[i][j]);
+        }
+    }
+    const SimdFloat centerX = simdSet(container.position.x), centerY = simdSet(container.position.y), centerZ = simdSet(container.position.z);
+    const SimdFloat wallX = simdSet(container.velocity.x), wallY = simdSet(container.velocity.y), wallZ = simdSet(container.velocity.z);
+    const SimdFloat spinX = simdSet(container.angularVelocity.x), spinY = simdSet(container.angularVelocity.y), spinZ = simdSet(container.angularVelocity.z);
+    const SimdFloat half = simdSet(halfCubeSize);
+    const float* base = &spheres[0].position.x;
+
+    parallelFor(padded / SIMD_WIDTH, [&](size_t begin, size_t end, int thread) {
+        std::vector<int>& contacts = frame.threadContacts[thread];
+        alignas(32) int index[SIMD_WIDTH];
+        for (size_t block = begin; block < end; ++block) {
+            const size_t first = block * SIMD_WIDTH;
+
+            // Son bloun taan eritleri son kreyi okur; temas listesine girmezler
+            for (int lane = 0; lane < SIMD_WIDTH; ++lane) {
+                index[lane] = static_cast<int>(std::min(first + lane, count - 1));
+            }
+            SimdInt offset = simdLoadInt(index) * simdSetInt(kSphereStride);
+            SimdFloat dx = simdGather(base, offset + simdSetInt(kPositionX)) - centerX;
+            SimdFloat dy = simdGather(base, offset + simdSetInt(kPositionX + 1)) - centerY;
+            SimdFloat dz = simdGather(base, offset + simdSetInt(kPositionX + 2)) - centerZ;
+            SimdFloat radius = simdGather(base, offset + simdSetInt(kRadius));
+
+            // Duvarn kre merkezindeki hz karlr: v - (v_c + w x d)
+            SimdFloat vx = simdGather(base, offset + simdSetInt(kVelocityX)) - wallX - (spinY * dz - spinZ * dy);
+            SimdFloat vy = simdGather(base, offset + simdSetInt(kVelocityX + 1)) - wallY - (spinZ * dx - spinX * dz);
+            SimdFloat vz = simdGather(base, offset + simdSetInt(kVelocityX + 2)) - wallZ - (spinX * dy - spinY * dx);
+
+            SimdFloat x = simdDot(row[0][0], row[0][1], row[0][2], dx, dy, dz);
+            SimdFloat y = simdDot(row[1][0], row[1][1], row[1][2], dx, dy, dz);
+            SimdFloat z = simdDot(row[2][0], row[2][1], row[2][2], dx, dy, dz);
+            simdStore(&frame.positionX[first], x);
+            simdStore(&frame.positionY[first], y);
+            simdStore(&frame.positionZ[first], z);
+            simdStore(&frame.radius[first], radius);
+            simdStore(&frame.velocityX[first], simdDot(row[0][0], row[0][1], row[0][2], vx, vy, vz));
+            simdStore(&frame.velocityY[first], simdDot(row[1][0], row[1][1], row[1][2], vx, vy, vz));
+            simdStore(&frame.velocityZ[first], simdDot(row[2][0], row[2][1], row[2][2], vx, vy, vz));
+
+            SimdFloat reach = simdMax(simdMax(simdAbs(x), simdAbs(y)), simdAbs(z)) + radius;
+            int mask = simdMoveMask(simdGreater(reach, half));
+            if (mask == 0) continue;
+            for (int lane = 0; lane < SIMD_WIDTH; ++lane) {
+                if ((mask & (1 << lane)) && first + lane < count) contacts.push_back(static_cast<int>(first + lane));
+            }
+        }
+    }, 512);
+
+    gatherFrameContacts(frame);
+}
+
+void transformToBatchFrames(const std::vector<Sphere>& spheres, const ContainerBatch& batch, ContainerFrame& frame) {
+    const size_t count = spheres.size();
+    const size_t padded = prepareFrame(frame, count);
+    if (count == 0) return;
+
+    const SimdFloat half = simdSet(batch.halfSize);
+    const float* base = &spheres[0].position.x;
+    const float* origins = &batch.origins[0].x;
+    const int* owner = batch.sphereContainer.data();
+
+    parallelFor(padded / SIMD_WIDTH, [&](size_t begin, size_t end, int thread) {
+        std::vector<int>& contacts = frame.threadContacts[thread];
+        alignas(32) int index[SIMD_WIDTH];
+        for (size_t block = begin; block < end; ++block) {
+            const size_t first = block * SIMD_WIDTH;
+            for (int lane = 0; lane < SIMD_WIDTH; ++lane) {
+                index[lane] = static_cast<int>(std::min(first + lane, count - 1));
+            }
+            SimdInt sphere = simdLoadInt(index);
+            SimdInt offset = sphere * simdSetInt(kSphereStride);
+            SimdInt box = simdGatherInt(owner, sphere) * simdSetInt(3);
+
+            SimdFloat x = simdGather(base, offset + simdSetInt(kPositionX)) - simdGather(origins, box);
+            SimdFloat y = simdGather(base, offset + simdSetInt(kPositionX + 1)) - simdGather(origins, box + simdSetInt(1));
+            SimdFloat z = simdGather(base, offset + simdSetInt(kPositionX + 2)) - simdGather(origins, box + simdSetInt(2));
+            SimdFloat radius = simdGather(base, offset + simdSetInt(kRadius));
+            simdStore(&frame.positionX[first], x);
+            simdStore(&frame.positionY[first], y);
+            simdStore(&frame.positionZ[first], z);
+            simdStore(&frame.radius[first], radius);
+            simdStore(&frame.velocityX[first], simdGather(base, offset + simdSetInt(kVelocityX)));
+            simdStore(&frame.velocityY[first], simdGather(base, offset + simdSetInt(kVelocityX + 1)));
+            simdStore(&frame.velocityZ[first], simdGather(base, offset + simdSetInt(kVelocityX + 2)));
+
+            SimdFloat reach = simdMax(simdMax(simdAbs(x), simdAbs(y)), simdAbs(z)) + radius;
+            int mask = simdMoveMask(simdGreater(reach, half));
+            if (mask == 0) continue;
+            for (int lane = 0; lane < SIMD_WIDTH; ++lane) {
+                if ((mask & (1 << lane)) && first + lane < count) contacts.push_back(static_cast<int>(first + lane));
+            }
+        }
+    }, 512);
+
+    gatherFrameContacts(frame);
+}
+
+void bounceOffBoxWalls(const std::vector<Sphere>& spheres, const float* wallRestitution, float halfCubeSize,
+    ContainerFrame& frame) {
+    const size_t count = spheres.size();
+    if (count == 0) return;
+    const size_t padded = (count + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH;
+    const int* base = reinterpret_cast<const int*>(&spheres[0]);
+    const SimdFloat half = simdSet(halfCubeSize);
+    const SimdFloat zero = simdSet(0.0f);
+
+    parallelFor(padded / SIMD_WIDTH, [&](size_t begin, size_t end, int) {
+        alignas(32) int index[SIMD_WIDTH];
+        for (size_t block = begin; block < end; ++block) {
+            const size_t first = block * SIMD_WIDTH;
+            for (int lane = 0; lane < SIMD_WIDTH; ++lane) {
+                index[lane] = static_cast<int>(std::min(first + lane, count - 1));
+            }
+            SimdInt material = simdGatherInt(base, simdLoadInt(index) * simdSetInt(kSphereStride) + simdSetInt(kMaterial));
+            SimdFloat restitution = simdGather(wallRestitution, material);
+            SimdFloat limit = half - simdLoad(&frame.radius[first]);
+            SimdFloat lower = zero - limit;
+
+            float* positions[3] = { &frame.positionX[first], &frame.positionY[first], &frame.positionZ[first] };
+            float* velocities[3] = { &frame.velocityX[first], &frame.velocityY[first], &frame.velocityZ[first] };
+            float* impacts[3] = { &frame.impactX[first], &frame.impactY[first], &frame.impactZ[first] };
+            for (int axis = 0; axis < 3; ++axis) {
+                SimdFloat x = simdLoad(positions[axis]);
+                SimdFloat v = simdLoad(velocities[axis]);
+                // Duvarn dna taan ve ondan uzaklamayan eritler yansr; ie dnm kre yapmaz
+                SimdFloat outward = simdOr(simdAnd(simdGreater(x, limit), simdGreater(v, zero)),
+                                           simdAnd(simdLess(x, lower), simdLess(v, zero)));
+                simdStore(velocities[axis], simdSelect(outward, zero - restitution * v, v));
+                simdStore(impacts[axis], simdSelect(outward, v, zero));
+                simdStore(positions[axis], simdClamp(x, lower, limit));
+            }
+        }
+    }, 512);
+}
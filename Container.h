@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Sphere.h"
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <vector>
+
+
+// Kbik kabn kat dnm. Kinematiktir: hzlar dardan verilir, arpmalar kab etkilemez.
+// Kenar uzunluu updateSimulation'a verilen cubeSize'dr; merkez position, eksenler orientation'dr.
+struct Container {
+    glm::vec3 position = glm::vec3(0.0f);
+    glm::quat orientation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    glm::vec3 velocity = glm::vec3(0.0f);
+    glm::vec3 angularVelocity = glm::vec3(0.0f); // Dnya erevesinde, rad/s
+};
+
+// Yan yana duran, birbirinden bamsz sabit kutular (r. her parametre kmesi iin bir kutu). Tm
+// kutular ayn boydadr ve eksenlere hizaldr; her kre sphereContainer ile bir kutuya aittir.
+// Kutular tek bir dnyada birlikte admlanr, iftler yalnzca ayn kutudaki kreler arasnda kurulur.
+struct ContainerBatch {
+    float halfSize = 0.5f;
+    std::vector<glm::vec3> origins;   // Kutu merkezleri (dnya koordinatlarnda)
+    std::vector<int> sphereContainer; // Kre bana kutu numaras
+};
+
+// Krelerin kap erevesindeki durumu (SoA, SIMD_WIDTH katna tamamlanm). Hzlar, duvarn kre
+// merkezindeki hzna grelidir; duvar hareketi bylece sekme tepkisine dorudan girer.
+struct ContainerFrame {
+    std::vector<float> positionX, positionY, positionZ;
+    std::vector<float> velocityX, velocityY, velocityZ;
+    std::vector<float> radius;
+    // bounceOffBoxWalls'n yanstt eksenlerde arpma ncesi hz (da doru, iaretli); dierlerinde 0
+    std::vector<float> impactX, impactY, impactZ;
+    std::vector<int> contacts; // En az bir duvarla rten kreler, artan srada
+    std::vector<std::vector<int>> threadContacts;
+};
+
+// Kab deltaTime kadar ilerletir; dnme tam ayla uygulanr
+void advanceContainer(Container& container, float deltaTime);
+
+// Birim kp an (-0.5..0.5) kabn dnya konumuna tayan model matrisi
+glm::mat4 containerTransform(const Container& container, float cubeSize);
+
+// Kaba bal bir noktann dnya erevesindeki hz: v + w x (p - c)
+glm::vec3 containerPointVelocity(const Container& container, const glm::vec3& point);
+
+// Tm kreleri tek bir SIMD geiinde kap erevesine tar ve duvarla rtenleri frame.contacts'a yazar
+void transformToContainerFrame(const std::vector<Sphere>& spheres, const Container& container, float halfCubeSize,
+    ContainerFrame& frame);
+
+// Kutu duvarlarna normal tepki, erevedeki tm kreler iin 8'erli eritlerle ve dalsz: hz yalnzca
+// kre duvara doru gidiyorsa sekme katsaysyla yanstlr, konum duvarlarn iine kstrlr.
+// wallRestitution duvar malzemesinin satrdr (kre malzemesiyle indekslenir). Srtnme ve dnme
+// temas bana ayrca uygulanr; arpma hzlar bunun iin frame.impact* dizilerine yazlr.
+void bounceOffBoxWalls(const std::vector<Sphere>& spheres, const float* wallRestitution, float halfCubeSize,
+    ContainerFrame& frame);
+
+// Kutu dnyas iin transformToContainerFrame: her kre kendi kutusunun merkezine gre yazlr
+// (kutular dnmez ve duraandr, hzlar olduu gibi kalr)
+void transformToBatchFrames(const std::vector<Sphere>& spheres, const ContainerBatch& batch, ContainerFrame& frame);
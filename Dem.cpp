@@ -0,0 +1,431 @@
+#include "Dem.h"
+#include "Parallel.h"
+#include "Simd.h"
+#include "Simulation.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace {
+
+// -2 sqrt(5/6): snm oran beta ile arplarak yay-snmleyici katsays elde edilir
+const float kDampingFactor = -1.8257419f;
+
+void resizeDemState(DemState& dem, size_t count) {
+    size_t padded = (count + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH;
+    for (std::vector<float>* array : { &dem.positionX, &dem.positionY, &dem.positionZ, &dem.radius,
+             &dem.velocityX, &dem.velocityY, &dem.velocityZ, &dem.forceX, &dem.forceY, &dem.forceZ,
+             &dem.torqueX, &dem.torqueY, &dem.torqueZ, &dem.inverseMass, &dem.inverseInertia }) {
+        array->assign(padded, 0.0f);
+    }
+    dem.material.assign(padded, 0);
+
+    // Kre says deiince indeksler geersizleir, gemi sfrdan balar
+    dem.previousStart.assign(count + 1, 0);
+    dem.previousPartner.clear();
+    dem.previousHistoryX.clear();
+    dem.previousHistoryY.clear();
+    dem.previousHistoryZ.clear();
+    dem.wallHistoryX.assign(3 * count, 0.0f);
+    dem.wallHistoryY.assign(3 * count, 0.0f);
+    dem.wallHistoryZ.assign(3 * count, 0.0f);
+    dem.count = count;
+}
+
+void loadDemState(DemState& dem, const std::vector<Sphere>& spheres) {
+    parallelFor(spheres.size(), [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; ++i) {
+            const Sphere& sphere = spheres[i];
+            float mass = sphereMass(sphere.radius);
+            dem.positionX[i] = sphere.position.x;
+            dem.positionY[i] = sphere.position.y;
+            dem.positionZ[i] = sphere.position.z;
+            dem.radius[i] = sphere.radius;
+            dem.velocityX[i] = sphere.velocity.x;
+            dem.velocityY[i] = sphere.velocity.y;
+            dem.velocityZ[i] = sphere.velocity.z;
+            dem.inverseMass[i] = 1.0f / mass;
+            dem.inverseInertia[i] = 1.0f / (SPHERE_INERTIA_FACTOR * mass * sphere.radius * sphere.radius);
+            dem.material[i] = sphere.material;
+        }
+    });
+}
+
+void storeDemState(const DemState& dem, std::vector<Sphere>& spheres) {
+    parallelFor(spheres.size(), [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; ++i) {
+            spheres[i].position = glm::vec3(dem.positionX[i], dem.positionY[i], dem.positionZ[i]);
+            spheres[i].velocity = glm::vec3(dem.velocityX[i], dem.velocityY[i], dem.velocityZ[i]);
+        }
+    });
+}
+
+// Her kre iin 27 komu hcredeki rten krelerin listesi. Liste kre i'nin satrna yazlacandan
+// (CSR) nce i parac bana toplanr; nceki nbellekteki gemi burada aranp tanr.
+void findDemContacts(DemState& dem, const SpatialGrid& grid) {
+    const int count = static_cast<int>(dem.count);
+    const int threads = parallelThreadCount();
+    dem.threadPartners.resize(threads);
+    dem.threadHistory.resize(threads);
+    dem.threadBegin.assign(threads, 0);
+    // Kk ilerde paralar i parac saysndan az olabilir; kullanlmayan listeler bo kalmal
+    for (int t = 0; t < threads; ++t) {
+        dem.threadPartners[t].clear();
+        dem.threadHistory[t].clear();
+    }
+    dem.contactStart.assign(count + 1, 0);
+
+    parallelFor(count, [&](size_t begin, size_t end, int thread) {
+        std::vector<int>& partners = dem.threadPartners[thread];
+        std::vector<float>& history = dem.threadHistory[thread];
+        dem.threadBegin[thread] = begin;
+
+        for (size_t i = begin; i < end; ++i) {
+            int cell = grid.sphereCell[i];
+            int cx = cell % grid.dims.x;
+            int cy = (cell / grid.dims.x) % grid.dims.y;
+            int cz = cell / (grid.dims.x * grid.dims.y);
+            float xi = dem.positionX[i], yi = dem.positionY[i], zi = dem.positionZ[i], ri = dem.radius[i];
+            int previousBegin = dem.previousStart[i];
+            int previousEnd = dem.previousStart[i + 1];
+            size_t before = partners.size();
+
+            for (int z = std::max(cz - 1, 0); z <= std::min(cz + 1, grid.dims.z - 1); ++z) {
+                for (int y = std::max(cy - 1, 0); y <= std::min(cy + 1, grid.dims.y - 1); ++y) {
+                    for (int x = std::max(cx - 1, 0); x <= std::min(cx + 1, grid.dims.x - 1); ++x) {
+                        int neighbour = (z * grid.dims.y + y) * grid.dims.x + x;
+                        for (int e = grid.cellStart[neighbour]; e < grid.cellStart[neighbour + 1]; ++e) {
+                            int j = grid.cellEntries[e];
+                            float dx = dem.positionX[j] - xi;
+                            float dy = dem.positionY[j] - yi;
+                            float dz = dem.positionZ[j] - zi;
+                            float reach = ri + dem.radius[j];
+                            if (j == static_cast<int>(i) || dx * dx + dy * dy + dz * dz >= reach * reach) continue;
+
+                            partners.push_back(j);
+                            float hx = 0.0f, hy = 0.0f, hz = 0.0f;
+                            for (int c = previousBegin; c < previousEnd; ++c) {
+                                if (dem.previousPartner[c] == j) {
+                                    hx = dem.previousHistoryX[c];
+                                    hy = dem.previousHistoryY[c];
+                                    hz = dem.previousHistoryZ[c];
+                                    break;
+                                }
+                            }
+                            history.push_back(hx);
+                            history.push_back(hy);
+                            history.push_back(hz);
+                        }
+                    }
+                }
+            }
+            dem.contactStart[i + 1] = static_cast<int>(partners.size() - before);
+        }
+    }, 256);
+
+    for (int i = 0; i < count; ++i) {
+        dem.contactStart[i + 1] += dem.contactStart[i];
+    }
+
+    // Diziler SIMD_WIDTH kadar fazladan tamamlanr; son krenin ykleri de dizi iinde kalr
+    size_t total = dem.contactStart[count];
+    dem.contactPartner.assign(total + SIMD_WIDTH, 0);
+    dem.historyX.assign(total + SIMD_WIDTH, 0.0f);
+    dem.historyY.assign(total + SIMD_WIDTH, 0.0f);
+    dem.historyZ.assign(total + SIMD_WIDTH, 0.0f);
+    parallelFor(threads, [&](size_t begin, size_t end, int) {
+        for (size_t t = begin; t < end; ++t) {
+            const std::vector<int>& partners = dem.threadPartners[t];
+            const std::vector<float>& history = dem.threadHistory[t];
+            size_t offset = dem.contactStart[dem.threadBegin[t]];
+            for (size_t c = 0; c < partners.size(); ++c) {
+                dem.contactPartner[offset + c] = partners[c];
+                dem.historyX[offset + c] = history[3 * c];
+                dem.historyY[offset + c] = history[3 * c + 1];
+                dem.historyZ[offset + c] = history[3 * c + 2];
+            }
+        }
+    }, 1);
+}
+
+// HertzMindlin temas kuvveti; n i'den kar cisme, v i'nin temas noktasnn kar cisme gre hz.
+// Skaler srm duvarlar iin; ift ekirdei ayn admlar eritler zerinde yapar.
+glm::vec3 hertzMindlinWallForce(float overlap, const glm::vec3& normal, const glm::vec3& velocity, float radius, float mass,
+    int pairIndex, const MaterialTable& materials, float deltaTime, glm::vec3& history, glm::vec3& torque) {
+    float root = std::sqrt(radius * overlap);
+    float normalStiffness = 2.0f * materials.effectiveYoung[pairIndex] * root;
+    float tangentStiffness = 8.0f * materials.effectiveShear[pairIndex] * root;
+    float damping = kDampingFactor * materials.dampingRatio[pairIndex];
+
+    float normalSpeed = glm::dot(velocity, normal);
+    float normalForce = std::max(2.0f / 3.0f * normalStiffness * overlap + damping * std::sqrt(normalStiffness * mass) * normalSpeed, 0.0f);
+
+    glm::vec3 tangentVelocity = velocity - normal * normalSpeed;
+    history = history - normal * glm::dot(history, normal) + tangentVelocity * deltaTime;
+    float tangentDamping = damping * std::sqrt(tangentStiffness * mass);
+    glm::vec3 tangentForce = -tangentStiffness * history - tangentDamping * tangentVelocity;
+    float limit = materials.friction[pairIndex] * normalForce;
+    float magnitude = glm::length(tangentForce);
+    if (magnitude > limit) {
+        // Kayma: kuvvet Coulomb snrna indirilir, yay uzamas da buna uydurulur
+        tangentForce *= limit / magnitude;
+        history = -(tangentForce + tangentDamping * tangentVelocity) / tangentStiffness;
+    }
+
+    torque = glm::cross(normal * radius, tangentForce);
+    return -normal * normalForce + tangentForce;
+}
+
+// Kre bana: temaslar 8'erli eritlerde hesaplanr ve yatay toplanr, ardndan duvarlar eklenir.
+// Her kre yalnzca kendi satrn yazd iin i paracklar arasnda yar ve birletirme tamponu
+// yoktur; ift kuvveti iki ynde de hesaplanr ve gemiler ters iaretli olduundan Newton'un 3. yasas korunur.
+void computeDemForces(DemState& dem, const RotationState& rotation, const MaterialTable& materials, int wallMaterial,
+    float halfCubeSize, float deltaTime) {
+    parallelFor(dem.count, [&](size_t begin, size_t end, int) {
+        const SimdInt materialRow = simdSetInt(MAX_MATERIALS);
+        const SimdFloat zero = simdSet(0.0f);
+        const SimdFloat one = simdSet(1.0f);
+        const SimdFloat tiny = simdSet(1e-20f);
+        const SimdFloat dampingFactor = simdSet(kDampingFactor);
+        const SimdFloat twoThirds = simdSet(2.0f / 3.0f);
+        const SimdFloat step = simdSet(deltaTime);
+        alignas(32) float sums[6][SIMD_WIDTH];
+        alignas(32) float updated[3][SIMD_WIDTH];
+
+        for (size_t i = begin; i < end; ++i) {
+            SimdFloat xi = simdSet(dem.positionX[i]), yi = simdSet(dem.positionY[i]), zi = simdSet(dem.positionZ[i]);
+            SimdFloat ri = simdSet(dem.radius[i]);
+            SimdFloat vxi = simdSet(dem.velocityX[i]), vyi = simdSet(dem.velocityY[i]), vzi = simdSet(dem.velocityZ[i]);
+            SimdFloat wxi = simdSet(rotation.angularX[i]), wyi = simdSet(rotation.angularY[i]), wzi = simdSet(rotation.angularZ[i]);
+            SimdFloat inverseMassI = simdSet(dem.inverseMass[i]);
+            SimdInt rowI = simdSetInt(dem.material[i]) * materialRow;
+
+            SimdFloat fx = zero, fy = zero, fz = zero, tx = zero, ty = zero, tz = zero;
+            int contactBegin = dem.contactStart[i];
+            int contactEnd = dem.contactStart[i + 1];
+            for (int c = contactBegin; c < contactEnd; c += SIMD_WIDTH) {
+                SimdFloat valid = simdLess(simdLaneIndex(), simdSet(static_cast<float>(contactEnd - c)));
+                SimdInt j = simdLoadInt(&dem.contactPartner[c]);
+
+                SimdFloat nx = simdGather(dem.positionX.data(), j) - xi;
+                SimdFloat ny = simdGather(dem.positionY.data(), j) - yi;
+                SimdFloat nz = simdGather(dem.positionZ.data(), j) - zi;
+                SimdFloat rj = simdGather(dem.radius.data(), j);
+                SimdFloat distance = simdSqrt(simdMax(simdDot(nx, ny, nz, nx, ny, nz), tiny));
+                SimdFloat overlap = ri + rj - distance;
+                SimdFloat active = simdAnd(valid, simdGreater(overlap, zero));
+                overlap = simdMax(overlap, zero);
+                SimdFloat inverseDistance = one / distance;
+                nx = nx * inverseDistance;
+                ny = ny * inverseDistance;
+                nz = nz * inverseDistance;
+
+                // Temas noktasnda i'nin j'ye gre hz: vi - vj + (ri wi + rj wj) x n
+                SimdFloat sx = ri * wxi + rj * simdGather(rotation.angularX.data(), j);
+                SimdFloat sy = ri * wyi + rj * simdGather(rotation.angularY.data(), j);
+                SimdFloat sz = ri * wzi + rj * simdGather(rotation.angularZ.data(), j);
+                SimdFloat ux = vxi - simdGather(dem.velocityX.data(), j) + (sy * nz - sz * ny);
+                SimdFloat uy = vyi - simdGather(dem.velocityY.data(), j) + (sz * nx - sx * nz);
+                SimdFloat uz = vzi - simdGather(dem.velocityZ.data(), j) + (sx * ny - sy * nx);
+
+                // Etkin yarap ve ktle, malzeme iftinden E*, G*, snm ve srtnme
+                SimdFloat effectiveRadius = ri * rj / simdMax(ri + rj, tiny);
+                SimdFloat effectiveMass = one / (inverseMassI + simdGather(dem.inverseMass.data(), j));
+                SimdInt pairIndex = rowI + simdGatherInt(dem.material.data(), j);
+                SimdFloat root = simdSqrt(effectiveRadius * overlap);
+                SimdFloat normalStiffness = simdSet(2.0f) * simdGather(materials.effectiveYoung, pairIndex) * root;
+                SimdFloat tangentStiffness = simdSet(8.0f) * simdGather(materials.effectiveShear, pairIndex) * root;
+                SimdFloat damping = dampingFactor * simdGather(materials.dampingRatio, pairIndex);
+
+                // Hertz normal kuvveti (4/3) E* sqrt(R*) d^(3/2) ve snm; ekme kuvveti olumaz
+                SimdFloat normalSpeed = simdDot(ux, uy, uz, nx, ny, nz);
+                SimdFloat normalForce = simdMax(twoThirds * normalStiffness * overlap
+                    + damping * simdSqrt(normalStiffness * effectiveMass) * normalSpeed, zero);
+
+                // Mindlin: gemi yeni teet dzlemine izdrlr ve teet kayma kadar uzar
+                SimdFloat gx = ux - normalSpeed * nx;
+                SimdFloat gy = uy - normalSpeed * ny;
+                SimdFloat gz = uz - normalSpeed * nz;
+                SimdFloat hx = simdLoad(&dem.historyX[c]);
+                SimdFloat hy = simdLoad(&dem.historyY[c]);
+                SimdFloat hz = simdLoad(&dem.historyZ[c]);
+                SimdFloat along = simdDot(hx, hy, hz, nx, ny, nz);
+                hx = hx - along * nx + gx * step;
+                hy = hy - along * ny + gy * step;
+                hz = hz - along * nz + gz * step;
+
+                SimdFloat tangentDamping = damping * simdSqrt(tangentStiffness * effectiveMass);
+                SimdFloat ftx = zero - tangentStiffness * hx - tangentDamping * gx;
+                SimdFloat fty = zero - tangentStiffness * hy - tangentDamping * gy;
+                SimdFloat ftz = zero - tangentStiffness * hz - tangentDamping * gz;
+                SimdFloat tangentForce = simdSqrt(simdDot(ftx, fty, ftz, ftx, fty, ftz));
+                SimdFloat limit = simdGather(materials.friction, pairIndex) * normalForce;
+
+                // Kayma: kuvvet Coulomb snrna indirilir, yay uzamas da buna uydurulur
+                SimdFloat sliding = simdGreater(tangentForce, limit);
+                SimdFloat scale = simdSelect(sliding, limit / simdMax(tangentForce, tiny), one);
+                ftx = ftx * scale;
+                fty = fty * scale;
+                ftz = ftz * scale;
+                SimdFloat inverseStiffness = one / simdMax(tangentStiffness, tiny);
+                hx = simdSelect(sliding, zero - (ftx + tangentDamping * gx) * inverseStiffness, hx);
+                hy = simdSelect(sliding, zero - (fty + tangentDamping * gy) * inverseStiffness, hy);
+                hz = simdSelect(sliding, zero - (ftz + tangentDamping * gz) * inverseStiffness, hz);
+
+                fx = fx + simdSelect(active, ftx - normalForce * nx, zero);
+                fy = fy + simdSelect(active, fty - normalForce * ny, zero);
+                fz = fz + simdSelect(active, ftz - normalForce * nz, zero);
+                // Tork: (ri n) x Ft
+                tx = tx + simdSelect(active, ri * (ny * ftz - nz * fty), zero);
+                ty = ty + simdSelect(active, ri * (nz * ftx - nx * ftz), zero);
+                tz = tz + simdSelect(active, ri * (nx * fty - ny * ftx), zero);
+
+                // Gemi yalnzca bu krenin satrna yazlr; komu satrlara taan eritler atlanr
+                simdStore(updated[0], simdSelect(active, hx, zero));
+                simdStore(updated[1], simdSelect(active, hy, zero));
+                simdStore(updated[2], simdSelect(active, hz, zero));
+                for (int lane = 0; lane < SIMD_WIDTH && c + lane < contactEnd; ++lane) {
+                    dem.historyX[c + lane] = updated[0][lane];
+                    dem.historyY[c + lane] = updated[1][lane];
+                    dem.historyZ[c + lane] = updated[2][lane];
+                }
+            }
+
+            simdStore(sums[0], fx);
+            simdStore(sums[1], fy);
+            simdStore(sums[2], fz);
+            simdStore(sums[3], tx);
+            simdStore(sums[4], ty);
+            simdStore(sums[5], tz);
+            glm::vec3 force(0.0f), torque(0.0f);
+            for (int lane = 0; lane < SIMD_WIDTH; ++lane) {
+                force += glm::vec3(sums[0][lane], sums[1][lane], sums[2][lane]);
+                torque += glm::vec3(sums[3][lane], sums[4][lane], sums[5][lane]);
+            }
+
+            // Kp duvarlar: sonsuz ktleli, dnmeyen kar cisim
+            glm::vec3 position(dem.positionX[i], dem.positionY[i], dem.positionZ[i]);
+            glm::vec3 velocity(dem.velocityX[i], dem.velocityY[i], dem.velocityZ[i]);
+            glm::vec3 angular(rotation.angularX[i], rotation.angularY[i], rotation.angularZ[i]);
+            float radius = dem.radius[i];
+            float mass = 1.0f / dem.inverseMass[i];
+            int pairIndex = wallMaterial * MAX_MATERIALS + dem.material[i];
+            for (int axis = 0; axis < 3; ++axis) {
+                size_t slot = 3 * i + axis;
+                glm::vec3 history(dem.wallHistoryX[slot], dem.wallHistoryY[slot], dem.wallHistoryZ[slot]);
+                float overlap = std::max(position[axis] + radius - halfCubeSize, -halfCubeSize - (position[axis] - radius));
+                if (overlap <= 0.0f) {
+                    history = glm::vec3(0.0f);
+                } else {
+                    glm::vec3 normal(0.0f);
+                    normal[axis] = position[axis] > 0.0f ? 1.0f : -1.0f;
+                    glm::vec3 contactVelocity = velocity + glm::cross(angular, normal * radius);
+                    glm::vec3 wallTorque;
+                    force += hertzMindlinWallForce(overlap, normal, contactVelocity, radius, mass, pairIndex, materials,
+                        deltaTime, history, wallTorque);
+                    torque += wallTorque;
+                }
+                dem.wallHistoryX[slot] = history.x;
+                dem.wallHistoryY[slot] = history.y;
+                dem.wallHistoryZ[slot] = history.z;
+            }
+
+            dem.forceX[i] = force.x;
+            dem.forceY[i] = force.y;
+            dem.forceZ[i] = force.z;
+            dem.torqueX[i] = torque.x;
+            dem.torqueY[i] = torque.y;
+            dem.torqueZ[i] = torque.z;
+        }
+    }, 256);
+}
+
+// Yar rtk Euler: nce hzlar kuvvet ve d alanlarla, sonra konumlar yeni hzla ilerler
+void integrateDemState(DemState& dem, RotationState& rotation, const BodyForces& forces, float deltaTime) {
+    const size_t padded = dem.positionX.size();
+    const glm::vec3 impulse = (forces.gravity + forces.acceleration) * deltaTime;
+    const float damping = std::exp(-forces.drag * deltaTime);
+    parallelFor(padded / SIMD_WIDTH, [&](size_t begin, size_t end, int) {
+        const SimdFloat step = simdSet(deltaTime);
+        const SimdFloat scale = simdSet(damping);
+        const SimdFloat zero = simdSet(0.0f);
+        for (size_t block = begin; block < end; ++block) {
+            size_t i = block * SIMD_WIDTH;
+            SimdFloat inverseMass = simdLoad(&dem.inverseMass[i]);
+            SimdFloat linear = step * inverseMass;
+            SimdFloat angular = step * simdLoad(&dem.inverseInertia[i]);
+            // Dolgu krelerinin ters ktlesi sfrdr, d alan onlara uygulanmaz
+            SimdFloat movable = simdGreater(inverseMass, zero);
+
+            SimdFloat vx = simdLoad(&dem.velocityX[i]) * scale + linear * simdLoad(&dem.forceX[i]) + simdSelect(movable, simdSet(impulse.x), zero);
+            SimdFloat vy = simdLoad(&dem.velocityY[i]) * scale + linear * simdLoad(&dem.forceY[i]) + simdSelect(movable, simdSet(impulse.y), zero);
+            SimdFloat vz = simdLoad(&dem.velocityZ[i]) * scale + linear * simdLoad(&dem.forceZ[i]) + simdSelect(movable, simdSet(impulse.z), zero);
+            simdStore(&dem.velocityX[i], vx);
+            simdStore(&dem.velocityY[i], vy);
+            simdStore(&dem.velocityZ[i], vz);
+            simdStore(&dem.positionX[i], simdLoad(&dem.positionX[i]) + step * vx);
+            simdStore(&dem.positionY[i], simdLoad(&dem.positionY[i]) + step * vy);
+            simdStore(&dem.positionZ[i], simdLoad(&dem.positionZ[i]) + step * vz);
+
+            simdStore(&rotation.angularX[i], simdLoad(&rotation.angularX[i]) + angular * simdLoad(&dem.torqueX[i]));
+            simdStore(&rotation.angularY[i], simdLoad(&rotation.angularY[i]) + angular * simdLoad(&dem.torqueY[i]));
+            simdStore(&rotation.angularZ[i], simdLoad(&rotation.angularZ[i]) + angular * simdLoad(&dem.torqueZ[i]));
+        }
+    }, 64);
+    integrateOrientations(rotation, deltaTime);
+}
+
+} // namespace
+
+
+float demRayleighTime(const std::vector<Sphere>& spheres, const MaterialTable& materials) {
+    const float density = 3.0f / (4.0f * 3.14159265f);
+    float shortest = 1e30f;
+    bool used[MAX_MATERIALS] = {};
+    float smallestRadius[MAX_MATERIALS];
+    std::fill(smallestRadius, smallestRadius + MAX_MATERIALS, 1e30f);
+    for (const Sphere& sphere : spheres) {
+        used[sphere.material] = true;
+        smallestRadius[sphere.material] = std::min(smallestRadius[sphere.material], sphere.radius);
+    }
+    for (int m = 0; m < MAX_MATERIALS; ++m) {
+        if (!used[m]) continue;
+        float poisson = materials.poissonRatio[m];
+        float shear = materials.youngModulus[m] / (2.0f * (1.0f + poisson));
+        float time = 3.14159265f * smallestRadius[m] * std::sqrt(density / shear) / (0.1631f * poisson + 0.8766f);
+        shortest = std::min(shortest, time);
+    }
+    return shortest;
+}
+
+void updateDemSimulation(std::vector<Sphere>& spheres, float cubeSize, float deltaTime, SimulationContext& context) {
+    DemState& dem = context.dem;
+    if (dem.count != spheres.size()) {
+        resizeDemState(dem, spheres.size());
+    }
+    resizeRotationState(context.rotation, spheres.size());
+    if (spheres.empty() || deltaTime <= 0.0f) return;
+    loadDemState(dem, spheres);
+
+    float stableStep = dem.settings.rayleighFraction * demRayleighTime(spheres, context.materials);
+    int substeps = std::min(std::max(static_cast<int>(std::ceil(deltaTime / stableStep)), 1), dem.settings.maxSubsteps);
+    float step = deltaTime / substeps;
+    const int count = static_cast<int>(spheres.size());
+
+    for (int s = 0; s < substeps; ++s) {
+        buildSpatialGrid(context.grid, dem.positionX.data(), dem.positionY.data(), dem.positionZ.data(), dem.radius.data(), count);
+        findDemContacts(dem, context.grid);
+        computeDemForces(dem, context.rotation, context.materials, context.wallMaterial, cubeSize / 2.0f, step);
+        integrateDemState(dem, context.rotation, context.bodyForces, step);
+
+        // Bu alt admn nbellei bir sonrakinin gemi kayna olur
+        std::swap(dem.contactStart, dem.previousStart);
+        std::swap(dem.contactPartner, dem.previousPartner);
+        std::swap(dem.historyX, dem.previousHistoryX);
+        std::swap(dem.historyY, dem.previousHistoryY);
+        std::swap(dem.historyZ, dem.previousHistoryZ);
+    }
+
+    storeDemState(dem, spheres);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Sphere.h"
+#include "Material.h"
+#include <vector>
+
+
+struct SimulationContext;
+
+struct DemSettings {
+    float rayleighFraction = 0.2f; // Alt adm, en kk Rayleigh sresinin bu kesri kadar alnr
+    int maxSubsteps = 1000;        // Kare bana alt adm snr; alrsa alt adm byr
+};
+
+// Yumuak kre (DEM) modunun admlar aras durumu. Kreler kare banda SoA dizilere kopyalanr,
+// alt admlar bu diziler zerinde koar ve kare sonunda geri yazlr.
+struct DemState {
+    DemSettings settings;
+
+    size_t count = 0; // Diziler SIMD_WIDTH katna tamamlanr; dolgu krelerinin ktlesi sonsuzdur
+    std::vector<float> positionX, positionY, positionZ, radius;
+    std::vector<float> velocityX, velocityY, velocityZ;
+    std::vector<float> forceX, forceY, forceZ;
+    std::vector<float> torqueX, torqueY, torqueZ;
+    std::vector<float> inverseMass, inverseInertia;
+    std::vector<int> material;
+
+    // Temas nbellei (ynl, CSR): kre i'nin temaslar contactStart[i] .. contactStart[i + 1].
+    // Her temas kar kreyi ve Mindlin teetsel yay uzamasn tutar; bir nceki alt admn
+    // nbellei previous* dizilerinde kalr ve yeni temaslar gemilerini oradan alr.
+    std::vector<int> contactStart, contactPartner;
+    std::vector<float> historyX, historyY, historyZ;
+    std::vector<int> previousStart, previousPartner;
+    std::vector<float> previousHistoryX, previousHistoryY, previousHistoryZ;
+
+    // Duvar temaslarnn gemii, kre ve eksen bana bir tane: [3 * i + eksen]
+    std::vector<float> wallHistoryX, wallHistoryY, wallHistoryZ;
+
+    //  parac bana temas listeleri, CSR'a birletirilmeden nce
+    std::vector<std::vector<int>> threadPartners;
+    std::vector<std::vector<float>> threadHistory;
+    std::vector<size_t> threadBegin;
+};
+
+// En kk Rayleigh sresi: pi r sqrt(rho / G) / (0.1631 v + 0.8766), rho = 3 / (4 pi) (ktle r^3)
+float demRayleighTime(const std::vector<Sphere>& spheres, const MaterialTable& materials);
+
+// Hertz normal ve Mindlin teetsel yay-snmleyici kuvvetleriyle bir kare ilerletir. Ayn kreleri,
+// malzeme tablosunu, dnme durumunu ve kp kab kullanr; kare kararl alt admlara blnr.
+void updateDemSimulation(std::vector<Sphere>& spheres, float cubeSize, float deltaTime, SimulationContext& context);
@@ -0,0 +1,162 @@
+#include "DistanceField.h"
+#include "Parallel.h"
+#include "Simd.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace {
+
+const int kNodeStride = 4; // (uzaklk, eim x, eim y, eim z)
+
+// Dnel cisimler iin (r, y) dzleminde ikizkenar yamua iaretli uzaklk (darda pozitif).
+// r1 alt, r2 st yarap; he yar ykseklik.
+float trapezoidDistance(glm::vec2 p, float r1, float r2, float he) {
+    glm::vec2 k1(r2, he);
+    glm::vec2 k2(r2 - r1, 2.0f * he);
+    p.x = std::abs(p.x);
+    glm::vec2 ca(p.x - std::min(p.x, p.y < 0.0f ? r1 : r2), std::abs(p.y) - he);
+    glm::vec2 cb = p - k1 + k2 * glm::clamp(glm::dot(k1 - p, k2) / glm::dot(k2, k2), 0.0f, 1.0f);
+    float sign = (cb.x < 0.0f && ca.y < 0.0f) ? -1.0f : 1.0f;
+    return sign * std::sqrt(std::min(glm::dot(ca, ca), glm::dot(cb, cb)));
+}
+
+} // namespace
+
+
+float boxContainerDistance(const glm::vec3& point, const glm::vec3& halfExtents) {
+    glm::vec3 d = glm::abs(point) - halfExtents;
+    float outside = glm::length(glm::max(d, glm::vec3(0.0f)));
+    float inside = std::min(std::max(d.x, std::max(d.y, d.z)), 0.0f);
+    return -(outside + inside);
+}
+
+float cylinderContainerDistance(const glm::vec3& point, float radius, float halfHeight) {
+    return hopperContainerDistance(point, radius, radius, halfHeight);
+}
+
+float hopperContainerDistance(const glm::vec3& point, float bottomRadius, float topRadius, float halfHeight) {
+    glm::vec2 radial(std::sqrt(point.x * point.x + point.z * point.z), point.y);
+    return -trapezoidDistance(radial, bottomRadius, topRadius, halfHeight);
+}
+
+void bakeDistanceField(DistanceField& field, const glm::vec3& lo, const glm::vec3& hi, float cellSize,
+    const std::function<float(const glm::vec3&)>& distance) {
+    field.origin = lo;
+    field.cellSize = cellSize;
+    field.dims = glm::max(glm::ivec3(glm::ceil((hi - lo) / cellSize)) + 1, glm::ivec3(2));
+    const glm::ivec3 dims = field.dims;
+    const size_t nodeCount = static_cast<size_t>(dims.x) * dims.y * dims.z;
+    field.nodes.assign(nodeCount * kNodeStride, 0.0f);
+
+    auto node = [&](int x, int y, int z) { return (static_cast<size_t>(z) * dims.y + y) * dims.x + x; };
+
+    parallelFor(dims.z, [&](size_t begin, size_t end, int) {
+        for (int z = static_cast<int>(begin); z < static_cast<int>(end); ++z) {
+            for (int y = 0; y < dims.y; ++y) {
+                for (int x = 0; x < dims.x; ++x) {
+                    field.nodes[node(x, y, z) * kNodeStride] = distance(lo + glm::vec3(x, y, z) * cellSize);
+                }
+            }
+        }
+    }, 1);
+
+    // Eim dm deerlerinin merkezi farkdr (kenarlarda tek ynl), bylece rneklenen alanla tutarldr
+    parallelFor(dims.z, [&](size_t begin, size_t end, int) {
+        for (int z = static_cast<int>(begin); z < static_cast<int>(end); ++z) {
+            for (int y = 0; y < dims.y; ++y) {
+                for (int x = 0; x < dims.x; ++x) {
+                    const glm::ivec3 at(x, y, z);
+                    float* target = &field.nodes[node(x, y, z) * kNodeStride];
+                    for (int axis = 0; axis < 3; ++axis) {
+                        glm::ivec3 below = at, above = at;
+                        below[axis] = std::max(at[axis] - 1, 0);
+                        above[axis] = std::min(at[axis] + 1, dims[axis] - 1);
+                        float difference = field.nodes[node(above.x, above.y, above.z) * kNodeStride]
+                                         - field.nodes[node(below.x, below.y, below.z) * kNodeStride];
+                        target[1 + axis] = difference / (static_cast<float>(above[axis] - below[axis]) * cellSize);
+                    }
+                }
+            }
+        }
+    }, 1);
+}
+
+void findDistanceFieldContacts(DistanceField& field, ContainerFrame& frame, size_t sphereCount) {
+    frame.contacts.clear();
+    field.contactDistance.clear();
+    field.contactNormal.clear();
+    if (sphereCount == 0 || field.nodes.empty()) return;
+
+    const int threads = parallelThreadCount();
+    field.threadContacts.resize(threads);
+    field.threadDistance.resize(threads);
+    field.threadNormal.resize(threads);
+    for (int t = 0; t < threads; ++t) {
+        field.threadContacts[t].clear();
+        field.threadDistance[t].clear();
+        field.threadNormal[t].clear();
+    }
+
+    const glm::ivec3 dims = field.dims;
+    const SimdFloat inverseCell = simdSet(1.0f / field.cellSize);
+    const SimdFloat originX = simdSet(field.origin.x), originY = simdSet(field.origin.y), originZ = simdSet(field.origin.z);
+    const SimdFloat zero = simdSet(0.0f);
+    // Hcre indeksi en fazla dims - 2 olsun diye st snr son dmn hemen altdr
+    const SimdFloat limitX = simdSet(dims.x - 1.001f), limitY = simdSet(dims.y - 1.001f), limitZ = simdSet(dims.z - 1.001f);
+    const SimdInt strideY = simdSetInt(dims.x), strideZ = simdSetInt(dims.x * dims.y);
+    const SimdInt nodeStride = simdSetInt(kNodeStride);
+    const int cornerOffset[8] = {
+        0, 1, dims.x, dims.x + 1,
+        dims.x * dims.y, dims.x * dims.y + 1, dims.x * dims.y + dims.x, dims.x * dims.y + dims.x + 1,
+    };
+    const float* nodes = field.nodes.data();
+    const size_t blocks = (sphereCount + SIMD_WIDTH - 1) / SIMD_WIDTH;
+
+    parallelFor(blocks, [&](size_t begin, size_t end, int thread) {
+        alignas(32) float sample[4][SIMD_WIDTH];
+        for (size_t block = begin; block < end; ++block) {
+            const size_t first = block * SIMD_WIDTH;
+            SimdFloat gx = simdClamp((simdLoad(&frame.positionX[first]) - originX) * inverseCell, zero, limitX);
+            SimdFloat gy = simdClamp((simdLoad(&frame.positionY[first]) - originY) * inverseCell, zero, limitY);
+            SimdFloat gz = simdClamp((simdLoad(&frame.positionZ[first]) - originZ) * inverseCell, zero, limitZ);
+            SimdInt ix = simdToInt(gx), iy = simdToInt(gy), iz = simdToInt(gz);
+            SimdFloat fx = gx - simdToFloat(ix), fy = gy - simdToFloat(iy), fz = gz - simdToFloat(iz);
+            SimdInt cell = (iz * strideZ + iy * strideY + ix) * nodeStride;
+
+            // Sekiz kenin arlklar: ke c iin bit 0 x, bit 1 y, bit 2 z
+            SimdFloat one = simdSet(1.0f);
+            SimdFloat wx[2] = { one - fx, fx }, wy[2] = { one - fy, fy }, wz[2] = { one - fz, fz };
+            SimdFloat value[4] = { zero, zero, zero, zero };
+            for (int corner = 0; corner < 8; ++corner) {
+                SimdFloat weight = wx[corner & 1] * wy[(corner >> 1) & 1] * wz[corner >> 2];
+                SimdInt index = cell + simdSetInt(cornerOffset[corner] * kNodeStride);
+                for (int k = 0; k < 4; ++k) {
+                    value[k] = value[k] + weight * simdGather(nodes + k, index);
+                }
+            }
+
+            int mask = simdMoveMask(simdLess(value[0], simdLoad(&frame.radius[first])));
+            if (mask == 0) continue;
+            for (int k = 0; k < 4; ++k) {
+                simdStore(sample[k], value[k]);
+            }
+            for (int lane = 0; lane < SIMD_WIDTH; ++lane) {
+                if ((mask & (1 << lane)) == 0 || first + lane >= sphereCount) continue;
+                glm::vec3 gradient(sample[1][lane], sample[2][lane], sample[3][lane]);
+                float length = glm::length(gradient);
+                if (length <= 0.0f) continue; // Alann dz olduu yerde yn tanmsz
+                field.threadContacts[thread].push_back(static_cast<int>(first + lane));
+                field.threadDistance[thread].push_back(sample[0][lane]);
+                field.threadNormal[thread].push_back(gradient / length);
+            }
+        }
+    }, 512);
+
+    for (int t = 0; t < threads; ++t) {
+        frame.contacts.insert(frame.contacts.end(), field.threadContacts[t].begin(), field.threadContacts[t].end());
+        field.contactDistance.insert(field.contactDistance.end(), field.threadDistance[t].begin(), field.threadDistance[t].end());
+        field.contactNormal.insert(field.contactNormal.end(), field.threadNormal[t].begin(), field.threadNormal[t].end());
+    }
+}
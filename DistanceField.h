@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Container.h"
+#include <functional>
+#include <glm/glm.hpp>
+#include <vector>
+
+
+// Kabn i blgesinin iaretli uzaklk alan, dzgn bir zgaraya bir kez piirilir. Deer duvara olan
+// uzaklktr: kabn iinde pozitif, duvarn iinde negatif. Eim i blgeye doru bakar.
+// Kap erevesinde tanmldr; Container dnmyle birlikte hareket eder.
+struct DistanceField {
+    bool enabled = false; // Aksa kreler kutu duvarlar yerine bu alana arpar
+    glm::vec3 origin = glm::vec3(0.0f);
+    float cellSize = 1.0f;
+    glm::ivec3 dims = glm::ivec3(0); // Dm says
+
+    // Dm bana (uzaklk, eim x, eim y, eim z); tek toplama ile bir dmn tm okunur
+    std::vector<float> nodes;
+
+    // Son arpma geiinin temaslar: frame.contacts ile ayn srada, kap erevesinde
+    std::vector<float> contactDistance;
+    std::vector<glm::vec3> contactNormal;
+    std::vector<std::vector<int>> threadContacts;
+    std::vector<std::vector<float>> threadDistance;
+    std::vector<std::vector<glm::vec3>> threadNormal;
+};
+
+//  blgede pozitif uzaklk fonksiyonlar (kap erevesinde, eksen y)
+float boxContainerDistance(const glm::vec3& point, const glm::vec3& halfExtents);
+float cylinderContainerDistance(const glm::vec3& point, float radius, float halfHeight);
+// Kesik koni: alt yarap y = -halfHeight'ta, st yarap y = +halfHeight'ta
+float hopperContainerDistance(const glm::vec3& point, float bottomRadius, float topRadius, float halfHeight);
+
+// [lo, hi] kutusunu cellSize aralkl dmlerle rnekler; eim merkezi farklarla hesaplanr.
+// Kutu kab bir hcreden fazla payla sarmaldr, dardaki rnekler kenar dmlerine kstrlr.
+void bakeDistanceField(DistanceField& field, const glm::vec3& lo, const glm::vec3& hi, float cellSize,
+    const std::function<float(const glm::vec3&)>& distance);
+
+// Kap erevesindeki kreleri 8'erli eritlerle alana sorar: uzaklk yaraptan kkse temas.
+// frame.contacts' bu temaslarla deitirir ve her temasn derinliini ve normalini field'a yazar.
+void findDistanceFieldContacts(DistanceField& field, ContainerFrame& frame, size_t sphereCount);
@@ -0,0 +1,167 @@
+#include "Emitter.h"
+#include "Parallel.h"
+#include "Random.h"
+#include "Simulation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
+namespace {
+
+// Rastgele kelimenin st 24 biti [0, 1) aralna
+float unitFloat(int bits) {
+    return static_cast<float>(static_cast<uint32_t>(bits) >> 8) * (1.0f / 16777216.0f);
+}
+
+bool insideBox(const glm::vec3& point, const glm::vec3& center, const glm::vec3& halfExtents) {
+    glm::vec3 d = glm::abs(point - center);
+    return d.x <= halfExtents.x && d.y <= halfExtents.y && d.z <= halfExtents.z;
+}
+
+// Kutu dnyasnda retilen kre, merkezi konumuna en yakn kutuya atanr
+int nearestBatchContainer(const ContainerBatch& batch, const glm::vec3& position) {
+    int nearest = 0;
+    float best = std::numeric_limits<float>::infinity();
+    for (size_t k = 0; k < batch.origins.size(); ++k) {
+        glm::vec3 d = position - batch.origins[k];
+        float distance = glm::dot(d, d);
+        if (distance < best) {
+            best = distance;
+            nearest = static_cast<int>(k);
+        }
+    }
+    return nearest;
+}
+
+} // namespace
+
+
+void reserveSpherePool(std::vector<Sphere>& spheres, SimulationContext& context, size_t capacity) {
+    SpherePool& pool = context.pool;
+    pool.capacity = std::max(capacity, spheres.size());
+    spheres.reserve(pool.capacity);
+    pool.removed.reserve(pool.capacity);
+
+    const size_t padded = (pool.capacity + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH;
+    RotationState& rotation = context.rotation;
+    for (std::vector<float>* array : { &rotation.angularX, &rotation.angularY, &rotation.angularZ, &rotation.orientationW,
+                                       &rotation.orientationX, &rotation.orientationY, &rotation.orientationZ }) {
+        array->reserve(padded);
+    }
+    resizeRotationState(rotation, spheres.size());
+
+    WallSchedule& schedule = context.wallSchedule;
+    schedule.dueStep.reserve(pool.capacity);
+    schedule.visitedStep.reserve(pool.capacity);
+    if (!context.batch.origins.empty()) {
+        context.batch.sphereContainer.reserve(pool.capacity);
+    }
+
+    reserveSphereHandles(context.handles, pool.capacity);
+}
+
+bool spawnSphere(std::vector<Sphere>& spheres, SimulationContext& context, const Sphere& sphere) {
+    if (spheres.size() >= context.pool.capacity) return false;
+    const size_t index = spheres.size();
+    ContainerBatch& batch = context.batch;
+    if (!batch.origins.empty() && batch.sphereContainer.size() == index) {
+        batch.sphereContainer.push_back(nearestBatchContainer(batch, sphere.position));
+    }
+    spheres.push_back(sphere);
+    // Dolgu blgesinde nceki bir krenin durumu kalm olabilir
+    resizeRotationState(context.rotation, spheres.size());
+    resetSphereRotation(context.rotation, index);
+    addWallScheduleSphere(context.wallSchedule, static_cast<int>(index));
+    addSphereHandle(context.handles, index);
+    return true;
+}
+
+void despawnSphere(std::vector<Sphere>& spheres, SimulationContext& context, size_t index) {
+    const size_t last = spheres.size() - 1;
+    std::vector<int>& sphereContainer = context.batch.sphereContainer;
+    const bool batched = sphereContainer.size() == spheres.size();
+    if (index != last) {
+        spheres[index] = spheres[last];
+        copySphereRotation(context.rotation, last, index);
+        if (batched) sphereContainer[index] = sphereContainer[last];
+    }
+    spheres.pop_back();
+    if (batched) sphereContainer.pop_back();
+    resizeRotationState(context.rotation, spheres.size());
+    removeWallScheduleSphere(context.wallSchedule, static_cast<int>(index));
+    removeSphereHandle(context.handles, index);
+}
+
+void updateSpherePool(std::vector<Sphere>& spheres, SimulationContext& context, float deltaTime) {
+    SpherePool& pool = context.pool;
+    // Kapasitesi sfr bir havuzda yayc hi kre retemezdi
+    if (pool.capacity == 0 && !pool.emitters.empty()) {
+        reserveSpherePool(spheres, context, spheres.size() + DEFAULT_SPHERE_POOL_CAPACITY);
+    } else if (pool.capacity < spheres.size()) {
+        reserveSpherePool(spheres, context, spheres.size());
+    }
+
+    if (!pool.sinks.empty() && !spheres.empty()) {
+        const int threads = parallelThreadCount();
+        pool.threadRemoved.resize(threads);
+        // parallelFor tm paralar balatmayabilir; almayan paralarn listeleri de bo olmaldr
+        for (std::vector<int>& removed : pool.threadRemoved) {
+            removed.clear();
+        }
+        parallelFor(spheres.size(), [&](size_t begin, size_t end, int thread) {
+            std::vector<int>& removed = pool.threadRemoved[thread];
+            for (size_t s = begin; s < end; ++s) {
+                for (const SphereSink& sink : pool.sinks) {
+                    if (insideBox(spheres[s].position, sink.center, sink.halfExtents)) {
+                        removed.push_back(static_cast<int>(s));
+                        break;
+                    }
+                }
+            }
+        }, 4096);
+        pool.removed.clear();
+        for (const std::vector<int>& removed : pool.threadRemoved) {
+            pool.removed.insert(pool.removed.end(), removed.begin(), removed.end());
+        }
+
+        // Bykten ke: sondan tanan kre her zaman daha nce ilenmi ve kalan bir kredir
+        for (auto it = pool.removed.rbegin(); it != pool.removed.rend(); ++it) {
+            despawnSphere(spheres, context, *it);
+        }
+    }
+
+    alignas(32) int lanes[SIMD_WIDTH];
+    alignas(32) int words[4][SIMD_WIDTH];
+    for (SphereEmitter& emitter : pool.emitters) {
+        emitter.pending += emitter.rate * deltaTime;
+        int count = static_cast<int>(emitter.pending);
+        emitter.pending -= static_cast<float>(count);
+        count = std::min(count, static_cast<int>(pool.capacity - spheres.size()));
+
+        // Her 8 kre iin bir Philox blou: erit bana  konum ve bir yarap kelimesi
+        for (int first = 0; first < count; first += SIMD_WIDTH) {
+            for (int lane = 0; lane < SIMD_WIDTH; ++lane) {
+                lanes[lane] = static_cast<int>(pool.spawned + lane);
+            }
+            SimdPhilox random = simdRandomBits(simdLoadInt(lanes), pool.spawned >> 32, pool.seed, RANDOM_STREAM_EMITTER);
+            for (int k = 0; k < 4; ++k) {
+                simdStoreInt(words[k], random.word[k]);
+            }
+
+            const int batch = std::min(count - first, SIMD_WIDTH);
+            for (int lane = 0; lane < batch; ++lane) {
+                Sphere sphere;
+                glm::vec3 unit(unitFloat(words[0][lane]), unitFloat(words[1][lane]), unitFloat(words[2][lane]));
+                sphere.position = emitter.center + (unit * 2.0f - 1.0f) * emitter.halfExtents;
+                sphere.radius = emitter.minRadius + (emitter.maxRadius - emitter.minRadius) * unitFloat(words[3][lane]);
+                sphere.color = emitter.color;
+                sphere.velocity = emitter.velocity;
+                sphere.material = emitter.material;
+                spawnSphere(spheres, context, sphere);
+            }
+            pool.spawned += SIMD_WIDTH;
+        }
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Sphere.h"
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+
+struct SimulationContext;
+
+// Eksenlere hizal kutu hacminde saniyede rate kre retir; konumlar hacim iinde dzgn rastgele,
+// yaraplar [minRadius, maxRadius] aralndadr. retilen kreler rtebilir; hacim ak hzna
+// gre yeterince byk seilmelidir.
+struct SphereEmitter {
+    glm::vec3 center = glm::vec3(0.0f);
+    glm::vec3 halfExtents = glm::vec3(0.1f);
+    float rate = 100.0f;
+    float minRadius = 0.02f;
+    float maxRadius = 0.02f;
+    glm::vec3 velocity = glm::vec3(0.0f);
+    glm::vec3 color = glm::vec3(1.0f);
+    int material = 0;
+    float pending = 0.0f; // Kesirli birikim; tam ksm bu admda retilir
+};
+
+// Merkezi bu kutuya giren kreler havuza geri verilir
+struct SphereSink {
+    glm::vec3 center = glm::vec3(0.0f);
+    glm::vec3 halfExtents = glm::vec3(0.1f);
+};
+
+// reserveSpherePool arlmadan yayc eklenirse havuz ilk updateSpherePool'da mevcut krelere ek
+// olarak bu kadar yerle ayrlr
+const size_t DEFAULT_SPHERE_POOL_CAPACITY = 65536;
+
+// Sabit kapasiteli kre havuzu. Kreler dizide youn tutulur (tm ekirdekler [0, n) araln
+// iler); bo yerler kapasitenin sonundaki [n, capacity) blgesidir. karma son kreyi boalan yere
+// tar, ekleme sona yazar: ikisi de O(1)'dir ve kapasite nceden ayrld iin bellek ayrmaz.
+// Yayclar yalnzca kapasiteye kadar retir: st snr reserveSpherePool ile nceden verilmelidir,
+// verilmezse DEFAULT_SPHERE_POOL_CAPACITY kullanlr.
+struct SpherePool {
+    size_t capacity = 0; // 0: henz ayrlmad
+    std::vector<SphereEmitter> emitters;
+    std::vector<SphereSink> sinks;
+    uint32_t seed = 20240613u;
+    uint64_t spawned = 0; // Rastgele say sayac; her retilen kre bir erit tketir
+
+    std::vector<int> removed;
+    std::vector<std::vector<int>> threadRemoved;
+};
+
+// Kre dizisini ve kre bana durumu (dnme, duvar takvimi, tutamalar, kutu dnyas atamalar)
+// capacity kadar ayrr
+void reserveSpherePool(std::vector<Sphere>& spheres, SimulationContext& context, size_t capacity);
+
+// Kreyi sona ekler; havuz doluysa false dner. Kutu dnyasnda kre merkezi en yakn kutuya atanr.
+bool spawnSphere(std::vector<Sphere>& spheres, SimulationContext& context, const Sphere& sphere);
+
+// index'teki kreyi karr: son kre (ve durumu) onun yerine tanr, dolaysyla son krenin
+// indeksi deiir
+void despawnSphere(std::vector<Sphere>& spheres, SimulationContext& context, size_t index);
+
+// nce havuzlara den kreleri karr, sonra yayclardan deltaTime'a den kreleri retir. Havuz
+// hi ayrlmamsa ve yayc varsa nce varsaylan kapasiteyle ayrr; havuz doluyken retim durur.
+void updateSpherePool(std::vector<Sphere>& spheres, SimulationContext& context, float deltaTime);
@@ -0,0 +1,48 @@
+#include "Langevin.h"
+#include "Parallel.h"
+#include "Random.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+
+void applyLangevinThermostat(std::vector<Sphere>& spheres, const SphereHandleMap& handles, LangevinState& state,
+    float deltaTime) {
+    assert(handles.enabled && handles.denseSlot.size() == spheres.size());
+    const LangevinSettings& settings = state.settings;
+    const float decay = std::exp(-settings.friction * deltaTime);
+    const float variance = (1.0f - decay * decay) * settings.temperature;
+    const uint64_t step = state.step++;
+    const size_t blocks = (spheres.size() + SIMD_WIDTH - 1) / SIMD_WIDTH;
+
+    parallelFor(blocks, [&](size_t begin, size_t end, int) {
+        alignas(32) float noise[3][SIMD_WIDTH];
+        alignas(32) int slot[SIMD_WIDTH];
+        alignas(32) int generation[SIMD_WIDTH];
+        for (size_t block = begin; block < end; ++block) {
+            size_t first = block * SIMD_WIDTH;
+            size_t last = std::min(first + SIMD_WIDTH, spheres.size());
+            // Saya yuva ve nesille kurulur; dolgu eritlerinin grlts kullanlmaz
+            for (int lane = 0; lane < SIMD_WIDTH; ++lane) {
+                SphereHandle handle = first + lane < last ? sphereHandle(handles, first + lane) : SphereHandle();
+                slot[lane] = static_cast<int>(handle.slot);
+                generation[lane] = static_cast<int>(handle.generation);
+            }
+
+            // erit bana drt normal say retilir,  x, y, z grltsdr
+            SimdFloat normals[4];
+            simdGaussians(simdLoadInt(slot), step, settings.seed, RANDOM_STREAM_LANGEVIN, normals, simdLoadInt(generation));
+            simdStore(noise[0], normals[0]);
+            simdStore(noise[1], normals[1]);
+            simdStore(noise[2], normals[2]);
+
+            for (size_t i = first; i < last; ++i) {
+                Sphere& sphere = spheres[i];
+                float scale = std::sqrt(variance / sphereMass(sphere.radius));
+                int lane = static_cast<int>(i - first);
+                sphere.velocity = sphere.velocity * decay + glm::vec3(noise[0][lane], noise[1][lane], noise[2][lane]) * scale;
+            }
+        }
+    }, 64);
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Sphere.h"
+#include "SphereHandles.h"
+#include <cstdint>
+#include <vector>
+
+
+struct LangevinSettings {
+    float temperature = 1e-6f; // kT; ktle r^3 birimiyle
+    float friction = 2.0f;     // Srtnme katsays gamma (1 / s); hz bu hzla snmlenir
+    uint32_t seed = 20240611u;
+};
+
+struct LangevinState {
+    LangevinSettings settings;
+    uint64_t step = 0; // Grlt sayacnn adm kelimesi; her arda artar
+};
+
+// OrnsteinUhlenbeck adm: v <- a v + sqrt((1 - a^2) kT / m) xi, a = exp(-gamma dt).
+// Konum adm ve arpmalar itmeli moddaki gibi ardndan yaplr. Grlt (tutama, adm) sayacndan
+// retildii iin her krenin ak i parac saysndan bamsz ve tekrarlanabilirdir; tutama
+// youn indeksin aksine Morton sralamasnda ve havuzdan karmada kreyle birlikte tanr.
+// handles ak ve spheres ile ayn boyda olmaldr.
+void applyLangevinThermostat(std::vector<Sphere>& spheres, const SphereHandleMap& handles, LangevinState& state,
+    float deltaTime);
@@ -0,0 +1,336 @@
+#include "LennardJones.h"
+#include "Parallel.h"
+#include "Simd.h"
+#include "Simulation.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace {
+
+void resizeLennardJonesState(LennardJonesState& md, size_t count) {
+    size_t padded = (count + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH;
+    for (std::vector<float>* array : { &md.positionX, &md.positionY, &md.positionZ, &md.radius,
+             &md.velocityX, &md.velocityY, &md.velocityZ, &md.forceX, &md.forceY, &md.forceZ,
+             &md.inverseMass, &md.listRadius, &md.referenceX, &md.referenceY, &md.referenceZ }) {
+        array->assign(padded, 0.0f);
+    }
+
+    int threads = parallelThreadCount();
+    for (std::vector<std::vector<float>>* buffers : { &md.threadForceX, &md.threadForceY, &md.threadForceZ }) {
+        buffers->assign(threads, std::vector<float>(padded, 0.0f));
+    }
+    md.threadEnergy.assign(threads, 0.0);
+    md.threadDisplacement.assign(threads, 0.0f);
+    md.threadFirst.resize(threads);
+    md.threadSecond.resize(threads);
+    md.listValid = false;
+    md.count = count;
+}
+
+void loadLennardJonesState(LennardJonesState& md, const std::vector<Sphere>& spheres) {
+    const float listScale = md.settings.cutoff + md.settings.skin;
+    parallelFor(spheres.size(), [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; ++i) {
+            const Sphere& sphere = spheres[i];
+            md.positionX[i] = sphere.position.x;
+            md.positionY[i] = sphere.position.y;
+            md.positionZ[i] = sphere.position.z;
+            md.radius[i] = sphere.radius;
+            md.velocityX[i] = sphere.velocity.x;
+            md.velocityY[i] = sphere.velocity.y;
+            md.velocityZ[i] = sphere.velocity.z;
+            md.inverseMass[i] = 1.0f / sphereMass(sphere.radius);
+            md.listRadius[i] = listScale * sphere.radius;
+        }
+    });
+}
+
+void storeLennardJonesState(const LennardJonesState& md, std::vector<Sphere>& spheres) {
+    parallelFor(spheres.size(), [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; ++i) {
+            spheres[i].position = glm::vec3(md.positionX[i], md.positionY[i], md.positionZ[i]);
+            spheres[i].velocity = glm::vec3(md.velocityX[i], md.velocityY[i], md.velocityZ[i]);
+        }
+    });
+}
+
+// Liste kurulduundan beri en ok yer deitiren krenin yer deitirmesi
+float maxDisplacement(LennardJonesState& md) {
+    std::fill(md.threadDisplacement.begin(), md.threadDisplacement.end(), 0.0f);
+    parallelFor(md.positionX.size() / SIMD_WIDTH, [&](size_t begin, size_t end, int thread) {
+        SimdFloat largest = simdSet(0.0f);
+        for (size_t block = begin; block < end; ++block) {
+            size_t i = block * SIMD_WIDTH;
+            SimdFloat dx = simdLoad(&md.positionX[i]) - simdLoad(&md.referenceX[i]);
+            SimdFloat dy = simdLoad(&md.positionY[i]) - simdLoad(&md.referenceY[i]);
+            SimdFloat dz = simdLoad(&md.positionZ[i]) - simdLoad(&md.referenceZ[i]);
+            largest = simdMax(largest, simdDot(dx, dy, dz, dx, dy, dz));
+        }
+        alignas(32) float lanes[SIMD_WIDTH];
+        simdStore(lanes, largest);
+        md.threadDisplacement[thread] = *std::max_element(lanes, lanes + SIMD_WIDTH);
+    }, 64);
+    return std::sqrt(*std::max_element(md.threadDisplacement.begin(), md.threadDisplacement.end()));
+}
+
+// Yarm Verlet listesi: her kre 27 komu hcrede kendisinden byk indeksli ve
+// (cutoff + skin) * sigma_ij iindeki kreleri yazar. Paralar i parac srasyla birletirilir.
+void buildNeighbourList(LennardJonesState& md, SpatialGrid& grid) {
+    const int count = static_cast<int>(md.count);
+    buildSpatialGrid(grid, md.positionX.data(), md.positionY.data(), md.positionZ.data(), md.listRadius.data(), count);
+
+    const int threads = parallelThreadCount();
+    for (int t = 0; t < threads; ++t) {
+        md.threadFirst[t].clear();
+        md.threadSecond[t].clear();
+    }
+
+    parallelFor(count, [&](size_t begin, size_t end, int thread) {
+        std::vector<int>& first = md.threadFirst[thread];
+        std::vector<int>& second = md.threadSecond[thread];
+        for (size_t i = begin; i < end; ++i) {
+            int cell = grid.sphereCell[i];
+            int cx = cell % grid.dims.x;
+            int cy = (cell / grid.dims.x) % grid.dims.y;
+            int cz = cell / (grid.dims.x * grid.dims.y);
+            float xi = md.positionX[i], yi = md.positionY[i], zi = md.positionZ[i], ri = md.listRadius[i];
+
+            for (int z = std::max(cz - 1, 0); z <= std::min(cz + 1, grid.dims.z - 1); ++z) {
+                for (int y = std::max(cy - 1, 0); y <= std::min(cy + 1, grid.dims.y - 1); ++y) {
+                    for (int x = std::max(cx - 1, 0); x <= std::min(cx + 1, grid.dims.x - 1); ++x) {
+                        int neighbour = (z * grid.dims.y + y) * grid.dims.x + x;
+                        for (int e = grid.cellStart[neighbour]; e < grid.cellStart[neighbour + 1]; ++e) {
+                            int j = grid.cellEntries[e];
+                            if (j <= static_cast<int>(i)) continue;
+                            float dx = md.positionX[j] - xi;
+                            float dy = md.positionY[j] - yi;
+                            float dz = md.positionZ[j] - zi;
+                            float reach = ri + md.listRadius[j];
+                            if (dx * dx + dy * dy + dz * dz >= reach * reach) continue;
+                            first.push_back(static_cast<int>(i));
+                            second.push_back(j);
+                        }
+                    }
+                }
+            }
+        }
+    }, 256);
+
+    size_t total = 0;
+    for (int t = 0; t < threads; ++t) {
+        total += md.threadFirst[t].size();
+    }
+    md.pairCount = static_cast<int>(total);
+    size_t padded = (total + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH;
+    md.first.assign(padded, 0);
+    md.second.assign(padded, 0);
+    size_t offset = 0;
+    for (int t = 0; t < threads; ++t) {
+        std::copy(md.threadFirst[t].begin(), md.threadFirst[t].end(), md.first.begin() + offset);
+        std::copy(md.threadSecond[t].begin(), md.threadSecond[t].end(), md.second.begin() + offset);
+        offset += md.threadFirst[t].size();
+    }
+
+    md.referenceX = md.positionX;
+    md.referenceY = md.positionY;
+    md.referenceZ = md.positionZ;
+    md.listValid = true;
+    ++md.listBuilds;
+}
+
+// ift kuvvetleri 8'erli eritlerde hesaplanr ve Newton'un 3. yasasyla iki kreye ters iaretle
+// yazlr. Ayn kre birden ok iftte bulunabildiinden yazma i paracnn kendi tamponuna
+// yaplr; tamponlar ardndan kre bana toplanr ve sfrlanr.
+void computeLennardJonesForces(LennardJonesState& md) {
+    const float epsilon = md.settings.epsilon;
+    const float cutoff = md.settings.cutoff;
+    // U(rc) / (4 epsilon), rc = cutoff * sigma iin sigma'dan bamszdr
+    const float inverseCutoff6 = 1.0f / (cutoff * cutoff * cutoff * cutoff * cutoff * cutoff);
+    const float shift = inverseCutoff6 * inverseCutoff6 - inverseCutoff6;
+    std::fill(md.threadEnergy.begin(), md.threadEnergy.end(), 0.0);
+
+    parallelFor(md.first.size() / SIMD_WIDTH, [&](size_t begin, size_t end, int thread) {
+        const SimdFloat zero = simdSet(0.0f);
+        const SimdFloat one = simdSet(1.0f);
+        const SimdFloat tiny = simdSet(1e-20f);
+        const SimdFloat cutoffSquared = simdSet(cutoff * cutoff);
+        const SimdFloat forceScale = simdSet(24.0f * epsilon);
+        const SimdFloat energyShift = simdSet(shift);
+        float* forceX = md.threadForceX[thread].data();
+        float* forceY = md.threadForceY[thread].data();
+        float* forceZ = md.threadForceZ[thread].data();
+        alignas(32) int firstLanes[SIMD_WIDTH];
+        alignas(32) int secondLanes[SIMD_WIDTH];
+        alignas(32) float lanes[4][SIMD_WIDTH];
+        SimdFloat energy = zero;
+
+        for (size_t block = begin; block < end; ++block) {
+            size_t p = block * SIMD_WIDTH;
+            SimdInt i = simdLoadInt(&md.first[p]);
+            SimdInt j = simdLoadInt(&md.second[p]);
+
+            SimdFloat dx = simdGather(md.positionX.data(), j) - simdGather(md.positionX.data(), i);
+            SimdFloat dy = simdGather(md.positionY.data(), j) - simdGather(md.positionY.data(), i);
+            SimdFloat dz = simdGather(md.positionZ.data(), j) - simdGather(md.positionZ.data(), i);
+            SimdFloat sigma = simdGather(md.radius.data(), i) + simdGather(md.radius.data(), j);
+            SimdFloat distanceSquared = simdMax(simdDot(dx, dy, dz, dx, dy, dz), tiny);
+
+            // s2 = (sigma / r)^2; kesmenin dndaki ve dolgu eritleri sfrlanr
+            SimdFloat s2 = sigma * sigma / distanceSquared;
+            // Mutlak indeks float'ta 2^24'ten sonra yuvarlanr; kalan ift saysyla karlatrlr
+            SimdFloat valid = simdLess(simdLaneIndex(), simdSet(static_cast<float>(md.pairCount - static_cast<int>(p))));
+            SimdFloat inside = simdAnd(valid, simdGreater(s2 * cutoffSquared, one));
+            SimdFloat s6 = s2 * s2 * s2;
+            SimdFloat s12 = s6 * s6;
+
+            // F_i = -24 epsilon (2 s12 - s6) / r^2 * (xj - xi)
+            SimdFloat magnitude = simdSelect(inside, forceScale * (s12 + s12 - s6) / distanceSquared, zero);
+            energy = energy + simdSelect(inside, s12 - s6 - energyShift, zero);
+
+            simdStore(lanes[0], magnitude * dx);
+            simdStore(lanes[1], magnitude * dy);
+            simdStore(lanes[2], magnitude * dz);
+            simdStoreInt(firstLanes, i);
+            simdStoreInt(secondLanes, j);
+            for (int lane = 0; lane < SIMD_WIDTH; ++lane) {
+                int a = firstLanes[lane], b = secondLanes[lane];
+                forceX[a] -= lanes[0][lane];
+                forceY[a] -= lanes[1][lane];
+                forceZ[a] -= lanes[2][lane];
+                forceX[b] += lanes[0][lane];
+                forceY[b] += lanes[1][lane];
+                forceZ[b] += lanes[2][lane];
+            }
+        }
+
+        simdStore(lanes[3], energy);
+        double sum = 0.0;
+        for (int lane = 0; lane < SIMD_WIDTH; ++lane) {
+            sum += lanes[3][lane];
+        }
+        md.threadEnergy[thread] = 4.0 * epsilon * sum;
+    }, 64);
+
+    const int threads = static_cast<int>(md.threadForceX.size());
+    parallelFor(md.positionX.size() / SIMD_WIDTH, [&](size_t begin, size_t end, int) {
+        const SimdFloat zero = simdSet(0.0f);
+        for (size_t block = begin; block < end; ++block) {
+            size_t i = block * SIMD_WIDTH;
+            SimdFloat fx = zero, fy = zero, fz = zero;
+            for (int t = 0; t < threads; ++t) {
+                fx = fx + simdLoad(&md.threadForceX[t][i]);
+                fy = fy + simdLoad(&md.threadForceY[t][i]);
+                fz = fz + simdLoad(&md.threadForceZ[t][i]);
+                simdStore(&md.threadForceX[t][i], zero);
+                simdStore(&md.threadForceY[t][i], zero);
+                simdStore(&md.threadForceZ[t][i], zero);
+            }
+            simdStore(&md.forceX[i], fx);
+            simdStore(&md.forceY[i], fy);
+            simdStore(&md.forceZ[i], fz);
+        }
+    }, 64);
+
+    md.potentialEnergy = 0.0;
+    for (double energy : md.threadEnergy) {
+        md.potentialEnergy += energy;
+    }
+}
+
+// Hz-Verlet'in yarm hz adm; d alanlar da ayn geite eklenir
+void kickLennardJones(LennardJonesState& md, const BodyForces& forces, float halfStep) {
+    const glm::vec3 impulse = (forces.gravity + forces.acceleration) * halfStep;
+    const float damping = std::exp(-forces.drag * halfStep);
+    parallelFor(md.positionX.size() / SIMD_WIDTH, [&](size_t begin, size_t end, int) {
+        const SimdFloat step = simdSet(halfStep);
+        const SimdFloat decay = simdSet(damping);
+        const SimdFloat zero = simdSet(0.0f);
+        const SimdFloat kickX = simdSet(impulse.x), kickY = simdSet(impulse.y), kickZ = simdSet(impulse.z);
+        for (size_t block = begin; block < end; ++block) {
+            size_t i = block * SIMD_WIDTH;
+            SimdFloat inverseMass = simdLoad(&md.inverseMass[i]);
+            SimdFloat scale = step * inverseMass;
+            // Dolgu krelerinin ters ktlesi sfrdr, d alan onlara uygulanmaz
+            SimdFloat movable = simdGreater(inverseMass, zero);
+            simdStore(&md.velocityX[i], simdLoad(&md.velocityX[i]) * decay + scale * simdLoad(&md.forceX[i]) + simdSelect(movable, kickX, zero));
+            simdStore(&md.velocityY[i], simdLoad(&md.velocityY[i]) * decay + scale * simdLoad(&md.forceY[i]) + simdSelect(movable, kickY, zero));
+            simdStore(&md.velocityZ[i], simdLoad(&md.velocityZ[i]) * decay + scale * simdLoad(&md.forceZ[i]) + simdSelect(movable, kickZ, zero));
+        }
+    }, 64);
+}
+
+// Konum adm; duvar geip dar doru giden hz bileeni ters evrilir (enerji korunur)
+void driftLennardJones(LennardJonesState& md, float deltaTime, float halfCubeSize) {
+    parallelFor(md.positionX.size() / SIMD_WIDTH, [&](size_t begin, size_t end, int) {
+        const SimdFloat step = simdSet(deltaTime);
+        const SimdFloat zero = simdSet(0.0f);
+        const SimdFloat half = simdSet(halfCubeSize);
+        for (size_t block = begin; block < end; ++block) {
+            size_t i = block * SIMD_WIDTH;
+            SimdFloat limit = half - simdLoad(&md.radius[i]);
+            float* positions[3] = { &md.positionX[i], &md.positionY[i], &md.positionZ[i] };
+            float* velocities[3] = { &md.velocityX[i], &md.velocityY[i], &md.velocityZ[i] };
+            for (int axis = 0; axis < 3; ++axis) {
+                SimdFloat v = simdLoad(velocities[axis]);
+                SimdFloat x = simdLoad(positions[axis]) + step * v;
+                SimdFloat outward = simdOr(simdAnd(simdGreater(x, limit), simdGreater(v, zero)),
+                    simdAnd(simdLess(x, zero - limit), simdLess(v, zero)));
+                simdStore(positions[axis], x);
+                simdStore(velocities[axis], simdSelect(outward, zero - v, v));
+            }
+        }
+    }, 64);
+}
+
+} // namespace
+
+
+void updateLennardJonesSimulation(std::vector<Sphere>& spheres, float cubeSize, float deltaTime, SimulationContext& context) {
+    LennardJonesState& md = context.lennardJones;
+    const LennardJonesSettings& settings = md.settings;
+    if (md.count != spheres.size()) {
+        resizeLennardJonesState(md, spheres.size());
+    }
+    if (spheres.empty() || deltaTime <= 0.0f) return;
+    loadLennardJonesState(md, spheres);
+
+    // tau = sigma sqrt(m / epsilon), en kk kre iin sigma = 2r, m = r^3
+    float smallest = spheres[0].radius;
+    for (const Sphere& sphere : spheres) {
+        smallest = std::min(smallest, sphere.radius);
+    }
+    float tau = 2.0f * smallest * std::sqrt(sphereMass(smallest) / settings.epsilon);
+    float stableStep = settings.timeStepFraction * tau;
+    int substeps = std::min(std::max(static_cast<int>(std::ceil(deltaTime / stableStep)), 1), settings.maxSubsteps);
+    float step = deltaTime / substeps;
+
+    // Bir ift sigma_ij * skin kadar yaklamadan kesmeye giremez; sigma_ij >= 2 * smallest
+    float rebuildDistance = settings.skin * smallest;
+
+    // Kreler kareler arasnda dardan deitirilmi olabilir, bu yzden kuvvetler kare banda yenilenir
+    if (!md.listValid || maxDisplacement(md) > rebuildDistance) {
+        buildNeighbourList(md, context.grid);
+    }
+    computeLennardJonesForces(md);
+
+    for (int s = 0; s < substeps; ++s) {
+        kickLennardJones(md, context.bodyForces, 0.5f * step);
+        driftLennardJones(md, step, cubeSize / 2.0f);
+        if (maxDisplacement(md) > rebuildDistance) {
+            buildNeighbourList(md, context.grid);
+        }
+        computeLennardJonesForces(md);
+        kickLennardJones(md, context.bodyForces, 0.5f * step);
+    }
+
+    double kinetic = 0.0;
+    for (size_t i = 0; i < md.count; ++i) {
+        double speedSquared = md.velocityX[i] * md.velocityX[i] + md.velocityY[i] * md.velocityY[i] + md.velocityZ[i] * md.velocityZ[i];
+        kinetic += 0.5 * speedSquared / md.inverseMass[i];
+    }
+    md.kineticEnergy = kinetic;
+
+    storeLennardJonesState(md, spheres);
+}
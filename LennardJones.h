@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Sphere.h"
+#include <vector>
+
+
+struct SimulationContext;
+
+// ift sigma deeri Lorentz kuralyla aplarn ortalamasdr: sigma_ij = ri + rj.
+// Kesme ve kabuk uzunluklar sigma kat olarak verilir.
+struct LennardJonesSettings {
+    float epsilon = 1e-3f;          // Kuyu derinlii, tm iftler iin ayn
+    float cutoff = 2.5f;            // rc = cutoff * sigma_ij; potansiyel rc'de sfra kaydrlr
+    float skin = 0.3f;              // Komu listesi kabuu; liste (cutoff + skin) * sigma_ij iindeki iftleri tutar
+    float timeStepFraction = 0.005f; // Alt adm, en kk krenin tau = sigma sqrt(m / epsilon) sresinin bu kesri
+    int maxSubsteps = 1000;          // Kare bana alt adm snr; alrsa alt adm byr
+};
+
+// Lennard-Jones modunun admlar aras durumu. DEM modundaki gibi kreler kare banda SoA dizilere
+// kopyalanr; komu listesi kreler kabuun yarsndan fazla yer deitirene kadar yeniden kullanlr.
+struct LennardJonesState {
+    LennardJonesSettings settings;
+
+    size_t count = 0; // Diziler SIMD_WIDTH katna tamamlanr
+    std::vector<float> positionX, positionY, positionZ, radius;
+    std::vector<float> velocityX, velocityY, velocityZ;
+    std::vector<float> forceX, forceY, forceZ;
+    std::vector<float> inverseMass;
+    std::vector<float> listRadius; // (cutoff + skin) * r; zgara bu yaraplarla kurulur
+
+    // Yarm komu listesi (i < j), CandidatePairs gibi (0, 0) iftleriyle SIMD_WIDTH katna tamamlanr
+    std::vector<int> first, second;
+    int pairCount = 0;
+    bool listValid = false;
+    std::vector<float> referenceX, referenceY, referenceZ; // Listenin kurulduu andaki konumlar
+    int listBuilds = 0;                                     // Toplam yeniden kurma says
+
+    //  parac bana kuvvet biriktirme tamponlar ve liste paralar
+    std::vector<std::vector<float>> threadForceX, threadForceY, threadForceZ;
+    std::vector<double> threadEnergy;
+    std::vector<float> threadDisplacement;
+    std::vector<std::vector<int>> threadFirst, threadSecond;
+
+    // Son karenin sonundaki enerjiler
+    double potentialEnergy = 0.0;
+    double kineticEnergy = 0.0;
+};
+
+// Kesilmi ve kaydrlm Lennard-Jones potansiyeliyle hz-Verlet kullanarak bir kare ilerletir.
+// Kp duvarlar yalnzca duvara doru giden hz yanstr; dnme ve malzemeler bu modda kullanlmaz.
+void updateLennardJonesSimulation(std::vector<Sphere>& spheres, float cubeSize, float deltaTime, SimulationContext& context);
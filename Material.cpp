@@ -0,0 +1,70 @@
+#include "Material.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+
+namespace {
+
+void setElasticPair(MaterialTable& table, int a, int b) {
+    float va = table.poissonRatio[a];
+    float vb = table.poissonRatio[b];
+    float young = 1.0f / ((1.0f - va * va) / table.youngModulus[a] + (1.0f - vb * vb) / table.youngModulus[b]);
+    float shear = 1.0f / (2.0f * (2.0f - va) * (1.0f + va) / table.youngModulus[a] + 2.0f * (2.0f - vb) * (1.0f + vb) / table.youngModulus[b]);
+    table.effectiveYoung[a * MAX_MATERIALS + b] = table.effectiveYoung[b * MAX_MATERIALS + a] = young;
+    table.effectiveShear[a * MAX_MATERIALS + b] = table.effectiveShear[b * MAX_MATERIALS + a] = shear;
+}
+
+} // namespace
+
+
+MaterialTable::MaterialTable() : count(1) {
+    std::fill(restitution, restitution + MAX_MATERIALS * MAX_MATERIALS, 1.0f);
+    std::fill(friction, friction + MAX_MATERIALS * MAX_MATERIALS, 0.0f);
+    std::fill(dampingRatio, dampingRatio + MAX_MATERIALS * MAX_MATERIALS, 0.0f);
+    std::fill(youngModulus, youngModulus + MAX_MATERIALS, 1e5f);
+    std::fill(poissonRatio, poissonRatio + MAX_MATERIALS, 0.3f);
+    for (int a = 0; a < MAX_MATERIALS; ++a) {
+        for (int b = 0; b <= a; ++b) {
+            setElasticPair(*this, a, b);
+        }
+    }
+}
+
+int addMaterial(MaterialTable& table, float restitution, float friction, float youngModulus, float poissonRatio) {
+    // Tablo doluyken son malzemeyi dndrmek onun ift deerlerini sessizce ezerdi
+    assert(table.count < MAX_MATERIALS && "malzeme tablosu dolu");
+    if (table.count >= MAX_MATERIALS) return -1;
+
+    int id = table.count++;
+    table.youngModulus[id] = youngModulus;
+    table.poissonRatio[id] = poissonRatio;
+    for (int other = 0; other < id; ++other) {
+        // Dier malzemenin kendi deerleri kegende durur
+        float otherRestitution = table.restitution[other * MAX_MATERIALS + other];
+        float otherFriction = table.friction[other * MAX_MATERIALS + other];
+        setMaterialPair(table, id, other, std::min(restitution, otherRestitution), std::sqrt(friction * otherFriction));
+        setElasticPair(table, id, other);
+    }
+    setMaterialPair(table, id, id, restitution, friction);
+    setElasticPair(table, id, id);
+    return id;
+}
+
+void setMaterialPair(MaterialTable& table, int a, int b, float restitution, float friction) {
+    table.restitution[a * MAX_MATERIALS + b] = restitution;
+    table.restitution[b * MAX_MATERIALS + a] = restitution;
+    table.friction[a * MAX_MATERIALS + b] = friction;
+    table.friction[b * MAX_MATERIALS + a] = friction;
+
+    // Tam esnek olmayan iftlerde yay-snmleyici snm oran; e = 0 iin kritik snm (-1)
+    const float pi = 3.14159265f;
+    float damping = -1.0f;
+    if (restitution > 0.0f) {
+        float logRestitution = std::log(std::min(restitution, 1.0f));
+        damping = logRestitution / std::sqrt(logRestitution * logRestitution + pi * pi);
+    }
+    table.dampingRatio[a * MAX_MATERIALS + b] = damping;
+    table.dampingRatio[b * MAX_MATERIALS + a] = damping;
+}
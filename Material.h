@@ -0,0 +1,32 @@
+#pragma once
+
+
+// Ayn anda tanmlanabilecek en fazla malzeme says
+const int MAX_MATERIALS = 16;
+
+// Malzeme iftlerinin arpma zellikleri. Tablolar simetrik ve dz dizi olarak tutulur,
+// [a * MAX_MATERIALS + b] indeksiyle SIMD ekirdeklerinde dallanmadan toplanabilir (gather).
+struct MaterialTable {
+    int count;
+    float restitution[MAX_MATERIALS * MAX_MATERIALS]; // Sekme katsays, 1 = tam esnek
+    float friction[MAX_MATERIALS * MAX_MATERIALS];    // Coulomb srtnme katsays
+
+    // Yumuak temas (DEM) iin esneklik zellikleri
+    float youngModulus[MAX_MATERIALS];
+    float poissonRatio[MAX_MATERIALS];
+    float effectiveYoung[MAX_MATERIALS * MAX_MATERIALS]; // E* = 1 / ((1 - v1^2) / E1 + (1 - v2^2) / E2)
+    float effectiveShear[MAX_MATERIALS * MAX_MATERIALS]; // G* = 1 / (2 (2 - v1)(1 + v1) / E1 + 2 (2 - v2)(1 + v2) / E2)
+    float dampingRatio[MAX_MATERIALS * MAX_MATERIALS];   // beta = ln e / sqrt(ln^2 e + pi^2), sekme katsaysndan
+
+    // 0 numaral varsaylan malzeme: tam esnek ve srtnmesiz
+    MaterialTable();
+};
+
+// Yeni malzeme ekler ve numarasn dndrr. Dier malzemelerle iftler kartrma kuralyla doldurulur:
+// sekme iin kk olan, srtnme iin geometrik ortalama; E* ve G* HertzMindlin kurallaryla.
+// Tablo doluysa (MAX_MATERIALS) hibir ey yazlmaz ve -1 dner.
+int addMaterial(MaterialTable& table, float restitution, float friction,
+    float youngModulus = 1e5f, float poissonRatio = 0.3f);
+
+// Belirli bir iftin zelliklerini iki ynde birden ayarlar
+void setMaterialPair(MaterialTable& table, int a, int b, float restitution, float friction);
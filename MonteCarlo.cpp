@@ -0,0 +1,268 @@
+#include "MonteCarlo.h"
+#include "Parallel.h"
+#include "Random.h"
+#include "Simulation.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace {
+
+// Komuluk kopyasndaki dolgu ve geici olarak karlan kreler bu uzaklkta durur; kare mesafe
+// sonsuza taar ve hibir akma snamasn gemez
+const float kFarAway = 1e30f;
+
+void loadMonteCarloState(MonteCarloState& mc, const std::vector<Sphere>& spheres) {
+    const size_t count = spheres.size();
+    if (mc.count != count) {
+        mc.count = count;
+        mc.step = 0.0f;
+        for (std::vector<float>* array : { &mc.positionX, &mc.positionY, &mc.positionZ, &mc.radius }) {
+            array->assign(count, 0.0f);
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        mc.positionX[i] = spheres[i].position.x;
+        mc.positionY[i] = spheres[i].position.y;
+        mc.positionZ[i] = spheres[i].position.z;
+        mc.radius[i] = spheres[i].radius;
+    }
+}
+
+// Izgara her taramada [0, cellSize) kadar rastgele kaydrlr; aksi halde hcre snrlar sabit
+// kalr ve hibir kre hcresinden kamazd
+void buildMonteCarloCells(MonteCarloState& mc, float cubeSize, const float shift[3]) {
+    const float half = cubeSize * 0.5f;
+    mc.originX = -half - shift[0] * mc.cellSize;
+    mc.originY = -half - shift[1] * mc.cellSize;
+    mc.originZ = -half - shift[2] * mc.cellSize;
+    mc.dimsX = static_cast<int>(std::ceil((half - mc.originX) / mc.cellSize)) + 1;
+    mc.dimsY = static_cast<int>(std::ceil((half - mc.originY) / mc.cellSize)) + 1;
+    mc.dimsZ = static_cast<int>(std::ceil((half - mc.originZ) / mc.cellSize)) + 1;
+    const int cells = mc.dimsX * mc.dimsY * mc.dimsZ;
+
+    mc.sphereCell.resize(mc.count);
+    mc.cellStart.assign(cells + 1, 0);
+    for (size_t i = 0; i < mc.count; ++i) {
+        int x = std::min(std::max(static_cast<int>((mc.positionX[i] - mc.originX) / mc.cellSize), 0), mc.dimsX - 1);
+        int y = std::min(std::max(static_cast<int>((mc.positionY[i] - mc.originY) / mc.cellSize), 0), mc.dimsY - 1);
+        int z = std::min(std::max(static_cast<int>((mc.positionZ[i] - mc.originZ) / mc.cellSize), 0), mc.dimsZ - 1);
+        int cell = (z * mc.dimsY + y) * mc.dimsX + x;
+        mc.sphereCell[i] = cell;
+        ++mc.cellStart[cell + 1];
+    }
+    for (int c = 0; c < cells; ++c) {
+        mc.cellStart[c + 1] += mc.cellStart[c];
+    }
+    mc.cellEntries.resize(mc.count);
+    std::vector<int> cursor(mc.cellStart.begin(), mc.cellStart.end() - 1);
+    for (size_t i = 0; i < mc.count; ++i) {
+        mc.cellEntries[cursor[mc.sphereCell[i]]++] = static_cast<int>(i);
+    }
+
+    // Tarama hcre srasna dizilmi kopya zerinde alr; sonular tarama sonunda geri datlr
+    for (std::vector<float>* array : { &mc.sortedX, &mc.sortedY, &mc.sortedZ, &mc.sortedRadius }) {
+        array->resize(mc.count);
+    }
+    for (size_t e = 0; e < mc.count; ++e) {
+        int i = mc.cellEntries[e];
+        mc.sortedX[e] = mc.positionX[i];
+        mc.sortedY[e] = mc.positionY[i];
+        mc.sortedZ[e] = mc.positionZ[i];
+        mc.sortedRadius[e] = mc.radius[i];
+    }
+
+    // Dama deseni: eksen bana ift/tek, 8 renk; bo hcreler listeye girmez
+    for (std::vector<int>& list : mc.colourCells) {
+        list.clear();
+    }
+    for (int z = 0; z < mc.dimsZ; ++z) {
+        for (int y = 0; y < mc.dimsY; ++y) {
+            for (int x = 0; x < mc.dimsX; ++x) {
+                int cell = (z * mc.dimsY + y) * mc.dimsX + x;
+                if (mc.cellStart[cell] == mc.cellStart[cell + 1]) continue;
+                mc.colourCells[(x & 1) | ((y & 1) << 1) | ((z & 1) << 2)].push_back(cell);
+            }
+        }
+    }
+}
+
+// Bir hcredeki her kre iin bir deneme. Hcrenin ve 26 komusunun kreleri nce i paracnn
+// SoA kopyasna alnr (hcrenin kendi kreleri bata); her deneme bu kopyaya 8'erli eritlerle snanr.
+long long sweepCell(MonteCarloState& mc, int cell, int thread, float halfCubeSize) {
+    std::vector<float>& bufferX = mc.threadX[thread];
+    std::vector<float>& bufferY = mc.threadY[thread];
+    std::vector<float>& bufferZ = mc.threadZ[thread];
+    std::vector<float>& bufferRadius = mc.threadRadius[thread];
+    bufferX.clear();
+    bufferY.clear();
+    bufferZ.clear();
+    bufferRadius.clear();
+
+    const int cx = cell % mc.dimsX;
+    const int cy = (cell / mc.dimsX) % mc.dimsY;
+    const int cz = cell / (mc.dimsX * mc.dimsY);
+    const int first = mc.cellStart[cell];
+    const int last = mc.cellStart[cell + 1];
+    auto append = [&](int begin, int end) {
+        bufferX.insert(bufferX.end(), mc.sortedX.begin() + begin, mc.sortedX.begin() + end);
+        bufferY.insert(bufferY.end(), mc.sortedY.begin() + begin, mc.sortedY.begin() + end);
+        bufferZ.insert(bufferZ.end(), mc.sortedZ.begin() + begin, mc.sortedZ.begin() + end);
+        bufferRadius.insert(bufferRadius.end(), mc.sortedRadius.begin() + begin, mc.sortedRadius.begin() + end);
+    };
+
+    // Sral dizilerde x ynndeki  komu hcre bitiiktir; komuluk dokuz aralk olarak kopyalanr
+    append(first, last);
+    const int lowCellX = std::max(cx - 1, 0), highCellX = std::min(cx + 1, mc.dimsX - 1);
+    for (int z = std::max(cz - 1, 0); z <= std::min(cz + 1, mc.dimsZ - 1); ++z) {
+        for (int y = std::max(cy - 1, 0); y <= std::min(cy + 1, mc.dimsY - 1); ++y) {
+            int row = (z * mc.dimsY + y) * mc.dimsX;
+            int begin = mc.cellStart[row + lowCellX];
+            int end = mc.cellStart[row + highCellX + 1];
+            if (y == cy && z == cz) {
+                append(begin, first);
+                append(last, end);
+            } else {
+                append(begin, end);
+            }
+        }
+    }
+    while (bufferX.size() % SIMD_WIDTH != 0) {
+        bufferX.push_back(kFarAway);
+        bufferY.push_back(kFarAway);
+        bufferZ.push_back(kFarAway);
+        bufferRadius.push_back(0.0f);
+    }
+    const size_t bufferSize = bufferX.size();
+
+    const float lowX = mc.originX + cx * mc.cellSize, lowY = mc.originY + cy * mc.cellSize, lowZ = mc.originZ + cz * mc.cellSize;
+    const int own = last - first;
+    long long accepted = 0;
+    alignas(32) float moves[3][SIMD_WIDTH];
+    alignas(32) int index[SIMD_WIDTH];
+
+    for (int k = 0; k < own; ++k) {
+        // Yer deitirmeler 8 kre iin birlikte retilir; saya krenin zgn indeksidir
+        if (k % SIMD_WIDTH == 0) {
+            for (int lane = 0; lane < SIMD_WIDTH; ++lane) {
+                index[lane] = mc.cellEntries[first + std::min(k + lane, own - 1)];
+            }
+            SimdPhilox random = simdRandomBits(simdLoadInt(index), mc.sweep, mc.settings.seed, RANDOM_STREAM_MONTE_CARLO);
+            SimdFloat scale = simdSet(2.0f * mc.step);
+            SimdFloat offset = simdSet(3.0f * mc.step);
+            for (int axis = 0; axis < 3; ++axis) {
+                simdStore(moves[axis], simdOneToTwo(random.word[axis]) * scale - offset);
+            }
+        }
+        int lane = k % SIMD_WIDTH;
+        float x = bufferX[k] + moves[0][lane];
+        float y = bufferY[k] + moves[1][lane];
+        float z = bufferZ[k] + moves[2][lane];
+        float r = bufferRadius[k];
+
+        // Hcre dna ya da kp dna kan deneme reddedilir
+        if (x < lowX || x >= lowX + mc.cellSize || y < lowY || y >= lowY + mc.cellSize || z < lowZ || z >= lowZ + mc.cellSize) continue;
+        if (std::abs(x) + r > halfCubeSize || std::abs(y) + r > halfCubeSize || std::abs(z) + r > halfCubeSize) continue;
+
+        // Sert kre Metropolis: akma yoksa kabul. Krenin kendisi snama sresince kopyadan karlr.
+        float oldX = bufferX[k];
+        bufferX[k] = kFarAway;
+        SimdFloat px = simdSet(x), py = simdSet(y), pz = simdSet(z), pr = simdSet(r);
+        bool overlap = false;
+        for (size_t b = 0; b < bufferSize && !overlap; b += SIMD_WIDTH) {
+            SimdFloat dx = simdLoad(&bufferX[b]) - px;
+            SimdFloat dy = simdLoad(&bufferY[b]) - py;
+            SimdFloat dz = simdLoad(&bufferZ[b]) - pz;
+            SimdFloat reach = simdLoad(&bufferRadius[b]) + pr;
+            overlap = simdMoveMask(simdLess(simdDot(dx, dy, dz, dx, dy, dz), reach * reach)) != 0;
+        }
+        if (overlap) {
+            bufferX[k] = oldX;
+            continue;
+        }
+
+        bufferX[k] = x;
+        bufferY[k] = y;
+        bufferZ[k] = z;
+        mc.sortedX[first + k] = x;
+        mc.sortedY[first + k] = y;
+        mc.sortedZ[first + k] = z;
+        ++accepted;
+    }
+    return accepted;
+}
+
+void sweepMonteCarlo(MonteCarloState& mc, float cubeSize) {
+    // Izgara kaymas da ayn sayatan, kre indeksleriyle akmayan -1 eridinden gelir
+    SimdPhilox random = simdRandomBits(simdSetInt(-1), mc.sweep, mc.settings.seed, RANDOM_STREAM_MONTE_CARLO);
+    alignas(32) float shift[3][SIMD_WIDTH];
+    for (int axis = 0; axis < 3; ++axis) {
+        simdStore(shift[axis], simdOneToTwo(random.word[axis]) - simdSet(1.0f));
+    }
+    const float cellShift[3] = { shift[0][0], shift[1][0], shift[2][0] };
+    buildMonteCarloCells(mc, cubeSize, cellShift);
+
+    std::fill(mc.threadAccepted.begin(), mc.threadAccepted.end(), 0);
+    for (const std::vector<int>& cells : mc.colourCells) {
+        parallelFor(cells.size(), [&](size_t begin, size_t end, int thread) {
+            long long accepted = 0;
+            for (size_t c = begin; c < end; ++c) {
+                accepted += sweepCell(mc, cells[c], thread, cubeSize * 0.5f);
+            }
+            mc.threadAccepted[thread] += accepted;
+        }, 16);
+    }
+    for (size_t e = 0; e < mc.count; ++e) {
+        int i = mc.cellEntries[e];
+        mc.positionX[i] = mc.sortedX[e];
+        mc.positionY[i] = mc.sortedY[e];
+        mc.positionZ[i] = mc.sortedZ[e];
+    }
+
+    long long accepted = 0;
+    for (long long value : mc.threadAccepted) {
+        accepted += value;
+    }
+    mc.trials += static_cast<long long>(mc.count);
+    mc.accepted += accepted;
+    mc.lastAcceptance = static_cast<float>(accepted) / static_cast<float>(mc.count);
+
+    // Kabul oran hedefin stndeyse adm byr, altndaysa klr; hcre boyunun yarsn amaz
+    mc.step *= mc.lastAcceptance > mc.settings.targetAcceptance ? 1.05f : 0.95f;
+    mc.step = std::min(mc.step, 0.5f * mc.cellSize);
+    ++mc.sweep;
+}
+
+} // namespace
+
+
+void updateMonteCarloSimulation(std::vector<Sphere>& spheres, float cubeSize, SimulationContext& context) {
+    MonteCarloState& mc = context.monteCarlo;
+    if (spheres.empty()) return;
+    loadMonteCarloState(mc, spheres);
+
+    float smallest = spheres[0].radius, largest = spheres[0].radius;
+    for (const Sphere& sphere : spheres) {
+        smallest = std::min(smallest, sphere.radius);
+        largest = std::max(largest, sphere.radius);
+    }
+    mc.cellSize = 2.0f * largest * std::max(mc.settings.cellScale, 1.0f);
+    if (mc.step <= 0.0f) {
+        mc.step = mc.settings.initialStep * smallest;
+    }
+
+    const int threads = parallelThreadCount();
+    for (std::vector<std::vector<float>>* buffers : { &mc.threadX, &mc.threadY, &mc.threadZ, &mc.threadRadius }) {
+        buffers->resize(threads);
+    }
+    mc.threadAccepted.resize(threads);
+
+    for (int s = 0; s < mc.settings.sweepsPerFrame; ++s) {
+        sweepMonteCarlo(mc, cubeSize);
+    }
+
+    for (size_t i = 0; i < spheres.size(); ++i) {
+        spheres[i].position = glm::vec3(mc.positionX[i], mc.positionY[i], mc.positionZ[i]);
+    }
+}
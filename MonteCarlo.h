@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Sphere.h"
+#include <cstdint>
+#include <vector>
+
+
+struct SimulationContext;
+
+struct MonteCarloSettings {
+    int sweepsPerFrame = 10;        // Kare bana her kre iin deneme says
+    float targetAcceptance = 0.3f;  // Adm boyu bu kabul oranna doru ayarlanr
+    float initialStep = 0.2f;       // lk adm boyu, en kk yarapn kat
+    float cellScale = 3.0f;         // Hcre boyu, en byk apn kat (>= 1); byk hcre kopyalama maliyetini bler
+    uint32_t seed = 20240612u;
+};
+
+// Sert kre Metropolis rnekleyicisinin durumu. Hcreler en byk aptan kk olmaz ve her
+// taramada rastgele kaydrlr; hcre dna kan denemeler reddedilir, bylece ayn renkteki
+// (arada bir hcre bulunan) hcreler birbirini grmeden paralel ilenebilir.
+struct MonteCarloState {
+    MonteCarloSettings settings;
+    float step = 0.0f;  // Deneme yer deitirmesinin eksen bana en byk deeri
+    uint64_t sweep = 0; // Rastgele say sayacnn adm kelimesi
+
+    size_t count = 0;
+    std::vector<float> positionX, positionY, positionZ, radius;
+
+    float cellSize = 0.0f;
+    float originX = 0.0f, originY = 0.0f, originZ = 0.0f;
+    int dimsX = 0, dimsY = 0, dimsZ = 0;
+    std::vector<int> cellStart, cellEntries, sphereCell;
+    std::vector<float> sortedX, sortedY, sortedZ, sortedRadius; // Hcre srasnda konumlar
+    std::vector<int> colourCells[8];
+
+    //  parac bana 27 hcrelik komuluk kopyas (SoA) ve sayalar
+    std::vector<std::vector<float>> threadX, threadY, threadZ, threadRadius;
+    std::vector<long long> threadAccepted;
+
+    // statistikler
+    long long trials = 0;
+    long long accepted = 0;
+    float lastAcceptance = 0.0f;
+};
+
+// Kare bana settings.sweepsPerFrame tarama yapar; kre konumlar rneklenmi yaplandrmayla deiir,
+// hzlara dokunulmaz. Balang yaplandrmas akmasz olmaldr.
+void updateMonteCarloSimulation(std::vector<Sphere>& spheres, float cubeSize, SimulationContext& context);
@@ -0,0 +1,967 @@
+#include "NarrowPhase.h"
+#include "Simd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+
+namespace {
+
+// Sphere dizisini dz float dizisi olarak okuyan SIMD toplamalar iin alan konumlar
+const int kSphereStride = sizeof(Sphere) / sizeof(float);
+const int kPositionX = offsetof(Sphere, position) / sizeof(float);
+const int kRadius = offsetof(Sphere, radius) / sizeof(float);
+const int kVelocityX = offsetof(Sphere, velocity) / sizeof(float);
+const int kMaterial = offsetof(Sphere, material) / sizeof(float);
+
+// Kat krelerde temas noktasndaki teet etkin ters ktle: (1/m)(1 + r^2 m / I) = 3.5 / m
+const float kSphereTangentFactor = 1.0f + 1.0f / SPHERE_INERTIA_FACTOR;
+
+const int kPairTypeTable[SHAPE_TYPE_COUNT][SHAPE_TYPE_COUNT] = {
+    { PAIR_SPHERE_SPHERE, PAIR_SPHERE_MEMBER, PAIR_SPHERE_CAPSULE, PAIR_SPHERE_BOX },
+    { PAIR_SPHERE_MEMBER, PAIR_MEMBER_MEMBER, PAIR_MEMBER_CAPSULE, PAIR_MEMBER_BOX },
+    { PAIR_SPHERE_CAPSULE, PAIR_MEMBER_CAPSULE, PAIR_CAPSULE_CAPSULE, PAIR_CAPSULE_BOX },
+    { PAIR_SPHERE_BOX, PAIR_MEMBER_BOX, PAIR_CAPSULE_BOX, PAIR_BOX_BOX },
+};
+
+struct SphereLanes {
+    SimdFloat x, y, z, radius;
+    SimdFloat velocityX, velocityY, velocityZ;
+    SimdFloat angularX, angularY, angularZ;
+    SimdFloat inverseMass;
+    SimdInt material;
+};
+
+struct BodyLanes {
+    SimdFloat x, y, z;
+    SimdFloat velocityX, velocityY, velocityZ;
+    SimdFloat inverseMass;
+    SimdInt material;
+};
+
+struct CapsuleLanes {
+    BodyLanes body;
+    SimdFloat axisX, axisY, axisZ, radius;
+};
+
+struct BoxLanes {
+    BodyLanes body;
+    SimdFloat axis[3][3];
+    SimdFloat half[3];
+};
+
+// Temas eden eritlerin itmeleri ve salm iin gereken katsaylar
+struct ContactLanes {
+    SimdFloat contact;
+    SimdFloat nx, ny, nz;
+    SimdFloat jx, jy, jz;
+};
+
+SphereLanes loadSpheres(const std::vector<Sphere>& spheres, const RotationState& rotation, SimdInt index) {
+    const float* base = reinterpret_cast<const float*>(spheres.data());
+    const int* materialBase = reinterpret_cast<const int*>(spheres.data());
+    SimdInt a = index * simdSetInt(kSphereStride);
+
+    SphereLanes lanes;
+    lanes.x = simdGather(base + kPositionX, a);
+    lanes.y = simdGather(base + kPositionX + 1, a);
+    lanes.z = simdGather(base + kPositionX + 2, a);
+    lanes.radius = simdGather(base + kRadius, a);
+    lanes.velocityX = simdGather(base + kVelocityX, a);
+    lanes.velocityY = simdGather(base + kVelocityX + 1, a);
+    lanes.velocityZ = simdGather(base + kVelocityX + 2, a);
+    lanes.angularX = simdGather(rotation.angularX.data(), index);
+    lanes.angularY = simdGather(rotation.angularY.data(), index);
+    lanes.angularZ = simdGather(rotation.angularZ.data(), index);
+    lanes.inverseMass = simdSet(1.0f) / (lanes.radius * lanes.radius * lanes.radius);
+    lanes.material = simdGatherInt(materialBase + kMaterial, a);
+    return lanes;
+}
+
+BodyLanes loadBody(const ShapeArrays& arrays, SimdInt index) {
+    BodyLanes lanes;
+    lanes.x = simdGather(arrays.x.data(), index);
+    lanes.y = simdGather(arrays.y.data(), index);
+    lanes.z = simdGather(arrays.z.data(), index);
+    lanes.velocityX = simdGather(arrays.velocityX.data(), index);
+    lanes.velocityY = simdGather(arrays.velocityY.data(), index);
+    lanes.velocityZ = simdGather(arrays.velocityZ.data(), index);
+    lanes.inverseMass = simdGather(arrays.inverseMass.data(), index);
+    lanes.material = simdGatherInt(arrays.material.data(), index);
+    return lanes;
+}
+
+CapsuleLanes loadCapsules(const CapsuleArrays& arrays, SimdInt index) {
+    CapsuleLanes lanes;
+    lanes.body = loadBody(arrays.body, index);
+    lanes.axisX = simdGather(arrays.axisX.data(), index);
+    lanes.axisY = simdGather(arrays.axisY.data(), index);
+    lanes.axisZ = simdGather(arrays.axisZ.data(), index);
+    lanes.radius = simdGather(arrays.radius.data(), index);
+    return lanes;
+}
+
+BoxLanes loadBoxes(const BoxArrays& arrays, SimdInt index) {
+    BoxLanes lanes;
+    lanes.body = loadBody(arrays.body, index);
+    for (int k = 0; k < 3; ++k) {
+        for (int j = 0; j < 3; ++j) {
+            lanes.axis[k][j] = simdGather(arrays.axis[3 * k + j].data(), index);
+        }
+    }
+    lanes.half[0] = simdGather(arrays.halfX.data(), index);
+    lanes.half[1] = simdGather(arrays.halfY.data(), index);
+    lanes.half[2] = simdGather(arrays.halfZ.data(), index);
+    return lanes;
+}
+
+// Kovann sonundaki dolgu iftlerini eleyen erit maskesi
+SimdFloat validLanes(const CandidatePairs& pairs, size_t p) {
+    return simdLess(simdLaneIndex(), simdSet(static_cast<float>(pairs.count - static_cast<int>(p))));
+}
+
+// n: A'dan B'ye birim normal, (cx, cy, cz): temas noktasnda B'nin A'ya gre hz.
+// Normal itme -(1 + e) vn / (1/mA + 1/mB); srtnme Coulomb snryla kaymay durduracak kadar.
+// A'ya -J, B'ye +J uygulanr; birbirinden uzaklaan eritler maskeden der.
+void computeContactImpulse(ContactLanes& lanes, SimdFloat cx, SimdFloat cy, SimdFloat cz,
+    SimdFloat normalInverseMass, SimdFloat tangentInverseMass, SimdFloat restitution, SimdFloat friction) {
+    const SimdFloat zero = simdSet(0.0f);
+    SimdFloat normalSpeed = simdDot(cx, cy, cz, lanes.nx, lanes.ny, lanes.nz);
+    lanes.contact = simdAnd(lanes.contact, simdLess(normalSpeed, zero));
+    lanes.contact = simdAnd(lanes.contact, simdGreater(normalInverseMass, zero));
+
+    SimdFloat safeInverseMass = simdMax(normalInverseMass, simdSet(1e-20f));
+    SimdFloat normalImpulse = (zero - (simdSet(1.0f) + restitution) * normalSpeed) / safeInverseMass;
+
+    SimdFloat tx = cx - normalSpeed * lanes.nx;
+    SimdFloat ty = cy - normalSpeed * lanes.ny;
+    SimdFloat tz = cz - normalSpeed * lanes.nz;
+    SimdFloat tangentSpeed = simdSqrt(simdDot(tx, ty, tz, tx, ty, tz));
+    SimdFloat frictionImpulse = simdMin(friction * normalImpulse, tangentSpeed / simdMax(tangentInverseMass, simdSet(1e-20f)));
+    SimdFloat tangentScale = simdSelect(simdGreater(tangentSpeed, simdSet(1e-12f)), frictionImpulse / tangentSpeed, zero);
+
+    lanes.jx = simdSelect(lanes.contact, normalImpulse * lanes.nx - tangentScale * tx, zero);
+    lanes.jy = simdSelect(lanes.contact, normalImpulse * lanes.ny - tangentScale * ty, zero);
+    lanes.jz = simdSelect(lanes.contact, normalImpulse * lanes.nz - tangentScale * tz, zero);
+}
+
+void normalize(SimdFloat& x, SimdFloat& y, SimdFloat& z, SimdFloat length2) {
+    SimdFloat inverseLength = simdSet(1.0f) / simdSqrt(simdMax(length2, simdSet(1e-20f)));
+    x = x * inverseLength;
+    y = y * inverseLength;
+    z = z * inverseLength;
+}
+
+// Merkezi c, yar ekseni h olan doru paras zerinde p'ye en yakn noktann parametresi, [-1, 1]
+SimdFloat segmentParameter(SimdFloat px, SimdFloat py, SimdFloat pz, const CapsuleLanes& capsule) {
+    SimdFloat along = simdDot(px - capsule.body.x, py - capsule.body.y, pz - capsule.body.z, capsule.axisX, capsule.axisY, capsule.axisZ);
+    SimdFloat length2 = simdDot(capsule.axisX, capsule.axisY, capsule.axisZ, capsule.axisX, capsule.axisY, capsule.axisZ);
+    return simdClamp(along / simdMax(length2, simdSet(1e-12f)), simdSet(-1.0f), simdSet(1.0f));
+}
+
+// Kutu iindeki (yzeyi dahil) p'ye en yakn nokta
+void closestPointOnBox(const BoxLanes& box, SimdFloat px, SimdFloat py, SimdFloat pz,
+    SimdFloat& qx, SimdFloat& qy, SimdFloat& qz) {
+    SimdFloat dx = px - box.body.x;
+    SimdFloat dy = py - box.body.y;
+    SimdFloat dz = pz - box.body.z;
+    qx = box.body.x;
+    qy = box.body.y;
+    qz = box.body.z;
+    for (int k = 0; k < 3; ++k) {
+        SimdFloat local = simdDot(dx, dy, dz, box.axis[k][0], box.axis[k][1], box.axis[k][2]);
+        SimdFloat clamped = simdClamp(local, simdSet(0.0f) - box.half[k], box.half[k]);
+        qx = qx + clamped * box.axis[k][0];
+        qy = qy + clamped * box.axis[k][1];
+        qz = qz + clamped * box.axis[k][2];
+    }
+}
+
+// p merkezli, r yarapl bir kre (A) ile kutu (B) temas. Merkez kutunun iindeyse
+// normal en yakn yzn ters yndr, bylece kre o yzden dar itilir.
+void sphereBoxContact(const BoxLanes& box, SimdFloat px, SimdFloat py, SimdFloat pz, SimdFloat radius, ContactLanes& lanes) {
+    const SimdFloat zero = simdSet(0.0f);
+    SimdFloat dx = px - box.body.x;
+    SimdFloat dy = py - box.body.y;
+    SimdFloat dz = pz - box.body.z;
+
+    SimdFloat qx = box.body.x, qy = box.body.y, qz = box.body.z;
+    SimdFloat bestMargin = simdSet(1e30f);
+    SimdFloat faceX = zero, faceY = zero, faceZ = zero;
+    for (int k = 0; k < 3; ++k) {
+        SimdFloat local = simdDot(dx, dy, dz, box.axis[k][0], box.axis[k][1], box.axis[k][2]);
+        SimdFloat clamped = simdClamp(local, zero - box.half[k], box.half[k]);
+        qx = qx + clamped * box.axis[k][0];
+        qy = qy + clamped * box.axis[k][1];
+        qz = qz + clamped * box.axis[k][2];
+
+        SimdFloat margin = box.half[k] - simdAbs(local);
+        SimdFloat sign = simdSelect(simdLess(local, zero), simdSet(1.0f), simdSet(-1.0f));
+        SimdFloat closer = simdLess(margin, bestMargin);
+        bestMargin = simdSelect(closer, margin, bestMargin);
+        faceX = simdSelect(closer, sign * box.axis[k][0], faceX);
+        faceY = simdSelect(closer, sign * box.axis[k][1], faceY);
+        faceZ = simdSelect(closer, sign * box.axis[k][2], faceZ);
+    }
+
+    SimdFloat ox = qx - px;
+    SimdFloat oy = qy - py;
+    SimdFloat oz = qz - pz;
+    SimdFloat distance2 = simdDot(ox, oy, oz, ox, oy, oz);
+    SimdFloat inside = simdLess(distance2, simdSet(1e-12f));
+    normalize(ox, oy, oz, distance2);
+
+    lanes.contact = simdAnd(lanes.contact, simdOr(simdLess(distance2, radius * radius), inside));
+    lanes.nx = simdSelect(inside, faceX, ox);
+    lanes.ny = simdSelect(inside, faceY, oy);
+    lanes.nz = simdSelect(inside, faceZ, oz);
+}
+
+// Kutu-kutu ayrc eksen testinin tek ekseni: en kk rtme ve onun normali tutulur.
+// Yan yana yzlerde kenar eksenlerinin yz eksenlerini gereksiz yere gememesi iin bias eklenir.
+void testSeparatingAxis(const BoxLanes& a, const BoxLanes& b, SimdFloat tx, SimdFloat ty, SimdFloat tz,
+    SimdFloat lx, SimdFloat ly, SimdFloat lz, SimdFloat bias,
+    SimdFloat& bestOverlap, SimdFloat& nx, SimdFloat& ny, SimdFloat& nz) {
+    const SimdFloat zero = simdSet(0.0f);
+    SimdFloat length2 = simdDot(lx, ly, lz, lx, ly, lz);
+    SimdFloat usable = simdGreater(length2, simdSet(1e-10f));
+
+    SimdFloat projection = zero;
+    for (int k = 0; k < 3; ++k) {
+        projection = projection + a.half[k] * simdAbs(simdDot(a.axis[k][0], a.axis[k][1], a.axis[k][2], lx, ly, lz));
+        projection = projection + b.half[k] * simdAbs(simdDot(b.axis[k][0], b.axis[k][1], b.axis[k][2], lx, ly, lz));
+    }
+    SimdFloat separation = simdDot(tx, ty, tz, lx, ly, lz);
+    SimdFloat inverseLength = simdSet(1.0f) / simdSqrt(simdMax(length2, simdSet(1e-10f)));
+    SimdFloat overlap = (projection - simdAbs(separation)) * inverseLength;
+
+    SimdFloat better = simdAnd(usable, simdLess(overlap + bias, bestOverlap));
+    SimdFloat scale = simdSelect(simdLess(separation, zero), zero - inverseLength, inverseLength);
+    bestOverlap = simdSelect(better, overlap, bestOverlap);
+    nx = simdSelect(better, lx * scale, nx);
+    ny = simdSelect(better, ly * scale, ny);
+    nz = simdSelect(better, lz * scale, nz);
+}
+
+void applyBodyImpulse(ShapeArrays& arrays, int index, const glm::vec3& impulse) {
+    float inverseMass = arrays.inverseMass[index];
+    arrays.velocityX[index] += impulse.x * inverseMass;
+    arrays.velocityY[index] += impulse.y * inverseMass;
+    arrays.velocityZ[index] += impulse.z * inverseMass;
+}
+
+// Salm iin erit deerlerini diziye indirir
+struct ContactStore {
+    alignas(32) float nx[SIMD_WIDTH], ny[SIMD_WIDTH], nz[SIMD_WIDTH];
+    alignas(32) float jx[SIMD_WIDTH], jy[SIMD_WIDTH], jz[SIMD_WIDTH];
+    int mask;
+
+    explicit ContactStore(const ContactLanes& lanes) {
+        simdStore(nx, lanes.nx);
+        simdStore(ny, lanes.ny);
+        simdStore(nz, lanes.nz);
+        simdStore(jx, lanes.jx);
+        simdStore(jy, lanes.jy);
+        simdStore(jz, lanes.jz);
+        mask = simdMoveMask(lanes.contact);
+    }
+
+    glm::vec3 normal(int lane) const { return glm::vec3(nx[lane], ny[lane], nz[lane]); }
+    glm::vec3 impulse(int lane) const { return glm::vec3(jx[lane], jy[lane], jz[lane]); }
+};
+
+// Yuvarlak cisim (kre veya gvde yesi) ya da teleme yapan ekil iin temas tepkisinde gereken
+// kat cisim durumu. Temas kresi (x, y, z, radius), itmenin kolu ise ktle merkezinden llr.
+struct RigidLanes {
+    SimdFloat x, y, z, radius;
+    SimdFloat centerX, centerY, centerZ;
+    SimdFloat velocityX, velocityY, velocityZ;
+    SimdFloat angularX, angularY, angularZ;
+    SimdFloat inverseMass;
+    SimdFloat inverseInertia[9]; // Dnya erevesinde, satr dzeninde
+    SimdInt material;
+};
+
+// Dnmeyen ekiller: eylemsizlik ve asal hz terimleri sfr
+RigidLanes translatingBody(const BodyLanes& body) {
+    const SimdFloat zero = simdSet(0.0f);
+    RigidLanes lanes;
+    lanes.x = lanes.centerX = body.x;
+    lanes.y = lanes.centerY = body.y;
+    lanes.z = lanes.centerZ = body.z;
+    lanes.radius = zero;
+    lanes.velocityX = body.velocityX;
+    lanes.velocityY = body.velocityY;
+    lanes.velocityZ = body.velocityZ;
+    lanes.angularX = lanes.angularY = lanes.angularZ = zero;
+    lanes.inverseMass = body.inverseMass;
+    for (SimdFloat& element : lanes.inverseInertia) {
+        element = zero;
+    }
+    lanes.material = body.material;
+    return lanes;
+}
+
+// ift taraflarnn toplama ve salm kurallar; ekirdekler bunlar zerinden ablonlanr,
+// bylece kre ve gvde yesi ayn geometri kodunu paylar ve erit bana sanal ar olmaz.
+struct SphereSide {
+    std::vector<Sphere>& spheres;
+    RotationState& rotation;
+
+    RigidLanes load(SimdInt index) const {
+        SphereLanes sphere = loadSpheres(spheres, rotation, index);
+        const SimdFloat zero = simdSet(0.0f);
+        RigidLanes lanes;
+        lanes.x = lanes.centerX = sphere.x;
+        lanes.y = lanes.centerY = sphere.y;
+        lanes.z = lanes.centerZ = sphere.z;
+        lanes.radius = sphere.radius;
+        lanes.velocityX = sphere.velocityX;
+        lanes.velocityY = sphere.velocityY;
+        lanes.velocityZ = sphere.velocityZ;
+        lanes.angularX = sphere.angularX;
+        lanes.angularY = sphere.angularY;
+        lanes.angularZ = sphere.angularZ;
+        lanes.inverseMass = sphere.inverseMass;
+        SimdFloat inverseInertia = sphere.inverseMass / (simdSet(SPHERE_INERTIA_FACTOR) * sphere.radius * sphere.radius);
+        for (int k = 0; k < 9; ++k) {
+            lanes.inverseInertia[k] = k % 4 == 0 ? inverseInertia : zero;
+        }
+        lanes.material = sphere.material;
+        return lanes;
+    }
+
+    void apply(int index, const glm::vec3& point, const glm::vec3& impulse) const {
+        Sphere& sphere = spheres[index];
+        float inverseMass = 1.0f / sphereMass(sphere.radius);
+        sphere.velocity += impulse * inverseMass;
+        float spin = inverseMass / (SPHERE_INERTIA_FACTOR * sphere.radius * sphere.radius);
+        addAngularVelocity(rotation, index, glm::cross(point - sphere.position, impulse) * spin);
+    }
+};
+
+struct MemberSide {
+    ClumpSystem& clumps;
+
+    RigidLanes load(SimdInt index) const {
+        SimdInt body = simdGatherInt(clumps.owner.data(), index);
+        RigidLanes lanes;
+        lanes.x = simdGather(clumps.worldX.data(), index);
+        lanes.y = simdGather(clumps.worldY.data(), index);
+        lanes.z = simdGather(clumps.worldZ.data(), index);
+        lanes.radius = simdGather(clumps.memberRadius.data(), index);
+        lanes.centerX = simdGather(clumps.positionX.data(), body);
+        lanes.centerY = simdGather(clumps.positionY.data(), body);
+        lanes.centerZ = simdGather(clumps.positionZ.data(), body);
+        lanes.velocityX = simdGather(clumps.velocityX.data(), body);
+        lanes.velocityY = simdGather(clumps.velocityY.data(), body);
+        lanes.velocityZ = simdGather(clumps.velocityZ.data(), body);
+        lanes.angularX = simdGather(clumps.rotation.angularX.data(), body);
+        lanes.angularY = simdGather(clumps.rotation.angularY.data(), body);
+        lanes.angularZ = simdGather(clumps.rotation.angularZ.data(), body);
+        lanes.inverseMass = simdGather(clumps.inverseMass.data(), body);
+        for (int k = 0; k < 9; ++k) {
+            lanes.inverseInertia[k] = simdGather(clumps.inverseInertia[k].data(), body);
+        }
+        lanes.material = simdGatherInt(clumps.material.data(), body);
+        return lanes;
+    }
+
+    void apply(int index, const glm::vec3& point, const glm::vec3& impulse) const {
+        applyClumpImpulse(clumps, clumps.owner[index], point, impulse);
+    }
+};
+
+// (l x d) . I^-1 (l x d): d ynndeki itmenin dnme yoluyla ekledii ters ktle
+SimdFloat angularInverseMass(const RigidLanes& body, SimdFloat lx, SimdFloat ly, SimdFloat lz,
+    SimdFloat dx, SimdFloat dy, SimdFloat dz) {
+    SimdFloat ax = ly * dz - lz * dy;
+    SimdFloat ay = lz * dx - lx * dz;
+    SimdFloat az = lx * dy - ly * dx;
+    const SimdFloat* m = body.inverseInertia;
+    return simdDot(ax, ay, az,
+        m[0] * ax + m[1] * ay + m[2] * az,
+        m[3] * ax + m[4] * ay + m[5] * az,
+        m[6] * ax + m[7] * ay + m[8] * az);
+}
+
+// Temas noktas p'de iki kat cisim arasndaki itme. Normal ve teet etkin ktleleri kollar
+// ve eylemsizlik tensrlerini ierir; krelerde computeContactImpulse ile ayn sonucu verir.
+void computeRigidContactImpulse(ContactLanes& lanes, const RigidLanes& a, const RigidLanes& b,
+    SimdFloat px, SimdFloat py, SimdFloat pz, SimdFloat restitution, SimdFloat friction) {
+    const SimdFloat zero = simdSet(0.0f);
+    const SimdFloat tiny = simdSet(1e-20f);
+    SimdFloat lax = px - a.centerX, lay = py - a.centerY, laz = pz - a.centerZ;
+    SimdFloat lbx = px - b.centerX, lby = py - b.centerY, lbz = pz - b.centerZ;
+
+    // Temas noktasnda B'nin A'ya gre hz: (vB + wB x lB) - (vA + wA x lA)
+    SimdFloat cx = b.velocityX + (b.angularY * lbz - b.angularZ * lby) - a.velocityX - (a.angularY * laz - a.angularZ * lay);
+    SimdFloat cy = b.velocityY + (b.angularZ * lbx - b.angularX * lbz) - a.velocityY - (a.angularZ * lax - a.angularX * laz);
+    SimdFloat cz = b.velocityZ + (b.angularX * lby - b.angularY * lbx) - a.velocityZ - (a.angularX * lay - a.angularY * lax);
+    SimdFloat normalSpeed = simdDot(cx, cy, cz, lanes.nx, lanes.ny, lanes.nz);
+    lanes.contact = simdAnd(lanes.contact, simdLess(normalSpeed, zero));
+
+    SimdFloat linearInverseMass = a.inverseMass + b.inverseMass;
+    SimdFloat normalInverseMass = linearInverseMass
+        + angularInverseMass(a, lax, lay, laz, lanes.nx, lanes.ny, lanes.nz)
+        + angularInverseMass(b, lbx, lby, lbz, lanes.nx, lanes.ny, lanes.nz);
+    lanes.contact = simdAnd(lanes.contact, simdGreater(normalInverseMass, zero));
+    SimdFloat normalImpulse = (zero - (simdSet(1.0f) + restitution) * normalSpeed) / simdMax(normalInverseMass, tiny);
+
+    SimdFloat tx = cx - normalSpeed * lanes.nx;
+    SimdFloat ty = cy - normalSpeed * lanes.ny;
+    SimdFloat tz = cz - normalSpeed * lanes.nz;
+    SimdFloat tangentSpeed = simdSqrt(simdDot(tx, ty, tz, tx, ty, tz));
+    SimdFloat inverseTangent = simdSelect(simdGreater(tangentSpeed, simdSet(1e-12f)), simdSet(1.0f) / tangentSpeed, zero);
+    SimdFloat ux = tx * inverseTangent, uy = ty * inverseTangent, uz = tz * inverseTangent;
+    SimdFloat tangentInverseMass = linearInverseMass
+        + angularInverseMass(a, lax, lay, laz, ux, uy, uz)
+        + angularInverseMass(b, lbx, lby, lbz, ux, uy, uz);
+    SimdFloat frictionImpulse = simdMin(friction * normalImpulse, tangentSpeed / simdMax(tangentInverseMass, tiny));
+
+    lanes.jx = simdSelect(lanes.contact, normalImpulse * lanes.nx - frictionImpulse * ux, zero);
+    lanes.jy = simdSelect(lanes.contact, normalImpulse * lanes.ny - frictionImpulse * uy, zero);
+    lanes.jz = simdSelect(lanes.contact, normalImpulse * lanes.nz - frictionImpulse * uz, zero);
+}
+
+// Temas noktas A'nn yzeyinde, A merkezinden n ynnde radius uzaklkta alnr
+template <typename SideA, typename ApplyB>
+void scatterRigidContacts(const SideA& sideA, ApplyB applyB, const ContactLanes& lanes, const RigidLanes& a,
+    const CandidatePairs& pairs, size_t p) {
+    alignas(32) float pointX[SIMD_WIDTH], pointY[SIMD_WIDTH], pointZ[SIMD_WIDTH];
+    simdStore(pointX, a.x + a.radius * lanes.nx);
+    simdStore(pointY, a.y + a.radius * lanes.ny);
+    simdStore(pointZ, a.z + a.radius * lanes.nz);
+    ContactStore store(lanes);
+    for (int lane = 0; lane < SIMD_WIDTH; ++lane) {
+        if ((store.mask & (1 << lane)) == 0) continue;
+        glm::vec3 point(pointX[lane], pointY[lane], pointZ[lane]);
+        glm::vec3 impulse = store.impulse(lane);
+        sideA.apply(pairs.first[p + lane], point, -impulse);
+        applyB(pairs.second[p + lane], point, impulse);
+    }
+}
+
+// Yuvarlak-yuvarlak: kre-ye ve ye-ye (ayn gvdenin yeleri kovalamada elenir)
+template <typename SideA, typename SideB>
+void resolveRoundRoundPairs(const SideA& sideA, const SideB& sideB, const CandidatePairs& pairs, const MaterialTable& materials) {
+    const SimdInt materialRow = simdSetInt(MAX_MATERIALS);
+    const SimdFloat zero = simdSet(0.0f);
+
+    for (size_t p = 0; p < pairs.first.size(); p += SIMD_WIDTH) {
+        RigidLanes a = sideA.load(simdLoadInt(&pairs.first[p]));
+        RigidLanes b = sideB.load(simdLoadInt(&pairs.second[p]));
+
+        ContactLanes lanes;
+        lanes.nx = b.x - a.x;
+        lanes.ny = b.y - a.y;
+        lanes.nz = b.z - a.z;
+        SimdFloat distance2 = simdDot(lanes.nx, lanes.ny, lanes.nz, lanes.nx, lanes.ny, lanes.nz);
+        SimdFloat radiusSum = a.radius + b.radius;
+        lanes.contact = simdAnd(validLanes(pairs, p), simdLess(distance2, radiusSum * radiusSum));
+        lanes.contact = simdAnd(lanes.contact, simdGreater(distance2, zero));
+        if (simdMoveMask(lanes.contact) == 0) continue;
+        normalize(lanes.nx, lanes.ny, lanes.nz, distance2);
+
+        SimdInt pairIndex = a.material * materialRow + b.material;
+        computeRigidContactImpulse(lanes, a, b, a.x + a.radius * lanes.nx, a.y + a.radius * lanes.ny, a.z + a.radius * lanes.nz,
+            simdGather(materials.restitution, pairIndex), simdGather(materials.friction, pairIndex));
+        scatterRigidContacts(sideA, [&](int index, const glm::vec3& point, const glm::vec3& impulse) { sideB.apply(index, point, impulse); },
+            lanes, a, pairs, p);
+    }
+}
+
+template <typename SideA>
+void resolveRoundCapsulePairs(const SideA& sideA, CapsuleArrays& capsules, const CandidatePairs& pairs, const MaterialTable& materials) {
+    const SimdInt materialRow = simdSetInt(MAX_MATERIALS);
+
+    for (size_t p = 0; p < pairs.first.size(); p += SIMD_WIDTH) {
+        RigidLanes a = sideA.load(simdLoadInt(&pairs.first[p]));
+        CapsuleLanes capsule = loadCapsules(capsules, simdLoadInt(&pairs.second[p]));
+
+        // Kapsl ekseni zerinde temas kresinin merkezine en yakn nokta
+        SimdFloat t = segmentParameter(a.x, a.y, a.z, capsule);
+        ContactLanes lanes;
+        lanes.nx = capsule.body.x + t * capsule.axisX - a.x;
+        lanes.ny = capsule.body.y + t * capsule.axisY - a.y;
+        lanes.nz = capsule.body.z + t * capsule.axisZ - a.z;
+        SimdFloat distance2 = simdDot(lanes.nx, lanes.ny, lanes.nz, lanes.nx, lanes.ny, lanes.nz);
+        SimdFloat radiusSum = a.radius + capsule.radius;
+        lanes.contact = simdAnd(validLanes(pairs, p), simdLess(distance2, radiusSum * radiusSum));
+        if (simdMoveMask(lanes.contact) == 0) continue;
+        normalize(lanes.nx, lanes.ny, lanes.nz, distance2);
+
+        RigidLanes b = translatingBody(capsule.body);
+        SimdInt pairIndex = a.material * materialRow + b.material;
+        computeRigidContactImpulse(lanes, a, b, a.x + a.radius * lanes.nx, a.y + a.radius * lanes.ny, a.z + a.radius * lanes.nz,
+            simdGather(materials.restitution, pairIndex), simdGather(materials.friction, pairIndex));
+        scatterRigidContacts(sideA, [&](int index, const glm::vec3&, const glm::vec3& impulse) { applyBodyImpulse(capsules.body, index, impulse); },
+            lanes, a, pairs, p);
+    }
+}
+
+template <typename SideA>
+void resolveRoundBoxPairs(const SideA& sideA, BoxArrays& boxes, const CandidatePairs& pairs, const MaterialTable& materials) {
+    const SimdInt materialRow = simdSetInt(MAX_MATERIALS);
+
+    for (size_t p = 0; p < pairs.first.size(); p += SIMD_WIDTH) {
+        RigidLanes a = sideA.load(simdLoadInt(&pairs.first[p]));
+        BoxLanes box = loadBoxes(boxes, simdLoadInt(&pairs.second[p]));
+
+        ContactLanes lanes;
+        lanes.contact = validLanes(pairs, p);
+        sphereBoxContact(box, a.x, a.y, a.z, a.radius, lanes);
+        if (simdMoveMask(lanes.contact) == 0) continue;
+
+        RigidLanes b = translatingBody(box.body);
+        SimdInt pairIndex = a.material * materialRow + b.material;
+        computeRigidContactImpulse(lanes, a, b, a.x + a.radius * lanes.nx, a.y + a.radius * lanes.ny, a.z + a.radius * lanes.nz,
+            simdGather(materials.restitution, pairIndex), simdGather(materials.friction, pairIndex));
+        scatterRigidContacts(sideA, [&](int index, const glm::vec3&, const glm::vec3& impulse) { applyBodyImpulse(boxes.body, index, impulse); },
+            lanes, a, pairs, p);
+    }
+}
+
+// ki doru parasnn en yakn noktalar (Ericson, 5.1.9). Parametrenin kstrld dallar
+// her iki sonucun hesaplanp maskeyle seilmesine dntrlmtr.
+void resolveCapsuleCapsulePairs(CapsuleArrays& capsules, const CandidatePairs& pairs, const MaterialTable& materials) {
+    const SimdInt materialRow = simdSetInt(MAX_MATERIALS);
+    const SimdFloat zero = simdSet(0.0f);
+    const SimdFloat one = simdSet(1.0f);
+    const SimdFloat two = simdSet(2.0f);
+    const SimdFloat epsilon = simdSet(1e-12f);
+
+    for (size_t p = 0; p < pairs.first.size(); p += SIMD_WIDTH) {
+        SimdInt ia = simdLoadInt(&pairs.first[p]);
+        SimdInt ib = simdLoadInt(&pairs.second[p]);
+        CapsuleLanes a = loadCapsules(capsules, ia);
+        CapsuleLanes b = loadCapsules(capsules, ib);
+
+        // Paralar P1 + s d1 ve P2 + t d2, s, t in [0, 1]
+        SimdFloat d1x = two * a.axisX, d1y = two * a.axisY, d1z = two * a.axisZ;
+        SimdFloat d2x = two * b.axisX, d2y = two * b.axisY, d2z = two * b.axisZ;
+        SimdFloat p1x = a.body.x - a.axisX, p1y = a.body.y - a.axisY, p1z = a.body.z - a.axisZ;
+        SimdFloat p2x = b.body.x - b.axisX, p2y = b.body.y - b.axisY, p2z = b.body.z - b.axisZ;
+        SimdFloat rx = p1x - p2x, ry = p1y - p2y, rz = p1z - p2z;
+
+        SimdFloat aa = simdMax(simdDot(d1x, d1y, d1z, d1x, d1y, d1z), epsilon);
+        SimdFloat ee = simdMax(simdDot(d2x, d2y, d2z, d2x, d2y, d2z), epsilon);
+        SimdFloat bb = simdDot(d1x, d1y, d1z, d2x, d2y, d2z);
+        SimdFloat cc = simdDot(d1x, d1y, d1z, rx, ry, rz);
+        SimdFloat ff = simdDot(d2x, d2y, d2z, rx, ry, rz);
+        SimdFloat denominator = aa * ee - bb * bb;
+
+        // Paralel paralarda s = 0 alnr
+        SimdFloat s = simdSelect(simdGreater(denominator, epsilon),
+            simdClamp((bb * ff - cc * ee) / simdMax(denominator, epsilon), zero, one), zero);
+        SimdFloat tRaw = (bb * s + ff) / ee;
+        SimdFloat t = simdClamp(tRaw, zero, one);
+        SimdFloat tClamped = simdOr(simdLess(tRaw, zero), simdGreater(tRaw, one));
+        s = simdSelect(tClamped, simdClamp((bb * t - cc) / aa, zero, one), s);
+
+        ContactLanes lanes;
+        lanes.nx = (p2x + t * d2x) - (p1x + s * d1x);
+        lanes.ny = (p2y + t * d2y) - (p1y + s * d1y);
+        lanes.nz = (p2z + t * d2z) - (p1z + s * d1z);
+        SimdFloat distance2 = simdDot(lanes.nx, lanes.ny, lanes.nz, lanes.nx, lanes.ny, lanes.nz);
+        SimdFloat radiusSum = a.radius + b.radius;
+        lanes.contact = simdAnd(validLanes(pairs, p), simdLess(distance2, radiusSum * radiusSum));
+        lanes.contact = simdAnd(lanes.contact, simdGreater(distance2, zero));
+        if (simdMoveMask(lanes.contact) == 0) continue;
+        normalize(lanes.nx, lanes.ny, lanes.nz, distance2);
+
+        SimdFloat inverseSum = a.body.inverseMass + b.body.inverseMass;
+        SimdInt pairIndex = a.body.material * materialRow + b.body.material;
+        computeContactImpulse(lanes, b.body.velocityX - a.body.velocityX, b.body.velocityY - a.body.velocityY,
+            b.body.velocityZ - a.body.velocityZ, inverseSum, inverseSum,
+            simdGather(materials.restitution, pairIndex), simdGather(materials.friction, pairIndex));
+
+        ContactStore store(lanes);
+        for (int lane = 0; lane < SIMD_WIDTH; ++lane) {
+            if ((store.mask & (1 << lane)) == 0) continue;
+            glm::vec3 impulse = store.impulse(lane);
+            applyBodyImpulse(capsules.body, pairs.first[p + lane], -impulse);
+            applyBodyImpulse(capsules.body, pairs.second[p + lane], impulse);
+        }
+    }
+}
+
+// Kapsl ekseni zerinde kutuya en yakn nokta iki admlk sabit bir yinelemeyle bulunur
+// (eksen -> kutu -> eksen); ardndan o nokta kapsl yarapl bir kre gibi kutuya kar snanr.
+void resolveCapsuleBoxPairs(CapsuleArrays& capsules, BoxArrays& boxes, const CandidatePairs& pairs, const MaterialTable& materials) {
+    const SimdInt materialRow = simdSetInt(MAX_MATERIALS);
+
+    for (size_t p = 0; p < pairs.first.size(); p += SIMD_WIDTH) {
+        SimdInt ia = simdLoadInt(&pairs.first[p]);
+        SimdInt ib = simdLoadInt(&pairs.second[p]);
+        CapsuleLanes a = loadCapsules(capsules, ia);
+        BoxLanes b = loadBoxes(boxes, ib);
+
+        SimdFloat t = segmentParameter(b.body.x, b.body.y, b.body.z, a);
+        SimdFloat qx, qy, qz;
+        closestPointOnBox(b, a.body.x + t * a.axisX, a.body.y + t * a.axisY, a.body.z + t * a.axisZ, qx, qy, qz);
+        t = segmentParameter(qx, qy, qz, a);
+
+        ContactLanes lanes;
+        lanes.contact = validLanes(pairs, p);
+        sphereBoxContact(b, a.body.x + t * a.axisX, a.body.y + t * a.axisY, a.body.z + t * a.axisZ, a.radius, lanes);
+        if (simdMoveMask(lanes.contact) == 0) continue;
+
+        SimdFloat inverseSum = a.body.inverseMass + b.body.inverseMass;
+        SimdInt pairIndex = a.body.material * materialRow + b.body.material;
+        computeContactImpulse(lanes, b.body.velocityX - a.body.velocityX, b.body.velocityY - a.body.velocityY,
+            b.body.velocityZ - a.body.velocityZ, inverseSum, inverseSum,
+            simdGather(materials.restitution, pairIndex), simdGather(materials.friction, pairIndex));
+
+        ContactStore store(lanes);
+        for (int lane = 0; lane < SIMD_WIDTH; ++lane) {
+            if ((store.mask & (1 << lane)) == 0) continue;
+            glm::vec3 impulse = store.impulse(lane);
+            applyBodyImpulse(capsules.body, pairs.first[p + lane], -impulse);
+            applyBodyImpulse(boxes.body, pairs.second[p + lane], impulse);
+        }
+    }
+}
+
+// Ayrc eksen teoremi: 3 + 3 yz ekseni ve 9 kenar arpm. Hepsinde rtme varsa temas
+// normali en kk rtmenin eksenidir.
+void resolveBoxBoxPairs(BoxArrays& boxes, const CandidatePairs& pairs, const MaterialTable& materials) {
+    const SimdInt materialRow = simdSetInt(MAX_MATERIALS);
+    const SimdFloat zero = simdSet(0.0f);
+    const SimdFloat edgeBias = simdSet(1e-4f);
+
+    for (size_t p = 0; p < pairs.first.size(); p += SIMD_WIDTH) {
+        SimdInt ia = simdLoadInt(&pairs.first[p]);
+        SimdInt ib = simdLoadInt(&pairs.second[p]);
+        BoxLanes a = loadBoxes(boxes, ia);
+        BoxLanes b = loadBoxes(boxes, ib);
+
+        SimdFloat tx = b.body.x - a.body.x;
+        SimdFloat ty = b.body.y - a.body.y;
+        SimdFloat tz = b.body.z - a.body.z;
+
+        ContactLanes lanes;
+        lanes.nx = zero;
+        lanes.ny = zero;
+        lanes.nz = zero;
+        SimdFloat overlap = simdSet(1e30f);
+        for (int k = 0; k < 3; ++k) {
+            testSeparatingAxis(a, b, tx, ty, tz, a.axis[k][0], a.axis[k][1], a.axis[k][2], zero, overlap, lanes.nx, lanes.ny, lanes.nz);
+            testSeparatingAxis(a, b, tx, ty, tz, b.axis[k][0], b.axis[k][1], b.axis[k][2], zero, overlap, lanes.nx, lanes.ny, lanes.nz);
+        }
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                const SimdFloat* u = a.axis[i];
+                const SimdFloat* v = b.axis[j];
+                testSeparatingAxis(a, b, tx, ty, tz,
+                    u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0],
+                    edgeBias, overlap, lanes.nx, lanes.ny, lanes.nz);
+            }
+        }
+
+        lanes.contact = simdAnd(validLanes(pairs, p), simdGreater(overlap, zero));
+        if (simdMoveMask(lanes.contact) == 0) continue;
+
+        SimdFloat inverseSum = a.body.inverseMass + b.body.inverseMass;
+        SimdInt pairIndex = a.body.material * materialRow + b.body.material;
+        computeContactImpulse(lanes, b.body.velocityX - a.body.velocityX, b.body.velocityY - a.body.velocityY,
+            b.body.velocityZ - a.body.velocityZ, inverseSum, inverseSum,
+            simdGather(materials.restitution, pairIndex), simdGather(materials.friction, pairIndex));
+
+        ContactStore store(lanes);
+        for (int lane = 0; lane < SIMD_WIDTH; ++lane) {
+            if ((store.mask & (1 << lane)) == 0) continue;
+            glm::vec3 impulse = store.impulse(lane);
+            applyBodyImpulse(boxes.body, pairs.first[p + lane], -impulse);
+            applyBodyImpulse(boxes.body, pairs.second[p + lane], impulse);
+        }
+    }
+}
+
+void resizeShapeArrays(ShapeArrays& arrays, size_t count) {
+    arrays.x.resize(count);
+    arrays.y.resize(count);
+    arrays.z.resize(count);
+    arrays.velocityX.resize(count);
+    arrays.velocityY.resize(count);
+    arrays.velocityZ.resize(count);
+    arrays.inverseMass.resize(count);
+    arrays.material.resize(count);
+}
+
+void storeBody(ShapeArrays& arrays, size_t i, const glm::vec3& position, const glm::vec3& velocity, float mass, bool fixed, int material) {
+    arrays.x[i] = position.x;
+    arrays.y[i] = position.y;
+    arrays.z[i] = position.z;
+    arrays.velocityX[i] = velocity.x;
+    arrays.velocityY[i] = velocity.y;
+    arrays.velocityZ[i] = velocity.z;
+    arrays.inverseMass[i] = fixed ? 0.0f : 1.0f / mass;
+    arrays.material[i] = material;
+}
+
+glm::vec3 loadVelocity(const ShapeArrays& arrays, size_t i) {
+    return glm::vec3(arrays.velocityX[i], arrays.velocityY[i], arrays.velocityZ[i]);
+}
+
+void loadShapeArrays(NarrowPhaseBuffers& buffers, const std::vector<Capsule>& capsules, const std::vector<Box>& boxes) {
+    CapsuleArrays& c = buffers.capsules;
+    resizeShapeArrays(c.body, capsules.size());
+    c.axisX.resize(capsules.size());
+    c.axisY.resize(capsules.size());
+    c.axisZ.resize(capsules.size());
+    c.radius.resize(capsules.size());
+    for (size_t i = 0; i < capsules.size(); ++i) {
+        const Capsule& capsule = capsules[i];
+        storeBody(c.body, i, capsule.position, capsule.velocity, capsuleMass(capsule), capsule.fixed, capsule.material);
+        glm::vec3 axis = capsuleHalfAxis(capsule);
+        c.axisX[i] = axis.x;
+        c.axisY[i] = axis.y;
+        c.axisZ[i] = axis.z;
+        c.radius[i] = capsule.radius;
+    }
+
+    BoxArrays& b = buffers.boxes;
+    resizeShapeArrays(b.body, boxes.size());
+    for (std::vector<float>& axis : b.axis) {
+        axis.resize(boxes.size());
+    }
+    b.halfX.resize(boxes.size());
+    b.halfY.resize(boxes.size());
+    b.halfZ.resize(boxes.size());
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        const Box& box = boxes[i];
+        storeBody(b.body, i, box.position, box.velocity, boxMass(box), box.fixed, box.material);
+        glm::mat3 basis = glm::mat3_cast(box.orientation);
+        for (int k = 0; k < 3; ++k) {
+            for (int j = 0; j < 3; ++j) {
+                b.axis[3 * k + j][i] = basis[k][j];
+            }
+        }
+        b.halfX[i] = box.halfExtents.x;
+        b.halfY[i] = box.halfExtents.y;
+        b.halfZ[i] = box.halfExtents.z;
+    }
+}
+
+} // namespace
+
+
+void buildShapeProxies(NarrowPhaseBuffers& buffers, const std::vector<Sphere>& spheres, const ClumpSystem& clumps,
+    const std::vector<Capsule>& capsules, const std::vector<Box>& boxes) {
+    buffers.proxyCenters.clear();
+    buffers.proxyRadii.clear();
+    for (const Sphere& sphere : spheres) {
+        buffers.proxyCenters.push_back(sphere.position);
+        buffers.proxyRadii.push_back(sphere.radius);
+    }
+    for (size_t i = 0; i < clumps.memberCount; ++i) {
+        buffers.proxyCenters.push_back(clumpMemberPosition(clumps, i));
+        buffers.proxyRadii.push_back(clumps.memberRadius[i]);
+    }
+    for (const Capsule& capsule : capsules) {
+        buffers.proxyCenters.push_back(capsule.position);
+        buffers.proxyRadii.push_back(capsuleBoundingRadius(capsule));
+    }
+    for (const Box& box : boxes) {
+        buffers.proxyCenters.push_back(box.position);
+        buffers.proxyRadii.push_back(boxBoundingRadius(box));
+    }
+}
+
+void bucketPairsByShape(const CandidatePairs& pairs, const int typeCounts[SHAPE_TYPE_COUNT],
+    const std::vector<int>& memberOwner, CandidatePairs buckets[SHAPE_PAIR_TYPE_COUNT]) {
+    int typeStart[SHAPE_TYPE_COUNT + 1] = {};
+    for (int t = 0; t < SHAPE_TYPE_COUNT; ++t) {
+        typeStart[t + 1] = typeStart[t] + typeCounts[t];
+    }
+    auto shapeType = [&](int proxy) {
+        return (proxy >= typeStart[1]) + (proxy >= typeStart[2]) + (proxy >= typeStart[3]);
+    };
+    // Ayn gvdenin yeleri birbirine dese de arpmaz
+    auto internalPair = [&](int a, int b, int typeA, int typeB) {
+        return typeA == SHAPE_CLUMP_MEMBER && typeB == SHAPE_CLUMP_MEMBER
+            && memberOwner[a - typeStart[SHAPE_CLUMP_MEMBER]] == memberOwner[b - typeStart[SHAPE_CLUMP_MEMBER]];
+    };
+
+    int counts[SHAPE_PAIR_TYPE_COUNT] = {};
+    for (int i = 0; i < pairs.count; ++i) {
+        int a = pairs.first[i];
+        int b = pairs.second[i];
+        int typeA = shapeType(a);
+        int typeB = shapeType(b);
+        counts[kPairTypeTable[typeA][typeB]] += !internalPair(a, b, typeA, typeB);
+    }
+
+    // Her kova SIMD_WIDTH katna (0, 0) iftleriyle tamamlanr; ekirdekler bunlar ift saysyla eler
+    int cursor[SHAPE_PAIR_TYPE_COUNT];
+    for (int t = 0; t < SHAPE_PAIR_TYPE_COUNT; ++t) {
+        size_t padded = (counts[t] + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH;
+        buckets[t].first.assign(padded, 0);
+        buckets[t].second.assign(padded, 0);
+        buckets[t].count = counts[t];
+        cursor[t] = 0;
+    }
+
+    for (int i = 0; i < pairs.count; ++i) {
+        int a = pairs.first[i];
+        int b = pairs.second[i];
+        int typeA = shapeType(a);
+        int typeB = shapeType(b);
+        if (internalPair(a, b, typeA, typeB)) continue;
+
+        // Kk tr nde; seimler koullu atamaya iner
+        bool swap = typeA > typeB;
+        int low = swap ? b : a;
+        int high = swap ? a : b;
+        int lowType = swap ? typeB : typeA;
+        int highType = swap ? typeA : typeB;
+
+        int bucketIndex = kPairTypeTable[lowType][highType];
+        int slot = cursor[bucketIndex]++;
+        buckets[bucketIndex].first[slot] = low - typeStart[lowType];
+        buckets[bucketIndex].second[slot] = high - typeStart[highType];
+    }
+}
+
+// Aday iftleri 8'erli gruplar halinde iler: mesafe testi, malzeme ifti tablosundan sekme ve srtnme
+// katsaylarnn toplanmas ve itme hesab tamamen erit maskeleriyle, dallanmadan yaplr.
+// Yalnzca temas eden eritlerin itmeleri sonradan srayla krelere yazlr. Ayn kre bir grupta
+// birden ok temas eridinde geerse ikinci erit ilkinin eski hzyla hesaplanm olur; byle eritler
+// ertelenir ve gncel hzlarla yeniden toplanr, bylece her kre seri zmdeki srayla gncellenir.
+void resolveSphereSpherePairs(std::vector<Sphere>& spheres, RotationState& rotation,
+    const CandidatePairs& pairs, const MaterialTable& materials, float period, std::vector<int>* touched) {
+    const SimdInt materialRow = simdSetInt(MAX_MATERIALS);
+    const SimdFloat zero = simdSet(0.0f);
+    const SimdFloat tangentFactor = simdSet(kSphereTangentFactor);
+    // En yakn grnt: d - L round(d / L). Ak snrda 1/L = 0 alnr ve d deimez.
+    const SimdFloat box = simdSet(period);
+    const SimdFloat inverseBox = simdSet(period > 0.0f ? 1.0f / period : 0.0f);
+
+    alignas(32) float inverseMassA[SIMD_WIDTH], inverseMassB[SIMD_WIDTH];
+    alignas(32) float spinA[SIMD_WIDTH], spinB[SIMD_WIDTH];
+    alignas(32) int firstLane[SIMD_WIDTH], secondLane[SIMD_WIDTH];
+    int used[2 * SIMD_WIDTH];
+
+    for (size_t p = 0; p < pairs.first.size(); p += SIMD_WIDTH) {
+        for (int lane = 0; lane < SIMD_WIDTH; ++lane) {
+            firstLane[lane] = pairs.first[p + lane];
+            secondLane[lane] = pairs.second[p + lane];
+        }
+
+        for (;;) {
+            SimdInt ia = simdLoadInt(firstLane);
+            SimdInt ib = simdLoadInt(secondLane);
+            SphereLanes a = loadSpheres(spheres, rotation, ia);
+            SphereLanes b = loadSpheres(spheres, rotation, ib);
+
+            // Dolgu iftleri (i, i) mesafe sfr olduu iin elenir
+            ContactLanes lanes;
+            lanes.nx = b.x - a.x;
+            lanes.ny = b.y - a.y;
+            lanes.nz = b.z - a.z;
+            lanes.nx = lanes.nx - box * simdRound(lanes.nx * inverseBox);
+            lanes.ny = lanes.ny - box * simdRound(lanes.ny * inverseBox);
+            lanes.nz = lanes.nz - box * simdRound(lanes.nz * inverseBox);
+            SimdFloat distance2 = simdDot(lanes.nx, lanes.ny, lanes.nz, lanes.nx, lanes.ny, lanes.nz);
+            SimdFloat radiusSum = a.radius + b.radius;
+            lanes.contact = simdAnd(simdLess(distance2, radiusSum * radiusSum), simdGreater(distance2, zero));
+            const int contactMask = simdMoveMask(lanes.contact);
+            if (contactMask == 0) break;
+
+            // nceki bir temas eridiyle kre paylaan erit ertelenir (nceki erit de ertelenmi olsa)
+            int deferred = 0;
+            int usedCount = 0;
+            for (int lane = 0; lane < SIMD_WIDTH; ++lane) {
+                if ((contactMask & (1 << lane)) == 0) continue;
+                for (int u = 0; u < usedCount; ++u) {
+                    if (used[u] == firstLane[lane] || used[u] == secondLane[lane]) {
+                        deferred |= 1 << lane;
+                        break;
+                    }
+                }
+                used[usedCount++] = firstLane[lane];
+                used[usedCount++] = secondLane[lane];
+            }
+
+            normalize(lanes.nx, lanes.ny, lanes.nz, distance2);
+
+            // Temas noktasndaki bal hz dnmeyi de ierir: rv - (ra * wa + rb * wb) x n
+            SimdFloat sx = a.radius * a.angularX + b.radius * b.angularX;
+            SimdFloat sy = a.radius * a.angularY + b.radius * b.angularY;
+            SimdFloat sz = a.radius * a.angularZ + b.radius * b.angularZ;
+            SimdFloat cx = b.velocityX - a.velocityX - (sy * lanes.nz - sz * lanes.ny);
+            SimdFloat cy = b.velocityY - a.velocityY - (sz * lanes.nx - sx * lanes.nz);
+            SimdFloat cz = b.velocityZ - a.velocityZ - (sx * lanes.ny - sy * lanes.nx);
+
+            SimdFloat inverseSum = a.inverseMass + b.inverseMass;
+            SimdInt pairIndex = a.material * materialRow + b.material;
+            computeContactImpulse(lanes, cx, cy, cz, inverseSum, tangentFactor * inverseSum,
+                simdGather(materials.restitution, pairIndex), simdGather(materials.friction, pairIndex));
+
+            ContactStore store(lanes);
+            simdStore(inverseMassA, a.inverseMass);
+            simdStore(inverseMassB, b.inverseMass);
+            // Her iki krenin asal hz deiimi -(1 / (0.4 m r)) * (n x J)
+            simdStore(spinA, a.inverseMass / (simdSet(SPHERE_INERTIA_FACTOR) * a.radius));
+            simdStore(spinB, b.inverseMass / (simdSet(SPHERE_INERTIA_FACTOR) * b.radius));
+            const int applied = store.mask & ~deferred;
+            for (int lane = 0; lane < SIMD_WIDTH; ++lane) {
+                if ((applied & (1 << lane)) == 0) continue;
+                int first = firstLane[lane];
+                int second = secondLane[lane];
+                glm::vec3 impulse = store.impulse(lane);
+                glm::vec3 torque = glm::cross(store.normal(lane), impulse);
+                spheres[first].velocity -= impulse * inverseMassA[lane];
+                spheres[second].velocity += impulse * inverseMassB[lane];
+                addAngularVelocity(rotation, first, -torque * spinA[lane]);
+                addAngularVelocity(rotation, second, -torque * spinB[lane]);
+                if (touched) {
+                    touched->push_back(first);
+                    touched->push_back(second);
+                }
+            }
+            if (deferred == 0) break;
+
+            // Ertelenmeyen eritler (0, 0) dolgusuna evrilir; yalnzca ertelenenler yeniden toplanr
+            for (int lane = 0; lane < SIMD_WIDTH; ++lane) {
+                if ((deferred & (1 << lane)) == 0) {
+                    firstLane[lane] = 0;
+                    secondLane[lane] = 0;
+                }
+            }
+        }
+    }
+}
+
+void resolveShapePairs(std::vector<Sphere>& spheres, RotationState& rotation, ClumpSystem& clumps,
+    std::vector<Capsule>& capsules, std::vector<Box>& boxes,
+    const CandidatePairs& pairs, NarrowPhaseBuffers& buffers, const MaterialTable& materials, float period) {
+    const int typeCounts[SHAPE_TYPE_COUNT] = {
+        static_cast<int>(spheres.size()), static_cast<int>(clumps.memberCount),
+        static_cast<int>(capsules.size()), static_cast<int>(boxes.size()),
+    };
+    bucketPairsByShape(pairs, typeCounts, clumps.owner, buffers.buckets);
+    loadShapeArrays(buffers, capsules, boxes);
+
+    SphereSide sphereSide = { spheres, rotation };
+    MemberSide memberSide = { clumps };
+    resolveSphereSpherePairs(spheres, rotation, buffers.buckets[PAIR_SPHERE_SPHERE], materials, period);
+    resolveRoundRoundPairs(sphereSide, memberSide, buffers.buckets[PAIR_SPHERE_MEMBER], materials);
+    resolveRoundCapsulePairs(sphereSide, buffers.capsules, buffers.buckets[PAIR_SPHERE_CAPSULE], materials);
+    resolveRoundBoxPairs(sphereSide, buffers.boxes, buffers.buckets[PAIR_SPHERE_BOX], materials);
+    resolveRoundRoundPairs(memberSide, memberSide, buffers.buckets[PAIR_MEMBER_MEMBER], materials);
+    resolveRoundCapsulePairs(memberSide, buffers.capsules, buffers.buckets[PAIR_MEMBER_CAPSULE], materials);
+    resolveRoundBoxPairs(memberSide, buffers.boxes, buffers.buckets[PAIR_MEMBER_BOX], materials);
+    resolveCapsuleCapsulePairs(buffers.capsules, buffers.buckets[PAIR_CAPSULE_CAPSULE], materials);
+    resolveCapsuleBoxPairs(buffers.capsules, buffers.boxes, buffers.buckets[PAIR_CAPSULE_BOX], materials);
+    resolveBoxBoxPairs(buffers.boxes, buffers.buckets[PAIR_BOX_BOX], materials);
+
+    for (size_t i = 0; i < capsules.size(); ++i) {
+        capsules[i].velocity = loadVelocity(buffers.capsules.body, i);
+    }
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        boxes[i].velocity = loadVelocity(buffers.boxes.body, i);
+    }
+}
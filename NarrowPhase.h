@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Sphere.h"
+#include "Shapes.h"
+#include "Clump.h"
+#include "Material.h"
+#include "Rotation.h"
+#include "SpatialGrid.h"
+#include <vector>
+
+
+// Yuvarlak trler nde: kre ve gvde yesi iftlerin her zaman A tarafdr
+enum ShapeType {
+    SHAPE_SPHERE,
+    SHAPE_CLUMP_MEMBER,
+    SHAPE_CAPSULE,
+    SHAPE_BOX,
+    SHAPE_TYPE_COUNT
+};
+
+// ift trleri her zaman kk ekil tr nde olacak ekilde sralanr (r. kre-kutu, kutu-kre deil)
+enum ShapePairType {
+    PAIR_SPHERE_SPHERE,
+    PAIR_SPHERE_MEMBER,
+    PAIR_SPHERE_CAPSULE,
+    PAIR_SPHERE_BOX,
+    PAIR_MEMBER_MEMBER,
+    PAIR_MEMBER_CAPSULE,
+    PAIR_MEMBER_BOX,
+    PAIR_CAPSULE_CAPSULE,
+    PAIR_CAPSULE_BOX,
+    PAIR_BOX_BOX,
+    SHAPE_PAIR_TYPE_COUNT
+};
+
+// Kapsl ve kutularn SIMD toplamalar iin her admda karlan SoA kopyas.
+// Hzlar burada gncellenir ve dar faz sonunda ekillere geri yazlr.
+struct ShapeArrays {
+    std::vector<float> x, y, z;
+    std::vector<float> velocityX, velocityY, velocityZ;
+    std::vector<float> inverseMass; // Sabit ekiller iin 0
+    std::vector<int> material;
+};
+
+struct CapsuleArrays {
+    ShapeArrays body;
+    std::vector<float> axisX, axisY, axisZ; // Dnya koordinatlarnda yar eksen
+    std::vector<float> radius;
+};
+
+struct BoxArrays {
+    ShapeArrays body;
+    std::vector<float> axis[9]; // Dnme matrisinin stunlar: axis[3 * k + j], k. yerel eksenin j. bileeni
+    std::vector<float> halfX, halfY, halfZ;
+};
+
+// Kark sahnelerde admlar arasnda yeniden kullanlan tamponlar. Geni faz vekilleri
+// ShapeType srasyla (kreler, gvde yeleri, kapsller, kutular) tek indeks uzaynda dizilir.
+struct NarrowPhaseBuffers {
+    std::vector<glm::vec3> proxyCenters;
+    std::vector<float> proxyRadii;
+    CandidatePairs buckets[SHAPE_PAIR_TYPE_COUNT]; // ekil dizilerindeki yerel indekslerle
+    CapsuleArrays capsules;
+    BoxArrays boxes;
+};
+
+void buildShapeProxies(NarrowPhaseBuffers& buffers, const std::vector<Sphere>& spheres, const ClumpSystem& clumps,
+    const std::vector<Capsule>& capsules, const std::vector<Box>& boxes);
+
+// Vekil indeksli iftleri sayma sralamasyla trlerine gre kovalara datr. typeCounts her trn
+// vekil saysdr; ayn gvdeye ait ye iftleri burada atlr.
+void bucketPairsByShape(const CandidatePairs& pairs, const int typeCounts[SHAPE_TYPE_COUNT],
+    const std::vector<int>& memberOwner, CandidatePairs buckets[SHAPE_PAIR_TYPE_COUNT]);
+
+// Yalnzca krelerden oluan iftler (kre indeksleriyle). period > 0 ise aralk en yakn grntye
+// gre alnr (periyodik kp); 0 ak snr demektir. touched verilirse hz deien her krenin
+// indeksi sonuna eklenir (tekrarl olabilir).
+void resolveSphereSpherePairs(std::vector<Sphere>& spheres, RotationState& rotation,
+    const CandidatePairs& pairs, const MaterialTable& materials, float period = 0.0f,
+    std::vector<int>* touched = nullptr);
+
+// Vekil indeksli iftleri kovalara ayrr ve her kovay kendi SIMD ekirdeinden geirir.
+// period yalnzca kre-kre iftlerine uygulanr; dier ekiller periyodik sarlmaz.
+void resolveShapePairs(std::vector<Sphere>& spheres, RotationState& rotation, ClumpSystem& clumps,
+    std::vector<Capsule>& capsules, std::vector<Box>& boxes,
+    const CandidatePairs& pairs, NarrowPhaseBuffers& buffers, const MaterialTable& materials, float period = 0.0f);
@@ -0,0 +1,342 @@
+#include "Packing.h"
+
+#include <glm/gtc/constants.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <random>
+
+
+namespace {
+
+const double kNever = std::numeric_limits<double>::infinity();
+
+enum PackingEventType { EventCollision, EventWall, EventCellCrossing };
+
+struct PackingEvent {
+    double time;
+    int sphere;
+    unsigned int stamp;
+};
+
+struct PackingEventLater {
+    bool operator()(const PackingEvent& a, const PackingEvent& b) const { return a.time > b.time; }
+};
+
+// Komu taramasnda okunan her ey tek nbellek satrnda dursun diye kre bana tek kayt
+struct PackingSphere {
+    glm::dvec3 position; // localTime anndaki konum
+    double localTime;
+    glm::dvec3 velocity;
+    unsigned int collisionCount; // Hz her deitiinde artar
+    int next;                    // Ayn hcredeki sonraki kre
+};
+
+// Krenin sradaki olay
+struct PackingPrediction {
+    unsigned int stamp;
+    int type;
+    int partner;
+    unsigned int partnerCount;
+    int axis; // Duvar/hcre olaylar iin eksen * 2 + (pozitif yn ? 1 : 0)
+};
+
+// Olay gdml sktrma durumu. Kreler "gecikmeli" tutulur: yalnzca bir olaya
+// kartklarnda imdiki zamana ilerletilirler.
+struct PackingState {
+    int count = 0;
+    double half = 0.0;
+    double growth = 0.0; // ap byme hz: sigma(t) = growth * t
+
+    std::vector<PackingSphere> spheres;
+    std::vector<PackingPrediction> predictions;
+
+    // Hcre listesi; ift ynl balant sayesinde hcre deitirmek O(1)
+    int cellsPerSide = 1;
+    double cellSize = 0.0;
+    std::vector<glm::ivec3> cellOf;
+    std::vector<int> cellHead;
+    std::vector<int> prev;
+
+    std::priority_queue<PackingEvent, std::vector<PackingEvent>, PackingEventLater> queue;
+
+    int cellIndex(const glm::ivec3& c) const { return (c.z * cellsPerSide + c.y) * cellsPerSide + c.x; }
+
+    void insertIntoCell(int i) {
+        int head = cellIndex(cellOf[i]);
+        prev[i] = -1;
+        spheres[i].next = cellHead[head];
+        if (spheres[i].next >= 0) prev[spheres[i].next] = i;
+        cellHead[head] = i;
+    }
+
+    void removeFromCell(int i) {
+        int next = spheres[i].next;
+        if (prev[i] >= 0) spheres[prev[i]].next = next;
+        else cellHead[cellIndex(cellOf[i])] = next;
+        if (next >= 0) prev[next] = prev[i];
+    }
+
+    void advance(int i, double time) {
+        PackingSphere& s = spheres[i];
+        s.position += s.velocity * (time - s.localTime);
+        s.localTime = time;
+    }
+};
+
+// Byyen iki krenin temas zaman: |r + v*tau| = sigma + growth*tau
+double pairCollisionDelay(const glm::dvec3& r, const glm::dvec3& v, double sigma, double growth) {
+    double a = glm::dot(v, v) - growth * growth;
+    double b = glm::dot(r, v) - sigma * growth;
+    double c = glm::dot(r, r) - sigma * sigma;
+    if (c < 0.0) return b < 0.0 ? 0.0 : kNever; // Saysal rtme: yaklayorsa hemen arptr
+    if (b >= 0.0 && a >= 0.0) return kNever;
+    double discriminant = b * b - a * c;
+    if (discriminant < 0.0) return kNever;
+    return c / (-b + std::sqrt(discriminant));
+}
+
+void predictEvent(PackingState& state, int i, double now) {
+    state.advance(i, now);
+
+    const glm::dvec3 x = state.spheres[i].position;
+    const glm::dvec3 v = state.spheres[i].velocity;
+    double radiusNow = 0.5 * state.growth * now;
+    double radiusGrowth = 0.5 * state.growth;
+
+    double best = kNever;
+    int type = EventWall;
+    int partner = -1;
+    int axis = 0;
+
+    // Byyen yarapla duvar temas
+    for (int k = 0; k < 3; ++k) {
+        double speedPositive = v[k] + radiusGrowth;
+        if (speedPositive > 0.0) {
+            double delay = std::max(0.0, state.half - x[k] - radiusNow) / speedPositive;
+            if (delay < best) { best = delay; type = EventWall; axis = k * 2 + 1; }
+        }
+        double speedNegative = -v[k] + radiusGrowth;
+        if (speedNegative > 0.0) {
+            double delay = std::max(0.0, state.half + x[k] - radiusNow) / speedNegative;
+            if (delay < best) { best = delay; type = EventWall; axis = k * 2; }
+        }
+    }
+
+    // Hcre snrn geme
+    const glm::ivec3 cell = state.cellOf[i];
+    for (int k = 0; k < 3; ++k) {
+        if (v[k] > 0.0 && cell[k] < state.cellsPerSide - 1) {
+            double boundary = -state.half + (cell[k] + 1) * state.cellSize;
+            double delay = std::max(0.0, boundary - x[k]) / v[k];
+            if (delay < best) { best = delay; type = EventCellCrossing; axis = k * 2 + 1; }
+        } else if (v[k] < 0.0 && cell[k] > 0) {
+            double boundary = -state.half + cell[k] * state.cellSize;
+            double delay = std::max(0.0, x[k] - boundary) / -v[k];
+            if (delay < best) { best = delay; type = EventCellCrossing; axis = k * 2; }
+        }
+    }
+
+    // Komu 27 hcredeki krelerle arpma
+    double sigma = state.growth * now;
+    glm::ivec3 lo = glm::max(cell - 1, glm::ivec3(0));
+    glm::ivec3 hi = glm::min(cell + 1, glm::ivec3(state.cellsPerSide - 1));
+    for (int cz = lo.z; cz <= hi.z; ++cz) {
+        for (int cy = lo.y; cy <= hi.y; ++cy) {
+            for (int cx = lo.x; cx <= hi.x; ++cx) {
+                for (int j = state.cellHead[state.cellIndex(glm::ivec3(cx, cy, cz))]; j >= 0; j = state.spheres[j].next) {
+                    if (j == i) continue;
+                    const PackingSphere& other = state.spheres[j];
+                    glm::dvec3 r = other.position + other.velocity * (now - other.localTime) - x;
+                    double delay = pairCollisionDelay(r, other.velocity - v, sigma, state.growth);
+                    if (delay < best) { best = delay; type = EventCollision; partner = j; }
+                }
+            }
+        }
+    }
+
+    PackingPrediction& prediction = state.predictions[i];
+    prediction.stamp++;
+    prediction.type = type;
+    prediction.partner = partner;
+    prediction.partnerCount = partner >= 0 ? state.spheres[partner].collisionCount : 0;
+    prediction.axis = axis;
+    if (best < kNever) {
+        state.queue.push({ now + best, i, prediction.stamp });
+    }
+}
+
+// Tm kreleri imdiki zamana getirir, hzlar sabit scakla lekler ve olay kuyruunu yeniden kurar.
+// Byme her arpmada enerji ekledii iin bu lekleme dzenli aralklarla yaplr.
+void rescaleAndRebuild(PackingState& state, double now) {
+    double kinetic = 0.0;
+    for (int i = 0; i < state.count; ++i) {
+        state.advance(i, now);
+        kinetic += glm::dot(state.spheres[i].velocity, state.spheres[i].velocity);
+    }
+    double scale = kinetic > 0.0 ? std::sqrt(state.count / kinetic) : 1.0;
+    for (int i = 0; i < state.count; ++i) {
+        state.spheres[i].velocity *= scale;
+    }
+
+    state.queue = decltype(state.queue)();
+    for (int i = 0; i < state.count; ++i) {
+        predictEvent(state, i, now);
+    }
+}
+
+} // namespace
+
+
+std::vector<Sphere> generateJammedPacking(int sphereCount, float cubeSize, float targetPackingFraction,
+    float growthRate, unsigned int seed) {
+    std::vector<Sphere> spheres;
+    if (sphereCount <= 0) return spheres;
+
+    PackingState state;
+    state.count = sphereCount;
+    state.half = cubeSize * 0.5;
+    state.growth = growthRate;
+
+    // Hedef doluluk oranna karlk gelen son ap
+    double volume = static_cast<double>(cubeSize) * cubeSize * cubeSize;
+    double targetFraction = std::min(static_cast<double>(targetPackingFraction), 0.7);
+    double targetRadius = std::cbrt(targetFraction * volume * 3.0 / (4.0 * glm::pi<double>() * sphereCount));
+    double targetSigma = std::min(2.0 * targetRadius, static_cast<double>(cubeSize));
+    double endTime = targetSigma / state.growth;
+
+    // Hcre boyu son aptan kk olamaz, bylece yalnzca komu hcrelere bakmak yeterli olur
+    state.cellsPerSide = std::max(1, static_cast<int>(cubeSize / targetSigma));
+    state.cellsPerSide = std::min(state.cellsPerSide, 1024);
+    state.cellSize = cubeSize / static_cast<double>(state.cellsPerSide);
+
+    // Balangta ap sfr olduu iin rastgele noktalar akmaz
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::normal_distribution<double> gaussian(0.0, 1.0);
+    std::vector<std::pair<int, glm::dvec3>> points(sphereCount);
+    for (auto& point : points) {
+        glm::dvec3 p(unit(random), unit(random), unit(random));
+        point.second = (p * 2.0 - 1.0) * state.half * 0.999;
+        glm::ivec3 cell = glm::clamp(glm::ivec3((point.second + state.half) / state.cellSize),
+            glm::ivec3(0), glm::ivec3(state.cellsPerSide - 1));
+        point.first = state.cellIndex(cell);
+    }
+    // Hcre srasna dizmek komu krelerin bellekte de yakn durmasn salar
+    std::sort(points.begin(), points.end(), [](const std::pair<int, glm::dvec3>& a, const std::pair<int, glm::dvec3>& b) {
+        return a.first < b.first;
+    });
+
+    state.spheres.resize(sphereCount);
+    state.predictions.assign(sphereCount, PackingPrediction{ 0, EventWall, -1, 0, 0 });
+    state.cellOf.resize(sphereCount);
+    state.cellHead.assign(static_cast<size_t>(state.cellsPerSide) * state.cellsPerSide * state.cellsPerSide, -1);
+    state.prev.assign(sphereCount, -1);
+    for (int i = 0; i < sphereCount; ++i) {
+        PackingSphere& s = state.spheres[i];
+        s.position = points[i].second;
+        s.localTime = 0.0;
+        s.velocity = glm::dvec3(gaussian(random), gaussian(random), gaussian(random));
+        s.collisionCount = 0;
+        state.cellOf[i] = glm::clamp(glm::ivec3((s.position + state.half) / state.cellSize),
+            glm::ivec3(0), glm::ivec3(state.cellsPerSide - 1));
+        state.insertIntoCell(i);
+    }
+
+    // Skma yaklatka arpma skl patlar; olay btesi bitince ulalan oranla durulur
+    const long long maxEvents = 2000LL * sphereCount;
+    const long long rescaleInterval = 20LL * sphereCount;
+    long long events = 0;
+    double now = 0.0;
+    double lastRescaleTime = 0.0;
+    bool jammed = false;
+
+    rescaleAndRebuild(state, now);
+    while (!state.queue.empty() && events < maxEvents) {
+        PackingEvent event = state.queue.top();
+        if (event.time >= endTime) break;
+        state.queue.pop();
+
+        int i = event.sphere;
+        const PackingPrediction prediction = state.predictions[i];
+        if (event.stamp != prediction.stamp) continue; // Eski tahmin
+        now = event.time;
+        ++events;
+
+        int axis = prediction.axis / 2;
+        bool positive = (prediction.axis & 1) != 0;
+
+        if (prediction.type == EventCollision) {
+            int j = prediction.partner;
+            if (state.spheres[j].collisionCount != prediction.partnerCount) {
+                // Ortak baka bir olayla yn deitirdi, tahmini yenile
+                predictEvent(state, i, now);
+                continue;
+            }
+            state.advance(i, now);
+            state.advance(j, now);
+
+            // Byyen erevede esnek arpma: ayrlma hz byme hzn amal
+            PackingSphere& a = state.spheres[i];
+            PackingSphere& b = state.spheres[j];
+            glm::dvec3 normal = b.position - a.position;
+            double length = glm::length(normal);
+            normal = length > 0.0 ? normal / length : glm::dvec3(1.0, 0.0, 0.0);
+            double approach = glm::dot(b.velocity - a.velocity, normal);
+            double separation = 2.0 * state.growth - approach;
+            glm::dvec3 impulse = 0.5 * (separation - approach) * normal;
+            a.velocity -= impulse;
+            b.velocity += impulse;
+            a.collisionCount++;
+            b.collisionCount++;
+
+            predictEvent(state, i, now);
+            predictEvent(state, j, now);
+        } else if (prediction.type == EventWall) {
+            state.advance(i, now);
+            double& v = state.spheres[i].velocity[axis];
+            v = positive ? -v - state.growth : -v + state.growth;
+            state.spheres[i].collisionCount++;
+            predictEvent(state, i, now);
+        } else {
+            state.advance(i, now);
+            state.removeFromCell(i);
+            state.cellOf[i][axis] += positive ? 1 : -1;
+            state.insertIntoCell(i);
+            predictEvent(state, i, now);
+        }
+
+        if (events % rescaleInterval == 0) {
+            // Kre bana 20 arpmada doluluk oran binde birin onda biri kadar bile artmyorsa
+            // basn raksamtr, paket bu byme hznda skmtr
+            if (3.0 * (now - lastRescaleTime) < 1e-4 * now) {
+                jammed = true;
+                break;
+            }
+            lastRescaleTime = now;
+            rescaleAndRebuild(state, now);
+        }
+    }
+
+    // Son durumu ezamanla; float'a evirirken oluabilecek rtmeyi nlemek iin yarap hafife klt
+    double finalTime = (jammed || events >= maxEvents) ? now : endTime;
+    double finalRadius = 0.5 * state.growth * finalTime * (1.0 - 1e-5);
+
+    double kinetic = 0.0;
+    for (int i = 0; i < sphereCount; ++i) {
+        state.advance(i, finalTime);
+        kinetic += glm::dot(state.spheres[i].velocity, state.spheres[i].velocity);
+    }
+    // Her bileenin karekk ortalamas [-1, 1] aralndaki dzgn dalmnkiyle ayn olsun
+    double velocityScale = kinetic > 0.0 ? std::sqrt(sphereCount / kinetic) : 0.0;
+
+    spheres.reserve(sphereCount);
+    for (int i = 0; i < sphereCount; ++i) {
+        glm::dvec3 p = glm::clamp(state.spheres[i].position, glm::dvec3(-state.half + finalRadius), glm::dvec3(state.half - finalRadius));
+        glm::vec3 color(static_cast<float>(unit(random)), static_cast<float>(unit(random)), static_cast<float>(unit(random)));
+        Sphere sphere = { glm::vec3(p), static_cast<float>(finalRadius), color, glm::vec3(state.spheres[i].velocity * velocityScale) };
+        spheres.push_back(sphere);
+    }
+    return spheres;
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "Sphere.h"
+#include <vector>
+
+
+// LubachevskyStillinger yntemi: noktalar olay gdml bir simlasyonda sabit hzla bytlr,
+// hedef doluluk oranna (en fazla ~0.64) ulanca akmasz kreler dndrlr.
+// growthRate, ap byme hznn ortalama sl hza orandr; byk deerler daha hzl ama daha dzensiz paketler.
+std::vector<Sphere> generateJammedPacking(int sphereCount, float cubeSize, float targetPackingFraction,
+    float growthRate = 0.1f, unsigned int seed = 1);
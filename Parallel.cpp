@@ -0,0 +1,124 @@
+#include "Parallel.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace {
+
+class ThreadPool {
+public:
+    ThreadPool() {
+        int count = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        for (int i = 1; i < count; ++i) {
+            workers.emplace_back([this, i] { run(i); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+    int size() const {
+        return static_cast<int>(workers.size()) + 1;
+    }
+
+    // Ayn anda tek bir parallelFor alr; i ie arlar seri yrr
+    void dispatch(int parts, const std::function<void(int)>& task) {
+        std::unique_lock<std::mutex> dispatchLock(dispatchMutex, std::try_to_lock);
+        if (!dispatchLock.owns_lock()) {
+            for (int part = 0; part < parts; ++part) task(part);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            current = &task;
+            partCount = parts;
+            pending = parts - 1;
+            ++generation;
+        }
+        wake.notify_all();
+
+        task(0);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return pending == 0; });
+        current = nullptr;
+    }
+
+private:
+    void run(int index) {
+        unsigned long long seen = 0;
+        for (;;) {
+            const std::function<void(int)>* task;
+            bool active;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+                task = current;
+                active = index < partCount;
+            }
+            if (!active) continue;
+
+            (*task)(index);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                --pending;
+            }
+            done.notify_one();
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::mutex dispatchMutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const std::function<void(int)>* current = nullptr;
+    unsigned long long generation = 0;
+    int partCount = 0;
+    int pending = 0;
+    bool stopping = false;
+};
+
+ThreadPool& threadPool() {
+    static ThreadPool pool;
+    return pool;
+}
+
+} // namespace
+
+
+int parallelThreadCount() {
+    return threadPool().size();
+}
+
+void parallelFor(size_t count, const std::function<void(size_t, size_t, int)>& body, size_t minimumChunk) {
+    if (count == 0) return;
+    ThreadPool& pool = threadPool();
+    size_t parts = std::min(static_cast<size_t>(pool.size()), (count + minimumChunk - 1) / std::max<size_t>(minimumChunk, 1));
+    if (parts <= 1) {
+        body(0, count, 0);
+        return;
+    }
+
+    // Blnt i parac numarasn da sabitler: para i her zaman i. tamponu kullanr
+    pool.dispatch(static_cast<int>(parts), [&](int part) {
+        size_t begin = count * part / parts;
+        size_t end = count * (part + 1) / parts;
+        body(begin, end, part);
+    });
+}
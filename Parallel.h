@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+
+// Sre boyunca yaayan sabit i parac havuzu. lk kullanmda donanmn i parac says
+// kadar ii alr; aran i parac da 0. ii olarak alr.
+int parallelThreadCount();
+
+// [0, count) araln min(i parac says, ceil(count / minimumChunk)) ardk paraya bler ve
+// her paray body(begin, end, thread) ile altrr; para i her zaman thread = i ile alr.
+// Blnt count, minimumChunk ve makinenin i parac saysna baldr: ayn makinede ayn count
+// her admda ayn aralklar verir, farkl ekirdek saylarnda vermez. Para says count ile
+// deitii iin i parac bana tamponlar ardan nce (hepsi) temizlenmelidir. Kk iler
+// (minimumChunk'tan az) dorudan aran i paracnda alr.
+void parallelFor(size_t count, const std::function<void(size_t, size_t, int)>& body, size_t minimumChunk = 1024);
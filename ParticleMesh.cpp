@@ -0,0 +1,331 @@
+#include "ParticleMesh.h"
+#include "Parallel.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+
+// Tekdze kp hcrenin kendi merkezindeki potansiyeli -2.38 G m / h; serbest uzay ekirdeinde r = 0 iin
+const float kCellSelfPotential = 2.38f;
+
+int meshIndex(int size, int x, int y, int z) {
+    return (z * size + y) * size + x;
+}
+
+// Yerinde, yinelemeli taban-2 FFT. Ters dnm leklenmez; 1 / n^3 arpan Green fonksiyonuna katlr.
+void fft(std::complex<float>* data, int n, const std::vector<std::complex<float>>& twiddles,
+    const std::vector<int>& bitReverse, bool inverse) {
+    for (int i = 0; i < n; ++i) {
+        int j = bitReverse[i];
+        if (i < j) std::swap(data[i], data[j]);
+    }
+    for (int length = 2; length <= n; length <<= 1) {
+        int half = length / 2;
+        int stride = n / length;
+        for (int start = 0; start < n; start += length) {
+            for (int k = 0; k < half; ++k) {
+                std::complex<float> w = twiddles[k * stride];
+                if (inverse) w = std::conj(w);
+                std::complex<float> u = data[start + k];
+                std::complex<float> v = data[start + k + half] * w;
+                data[start + k] = u + v;
+                data[start + k + half] = u - v;
+            }
+        }
+    }
+}
+
+//  eksende srayla 1B dnm. x satrlar bellekte ardktr; y ve z satrlar i paracnn
+// tamponuna toplanp dntrlr ve geri yazlr.
+void fft3d(ParticleMeshState& state, bool inverse) {
+    const int size = state.meshSize;
+    std::complex<float>* mesh = state.mesh.data();
+    const size_t lines = static_cast<size_t>(size) * size;
+
+    parallelFor(lines, [&](size_t begin, size_t end, int) {
+        for (size_t line = begin; line < end; ++line) {
+            fft(mesh + line * size, size, state.twiddles, state.bitReverse, inverse);
+        }
+    }, 16);
+
+    const size_t strides[2] = { static_cast<size_t>(size), lines };
+    for (size_t stride : strides) {
+        parallelFor(lines, [&](size_t begin, size_t end, int thread) {
+            std::vector<std::complex<float>>& buffer = state.threadLines[thread];
+            for (size_t line = begin; line < end; ++line) {
+                // y satr iin line = z * size + x, z satr iin line = y * size + x
+                size_t base = (line / size) * (stride == lines ? size : lines) + line % size;
+                for (int i = 0; i < size; ++i) buffer[i] = mesh[base + i * stride];
+                fft(buffer.data(), size, state.twiddles, state.bitReverse, inverse);
+                for (int i = 0; i < size; ++i) mesh[base + i * stride] = buffer[i];
+            }
+        }, 16);
+    }
+}
+
+// FFT tablolarn ve Green fonksiyonunu zgara, aralk ya da snr tr deitiinde yeniden retir.
+// Radix-2 FFT ve karo boyama ikinin kuvveti ve en az 4 olan bir zgara ister; geersiz gridSize bir
+// st ikinin kuvvetine yuvarlanr. A araln dndrr.
+float prepareParticleMesh(ParticleMeshState& state, float cubeSize) {
+    ParticleMeshSettings& settings = state.settings;
+    assert(settings.gridSize >= 4 && (settings.gridSize & (settings.gridSize - 1)) == 0
+        && "gridSize ikinin kuvveti ve en az 4 olmal");
+    int grid = 4;
+    while (grid < settings.gridSize) grid *= 2;
+    settings.gridSize = grid;
+
+    const float spacing = cubeSize / grid;
+    const int size = settings.periodic ? settings.gridSize : 2 * settings.gridSize;
+    if (size == state.meshSize && spacing == state.cachedSpacing && settings.gravitationalConstant == state.cachedConstant
+        && settings.periodic == state.cachedPeriodic) {
+        return spacing;
+    }
+    state.meshSize = size;
+    state.cachedSpacing = spacing;
+    state.cachedConstant = settings.gravitationalConstant;
+    state.cachedPeriodic = settings.periodic;
+
+    const size_t cells = static_cast<size_t>(size) * size * size;
+    state.density.assign(cells, 0.0f);
+    state.mesh.assign(cells, std::complex<float>(0.0f));
+    state.fieldX.assign(cells, 0.0f);
+    state.fieldY.assign(cells, 0.0f);
+    state.fieldZ.assign(cells, 0.0f);
+    state.greens.assign(cells, 0.0f);
+    state.threadLines.assign(parallelThreadCount(), std::vector<std::complex<float>>(size));
+
+    int bits = 0;
+    while ((1 << bits) < size) ++bits;
+    state.twiddles.resize(size / 2);
+    for (int k = 0; k < size / 2; ++k) {
+        double angle = -2.0 * kPi * k / size;
+        state.twiddles[k] = std::complex<float>(static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)));
+    }
+    state.bitReverse.resize(size);
+    for (int i = 0; i < size; ++i) {
+        int reversed = 0;
+        for (int b = 0; b < bits; ++b) {
+            if (i & (1 << b)) reversed |= 1 << (bits - 1 - b);
+        }
+        state.bitReverse[i] = reversed;
+    }
+
+    const float constant = settings.gravitationalConstant;
+    const float normalisation = 1.0f / static_cast<float>(cells);
+    if (settings.periodic) {
+        // 7 noktal Laplace ilecinin zdeeri: k^2 = sum (2 sin(pi m / n) / h)^2; adaki ktle / h^3 younluktur
+        const float volume = spacing * spacing * spacing;
+        parallelFor(cells, [&](size_t begin, size_t end, int) {
+            for (size_t i = begin; i < end; ++i) {
+                int coordinates[3] = { static_cast<int>(i % size), static_cast<int>((i / size) % size), static_cast<int>(i / (static_cast<size_t>(size) * size)) };
+                double waveSquared = 0.0;
+                for (int coordinate : coordinates) {
+                    double s = 2.0 * std::sin(kPi * coordinate / size) / spacing;
+                    waveSquared += s * s;
+                }
+                state.greens[i] = i == 0 ? 0.0f
+                    : static_cast<float>(-4.0 * kPi * constant / (volume * waveSquared)) * normalisation;
+            }
+        });
+        return spacing;
+    }
+
+    // Hockney: 2n periyotlu ada uzaklklar min(i, 2n - i) alnarak -G / r ekirdei kurulur ve dntrlr
+    parallelFor(cells, [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; ++i) {
+            int coordinates[3] = { static_cast<int>(i % size), static_cast<int>((i / size) % size), static_cast<int>(i / (static_cast<size_t>(size) * size)) };
+            float distanceSquared = 0.0f;
+            for (int coordinate : coordinates) {
+                float d = std::min(coordinate, size - coordinate) * spacing;
+                distanceSquared += d * d;
+            }
+            float potential = i == 0 ? -kCellSelfPotential * constant / spacing : -constant / std::sqrt(distanceSquared);
+            state.mesh[i] = std::complex<float>(potential, 0.0f);
+        }
+    });
+    fft3d(state, false);
+    parallelFor(cells, [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; ++i) {
+            state.greens[i] = state.mesh[i].real() * normalisation;
+        }
+    });
+    return spacing;
+}
+
+// Krenin a koordinat: alt ke dm ve kesirli uzaklk. Periyodikte konum sarlr,
+// deilse kp iine sktrlr ve st dm en fazla gridSize olur.
+void meshCoordinate(const ParticleMeshState& state, const glm::vec3& position, float cubeSize, int lower[3], float fraction[3]) {
+    const int grid = state.settings.gridSize;
+    const float scale = grid / cubeSize;
+    for (int axis = 0; axis < 3; ++axis) {
+        float u = (position[axis] + cubeSize * 0.5f) * scale;
+        if (state.settings.periodic) {
+            u -= grid * std::floor(u / grid);
+            if (u >= grid) u = 0.0f;
+        } else {
+            u = std::min(std::max(u, 0.0f), grid - 1e-3f);
+        }
+        lower[axis] = static_cast<int>(u);
+        fraction[axis] = u - lower[axis];
+    }
+}
+
+// CIC'nin 8 dm; periyodikte st dm gridSize ise 0'a sarlr
+void cloudInCellNodes(const ParticleMeshState& state, const int lower[3], const float fraction[3], int nodes[8], float weights[8]) {
+    const int grid = state.settings.gridSize;
+    int upper[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        upper[axis] = lower[axis] + 1;
+        if (state.settings.periodic && upper[axis] == grid) upper[axis] = 0;
+    }
+    for (int corner = 0; corner < 8; ++corner) {
+        int x = (corner & 1) ? upper[0] : lower[0];
+        int y = (corner & 2) ? upper[1] : lower[1];
+        int z = (corner & 4) ? upper[2] : lower[2];
+        float wx = (corner & 1) ? fraction[0] : 1.0f - fraction[0];
+        float wy = (corner & 2) ? fraction[1] : 1.0f - fraction[1];
+        float wz = (corner & 4) ? fraction[2] : 1.0f - fraction[2];
+        nodes[corner] = meshIndex(state.meshSize, x, y, z);
+        weights[corner] = wx * wy * wz;
+    }
+}
+
+// Kreler alt ke dmlerinin karosuna gre dizilir. Bir karodaki kreler karonun kendisine ve
+// +x, +y, +z ynndeki bir dm katmanna yazar; ayn renkteki karolar arada bir karo bulunduundan
+// (tileSize >= 2 ve karo says ift) akmaz ve kilitsiz paralel ilenebilir.
+void depositMass(const std::vector<Sphere>& spheres, float cubeSize, ParticleMeshState& state) {
+    const int grid = state.settings.gridSize;
+    state.tileSize = std::min(8, grid / 2);
+    const int tilesPerAxis = grid / state.tileSize;
+    const int tiles = tilesPerAxis * tilesPerAxis * tilesPerAxis;
+    const size_t count = spheres.size();
+
+    state.sphereTile.resize(count);
+    parallelFor(count, [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; ++i) {
+            int lower[3];
+            float fraction[3];
+            meshCoordinate(state, spheres[i].position, cubeSize, lower, fraction);
+            state.sphereTile[i] = ((lower[2] / state.tileSize) * tilesPerAxis + lower[1] / state.tileSize) * tilesPerAxis
+                + lower[0] / state.tileSize;
+        }
+    });
+    state.tileStart.assign(tiles + 1, 0);
+    for (size_t i = 0; i < count; ++i) {
+        ++state.tileStart[state.sphereTile[i] + 1];
+    }
+    for (int t = 0; t < tiles; ++t) {
+        state.tileStart[t + 1] += state.tileStart[t];
+    }
+    state.tileEntries.resize(count);
+    std::vector<int> cursor(state.tileStart.begin(), state.tileStart.end() - 1);
+    for (size_t i = 0; i < count; ++i) {
+        state.tileEntries[cursor[state.sphereTile[i]]++] = static_cast<int>(i);
+    }
+
+    std::fill(state.density.begin(), state.density.end(), 0.0f);
+    const int half = tilesPerAxis / 2;
+    for (int colour = 0; colour < 8; ++colour) {
+        parallelFor(static_cast<size_t>(half) * half * half, [&](size_t begin, size_t end, int) {
+            for (size_t slot = begin; slot < end; ++slot) {
+                int tx = 2 * static_cast<int>(slot % half) + (colour & 1);
+                int ty = 2 * static_cast<int>((slot / half) % half) + ((colour >> 1) & 1);
+                int tz = 2 * static_cast<int>(slot / (static_cast<size_t>(half) * half)) + ((colour >> 2) & 1);
+                int tile = (tz * tilesPerAxis + ty) * tilesPerAxis + tx;
+                for (int e = state.tileStart[tile]; e < state.tileStart[tile + 1]; ++e) {
+                    const Sphere& sphere = spheres[state.tileEntries[e]];
+                    int lower[3], nodes[8];
+                    float fraction[3], weights[8];
+                    meshCoordinate(state, sphere.position, cubeSize, lower, fraction);
+                    cloudInCellNodes(state, lower, fraction, nodes, weights);
+                    float mass = sphereMass(sphere.radius);
+                    for (int corner = 0; corner < 8; ++corner) {
+                        state.density[nodes[corner]] += mass * weights[corner];
+                    }
+                }
+            }
+        }, 1);
+    }
+}
+
+// a = -grad(phi), merkezi farklarla; komular a boyunca sarlr
+void computeField(ParticleMeshState& state, float spacing) {
+    const int size = state.meshSize;
+    const float scale = -0.5f / spacing;
+    parallelFor(size, [&](size_t begin, size_t end, int) {
+        for (int z = static_cast<int>(begin); z < static_cast<int>(end); ++z) {
+            int zm = (z + size - 1) % size, zp = (z + 1) % size;
+            for (int y = 0; y < size; ++y) {
+                int ym = (y + size - 1) % size, yp = (y + 1) % size;
+                for (int x = 0; x < size; ++x) {
+                    int xm = (x + size - 1) % size, xp = (x + 1) % size;
+                    int index = meshIndex(size, x, y, z);
+                    state.fieldX[index] = scale * (state.mesh[meshIndex(size, xp, y, z)].real() - state.mesh[meshIndex(size, xm, y, z)].real());
+                    state.fieldY[index] = scale * (state.mesh[meshIndex(size, x, yp, z)].real() - state.mesh[meshIndex(size, x, ym, z)].real());
+                    state.fieldZ[index] = scale * (state.mesh[meshIndex(size, x, y, zp)].real() - state.mesh[meshIndex(size, x, y, zm)].real());
+                }
+            }
+        }
+    }, 1);
+}
+
+} // namespace
+
+
+void computeParticleMeshForces(const std::vector<Sphere>& spheres, float cubeSize, ParticleMeshState& state) {
+    const size_t count = spheres.size();
+    state.accelerationX.assign(count, 0.0f);
+    state.accelerationY.assign(count, 0.0f);
+    state.accelerationZ.assign(count, 0.0f);
+    if (count == 0) return;
+
+    const float spacing = prepareParticleMesh(state, cubeSize);
+    depositMass(spheres, cubeSize, state);
+
+    parallelFor(state.mesh.size(), [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; ++i) {
+            state.mesh[i] = std::complex<float>(state.density[i], 0.0f);
+        }
+    });
+    fft3d(state, false);
+    parallelFor(state.mesh.size(), [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; ++i) {
+            state.mesh[i] *= state.greens[i];
+        }
+    });
+    fft3d(state, true);
+    computeField(state, spacing);
+
+    // Ara deerleme yalnzca okur, kreler dorudan paylatrlr
+    parallelFor(count, [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; ++i) {
+            int lower[3], nodes[8];
+            float fraction[3], weights[8];
+            meshCoordinate(state, spheres[i].position, cubeSize, lower, fraction);
+            cloudInCellNodes(state, lower, fraction, nodes, weights);
+            float ax = 0.0f, ay = 0.0f, az = 0.0f;
+            for (int corner = 0; corner < 8; ++corner) {
+                ax += weights[corner] * state.fieldX[nodes[corner]];
+                ay += weights[corner] * state.fieldY[nodes[corner]];
+                az += weights[corner] * state.fieldZ[nodes[corner]];
+            }
+            state.accelerationX[i] = ax;
+            state.accelerationY[i] = ay;
+            state.accelerationZ[i] = az;
+        }
+    });
+}
+
+void applyParticleMeshForces(std::vector<Sphere>& spheres, float cubeSize, ParticleMeshState& state, float deltaTime) {
+    computeParticleMeshForces(spheres, cubeSize, state);
+    parallelFor(spheres.size(), [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; ++i) {
+            spheres[i].velocity += glm::vec3(state.accelerationX[i], state.accelerationY[i], state.accelerationZ[i]) * deltaTime;
+        }
+    });
+}
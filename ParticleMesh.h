@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Sphere.h"
+#include <complex>
+#include <vector>
+
+
+struct ParticleMeshSettings {
+    bool enabled = false;
+    int gridSize = 64;                   // Kp kenar bana hcre; ikinin kuvveti ve en az 4 olmal, deilse yukar yuvarlanr
+    float gravitationalConstant = 1e-3f;
+    // Periyodik kutuda Green fonksiyonu k uzaynda -4 pi G / k^2'dir (ortalama younluk karlr).
+    // Aksi halde zgara iki katna dolgulanr ve serbest uzay -G / r ekirdei evritirilir (Hockney).
+    bool periodic = false;
+};
+
+// Parack-a (PM) zcnn admlar aras tamponlar. A dmleri kp kesinden balar,
+// aralk h = cubeSize / gridSize; dizi indeksi (z * meshSize + y) * meshSize + x.
+struct ParticleMeshState {
+    ParticleMeshSettings settings;
+
+    // Green fonksiyonu ve FFT tablolar ayar ya da kp boyu deiene kadar saklanr
+    int meshSize = 0; // periyodikte gridSize, deilse 2 * gridSize
+    float cachedSpacing = 0.0f;
+    float cachedConstant = 0.0f;
+    bool cachedPeriodic = false;
+    std::vector<float> greens;
+    std::vector<std::complex<float>> twiddles;
+    std::vector<int> bitReverse;
+
+    std::vector<float> density; // Hcre bana ktle
+    std::vector<std::complex<float>> mesh;
+    std::vector<float> fieldX, fieldY, fieldZ; // Dmlerde ivme
+
+    // Kreler karo numarasna gre sayma sralamasyla dizilir; renk bana karolar paralel ilenir
+    int tileSize = 8;
+    std::vector<int> sphereTile, tileStart, tileEntries;
+    std::vector<std::vector<std::complex<float>>> threadLines;
+
+    // zgn kre srasnda ivmeler
+    std::vector<float> accelerationX, accelerationY, accelerationZ;
+};
+
+// Ktleleri bulut-iinde-hcre (CIC) arlklaryla aa datr, Poisson denklemini aa ii 3B FFT ile
+// zer ve ivmeleri ayn arlklarla krelere geri ara deerler
+void computeParticleMeshForces(const std::vector<Sphere>& spheres, float cubeSize, ParticleMeshState& state);
+
+// vmeleri hesaplar ve hzlara deltaTime boyunca ekler
+void applyParticleMeshForces(std::vector<Sphere>& spheres, float cubeSize, ParticleMeshState& state, float deltaTime);
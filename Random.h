@@ -0,0 +1,116 @@
+#pragma once
+
+#include "Simd.h"
+#include <cstdint>
+
+
+// Saya tabanl rastgele saylar (Philox4x32-10, Salmon ve ark. 2011). kt yalnzca saya ve
+// anahtarn fonksiyonudur: ayn (kre, adm) her zaman ayn saylar verir, bu yzden aklar
+// i parac saysndan ve ilenme srasndan bamszdr. Her SIMD eridi ayr bir sayatr.
+
+// Farkl amalar ayn tohumla akmasn diye anahtarn ikinci kelimesine yazlr
+enum RandomStream : uint32_t {
+    RANDOM_STREAM_LANGEVIN = 1,
+    RANDOM_STREAM_MONTE_CARLO = 2,
+    RANDOM_STREAM_EMITTER = 3,
+};
+
+struct SimdPhilox {
+    SimdInt word[4];
+};
+
+inline SimdPhilox philox4x32(SimdPhilox counter, uint32_t key0, uint32_t key1) {
+    const uint32_t multiplier0 = 0xD2511F53u, multiplier1 = 0xCD9E8D57u;
+    const uint32_t weyl0 = 0x9E3779B9u, weyl1 = 0xBB67AE85u;
+    for (int round = 0; round < 10; ++round) {
+        SimdInt hi0, lo0, hi1, lo1;
+        simdMulHiLo(counter.word[0], multiplier0, hi0, lo0);
+        simdMulHiLo(counter.word[2], multiplier1, hi1, lo1);
+        SimdPhilox next;
+        next.word[0] = simdXorInt(simdXorInt(hi1, counter.word[1]), simdSetInt(static_cast<int>(key0)));
+        next.word[1] = lo1;
+        next.word[2] = simdXorInt(simdXorInt(hi0, counter.word[3]), simdSetInt(static_cast<int>(key1)));
+        next.word[3] = lo0;
+        counter = next;
+        key0 += weyl0;
+        key1 += weyl1;
+    }
+    return counter;
+}
+
+// st 23 biti [1, 2) aralnda bir float'n mantisine yerletirir
+inline SimdFloat simdOneToTwo(SimdInt bits) {
+    return simdAsFloat(simdOrInt(simdShiftRightInt(bits, 9), simdSetInt(0x3f800000)));
+}
+
+// Doal logaritma, x > 0 (Cephes logf polinomu, greli hata ~1e-7)
+inline SimdFloat simdLog(SimdFloat x) {
+    SimdInt bits = simdAsInt(x);
+    SimdFloat exponent = simdToFloat(simdShiftRightInt(bits, 23) - simdSetInt(126));
+    SimdFloat mantissa = simdAsFloat(simdOrInt(simdAndInt(bits, simdSetInt(0x007fffff)), simdSetInt(0x3f000000))); // [0.5, 1)
+
+    // Mantis sqrt(1/2)'den kkse iki katna karlr, bylece m - 1 aral [-0.29, 0.41] olur
+    SimdFloat small = simdLess(mantissa, simdSet(0.70710678f));
+    exponent = exponent - simdSelect(small, simdSet(1.0f), simdSet(0.0f));
+    SimdFloat m = mantissa + simdSelect(small, mantissa, simdSet(0.0f)) - simdSet(1.0f);
+
+    SimdFloat z = m * m;
+    SimdFloat y = simdSet(7.0376836292e-2f);
+    y = y * m - simdSet(1.1514610310e-1f);
+    y = y * m + simdSet(1.1676998740e-1f);
+    y = y * m - simdSet(1.2420140846e-1f);
+    y = y * m + simdSet(1.4249322787e-1f);
+    y = y * m - simdSet(1.6668057665e-1f);
+    y = y * m + simdSet(2.0000714765e-1f);
+    y = y * m - simdSet(2.4999993993e-1f);
+    y = y * m + simdSet(3.3333331174e-1f);
+    y = y * m * z - simdSet(2.12194440e-4f) * exponent - simdSet(0.5f) * z;
+    return m + y + simdSet(0.693359375f) * exponent;
+}
+
+// sin(2 pi t), t in [-0.5, 0.5]. |t| > 1/4 ise sin(pi - x) = sin(x) ile eyrek tura katlanr,
+// ardndan 11. derece Taylor serisi (hata < 1e-7)
+inline SimdFloat simdSinTurns(SimdFloat t) {
+    SimdFloat half = simdSelect(simdGreater(t, simdSet(0.0f)), simdSet(0.5f), simdSet(-0.5f));
+    SimdFloat folded = simdSelect(simdGreater(simdAbs(t), simdSet(0.25f)), half - t, t);
+    SimdFloat x = folded * simdSet(6.28318531f);
+    SimdFloat x2 = x * x;
+    SimdFloat one = simdSet(1.0f);
+    SimdFloat series = one - x2 * simdSet(1.0f / 110.0f);
+    series = one - x2 * simdSet(1.0f / 72.0f) * series;
+    series = one - x2 * simdSet(1.0f / 42.0f) * series;
+    series = one - x2 * simdSet(1.0f / 20.0f) * series;
+    series = one - x2 * simdSet(1.0f / 6.0f) * series;
+    return x * series;
+}
+
+// erit bana drt rastgele kelime: saya (index, adm, admn st kelimesi, generation),
+// anahtar (seed, stream). generation, yeniden kullanlan bir index'in eski ak tekrarlamamas iindir.
+inline SimdPhilox simdRandomBits(SimdInt index, uint64_t step, uint32_t seed, uint32_t stream,
+    SimdInt generation = simdSetInt(0)) {
+    SimdPhilox counter;
+    counter.word[0] = index;
+    counter.word[1] = simdSetInt(static_cast<int>(static_cast<uint32_t>(step)));
+    counter.word[2] = simdSetInt(static_cast<int>(static_cast<uint32_t>(step >> 32)));
+    counter.word[3] = generation;
+    return philox4x32(counter, seed, stream);
+}
+
+// erit bana drt bamsz standart normal say.
+// BoxMuller: iki dzgn saydan r = sqrt(-2 ln u1), a 2 pi u2 ile bir ift.
+inline void simdGaussians(SimdInt index, uint64_t step, uint32_t seed, uint32_t stream, SimdFloat normals[4],
+    SimdInt generation = simdSetInt(0)) {
+    SimdPhilox random = simdRandomBits(index, step, seed, stream, generation);
+
+    for (int pair = 0; pair < 2; ++pair) {
+        // u1 = 2 - [1, 2) aral (0, 1] verir, ln 0 olumaz; a [-0.5, 0.5) tur
+        SimdFloat u1 = simdSet(2.0f) - simdOneToTwo(random.word[2 * pair]);
+        SimdFloat turns = simdOneToTwo(random.word[2 * pair + 1]) - simdSet(1.5f);
+        SimdFloat radius = simdSqrt(simdSet(-2.0f) * simdLog(u1));
+        // cos(2 pi t) = sin(2 pi (t + 1/4)); aralk dna taan deerler bir tur geri alnr
+        SimdFloat shifted = turns + simdSet(0.25f);
+        shifted = shifted - simdSelect(simdGreater(shifted, simdSet(0.5f)), simdSet(1.0f), simdSet(0.0f));
+        normals[2 * pair] = radius * simdSinTurns(shifted);
+        normals[2 * pair + 1] = radius * simdSinTurns(turns);
+    }
+}
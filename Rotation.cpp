@@ -0,0 +1,113 @@
+#include "Rotation.h"
+#include "Simd.h"
+#include "Sphere.h"
+
+#include <algorithm>
+
+
+void resizeRotationState(RotationState& rotation, size_t count) {
+    if (rotation.count == count) return;
+
+    size_t padded = (count + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH;
+    rotation.angularX.resize(padded, 0.0f);
+    rotation.angularY.resize(padded, 0.0f);
+    rotation.angularZ.resize(padded, 0.0f);
+    rotation.orientationW.resize(padded, 1.0f);
+    rotation.orientationX.resize(padded, 0.0f);
+    rotation.orientationY.resize(padded, 0.0f);
+    rotation.orientationZ.resize(padded, 0.0f);
+    rotation.count = count;
+}
+
+void integrateOrientations(RotationState& rotation, float deltaTime) {
+    const SimdFloat halfStep = simdSet(0.5f * deltaTime);
+    const SimdFloat one = simdSet(1.0f);
+    const size_t padded = rotation.angularX.size();
+
+    for (size_t i = 0; i < padded; i += SIMD_WIDTH) {
+        SimdFloat wx = simdLoad(&rotation.angularX[i]);
+        SimdFloat wy = simdLoad(&rotation.angularY[i]);
+        SimdFloat wz = simdLoad(&rotation.angularZ[i]);
+        SimdFloat qw = simdLoad(&rotation.orientationW[i]);
+        SimdFloat qx = simdLoad(&rotation.orientationX[i]);
+        SimdFloat qy = simdLoad(&rotation.orientationY[i]);
+        SimdFloat qz = simdLoad(&rotation.orientationZ[i]);
+
+        // (0, w) * q
+        SimdFloat dw = simdSet(0.0f) - simdDot(wx, wy, wz, qx, qy, qz);
+        SimdFloat dx = qw * wx + wy * qz - wz * qy;
+        SimdFloat dy = qw * wy + wz * qx - wx * qz;
+        SimdFloat dz = qw * wz + wx * qy - wy * qx;
+
+        qw = qw + halfStep * dw;
+        qx = qx + halfStep * dx;
+        qy = qy + halfStep * dy;
+        qz = qz + halfStep * dz;
+
+        SimdFloat inverseLength = one / simdSqrt(qw * qw + simdDot(qx, qy, qz, qx, qy, qz));
+        simdStore(&rotation.orientationW[i], qw * inverseLength);
+        simdStore(&rotation.orientationX[i], qx * inverseLength);
+        simdStore(&rotation.orientationY[i], qy * inverseLength);
+        simdStore(&rotation.orientationZ[i], qz * inverseLength);
+    }
+}
+
+glm::quat sphereOrientation(const RotationState& rotation, size_t index) {
+    return glm::quat(rotation.orientationW[index], rotation.orientationX[index], rotation.orientationY[index], rotation.orientationZ[index]);
+}
+
+glm::vec3 sphereAngularVelocity(const RotationState& rotation, size_t index) {
+    return glm::vec3(rotation.angularX[index], rotation.angularY[index], rotation.angularZ[index]);
+}
+
+void addAngularVelocity(RotationState& rotation, size_t index, const glm::vec3& delta) {
+    rotation.angularX[index] += delta.x;
+    rotation.angularY[index] += delta.y;
+    rotation.angularZ[index] += delta.z;
+}
+
+void copySphereRotation(RotationState& rotation, size_t from, size_t to) {
+    for (std::vector<float>* array : { &rotation.angularX, &rotation.angularY, &rotation.angularZ, &rotation.orientationW,
+                                       &rotation.orientationX, &rotation.orientationY, &rotation.orientationZ }) {
+        (*array)[to] = (*array)[from];
+    }
+}
+
+void permuteSphereRotation(RotationState& rotation, const std::vector<int>& order, std::vector<float>& scratch) {
+    for (std::vector<float>* array : { &rotation.angularX, &rotation.angularY, &rotation.angularZ, &rotation.orientationW,
+                                       &rotation.orientationX, &rotation.orientationY, &rotation.orientationZ }) {
+        scratch.assign(array->begin(), array->end());
+        for (size_t i = 0; i < order.size(); ++i) {
+            (*array)[i] = scratch[order[i]];
+        }
+    }
+}
+
+void resetSphereRotation(RotationState& rotation, size_t index) {
+    rotation.angularX[index] = 0.0f;
+    rotation.angularY[index] = 0.0f;
+    rotation.angularZ[index] = 0.0f;
+    rotation.orientationW[index] = 1.0f;
+    rotation.orientationX[index] = 0.0f;
+    rotation.orientationY[index] = 0.0f;
+    rotation.orientationZ[index] = 0.0f;
+}
+
+void applyWallFriction(RotationState& rotation, size_t s, float radius, const glm::vec3& normal, float normalSpeed,
+    float restitution, float friction, const glm::mat3& basis, glm::vec3& velocity, glm::vec3& angular) {
+    glm::vec3 lever = normal * radius;
+    glm::vec3 slip = velocity + glm::cross(angular, lever);
+    slip -= normal * glm::dot(slip, normal);
+    float slipSpeed = glm::length(slip);
+    if (slipSpeed > 0.0f) {
+        float inverseMass = 1.0f / sphereMass(radius);
+        float stopImpulse = slipSpeed / ((1.0f + 1.0f / SPHERE_INERTIA_FACTOR) * inverseMass);
+        float frictionImpulse = std::min(friction * (1.0f + restitution) * normalSpeed / inverseMass, stopImpulse);
+        glm::vec3 impulse = -slip * (frictionImpulse / slipSpeed);
+        velocity += impulse * inverseMass;
+        float spin = inverseMass / (SPHERE_INERTIA_FACTOR * radius * radius);
+        glm::vec3 angularChange = glm::cross(lever, impulse) * spin;
+        angular += angularChange;
+        addAngularVelocity(rotation, s, basis * angularChange);
+    }
+}
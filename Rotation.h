@@ -0,0 +1,40 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <vector>
+
+
+// Kat kre eylemsizlik momenti: I = 2/5 m r^2
+const float SPHERE_INERTIA_FACTOR = 0.4f;
+
+// Krelerin dnme durumu, kre indeksine gre ayr dizilerde (SoA). Diziler SIMD_WIDTH katna
+// tamamlanr, bylece integratr kuyruk dngs olmadan 8'er kre iler.
+struct RotationState {
+    size_t count = 0;
+    std::vector<float> angularX, angularY, angularZ;                      // Asal hz (rad/s)
+    std::vector<float> orientationW, orientationX, orientationY, orientationZ; // Birim kuaterniyon
+};
+
+// Yeni kreler birim ynelim ve sfr asal hzla balar
+void resizeRotationState(RotationState& rotation, size_t count);
+
+// q' = q + dt/2 * (0, w) * q, ardndan normalize; tamamen SIMD
+void integrateOrientations(RotationState& rotation, float deltaTime);
+
+glm::quat sphereOrientation(const RotationState& rotation, size_t index);
+glm::vec3 sphereAngularVelocity(const RotationState& rotation, size_t index);
+void addAngularVelocity(RotationState& rotation, size_t index, const glm::vec3& delta);
+
+// Havuzdan karma ve ekleme iin tek krenin durumunu tar ya da birim ynelime dndrr
+void copySphereRotation(RotationState& rotation, size_t from, size_t to);
+void resetSphereRotation(RotationState& rotation, size_t index);
+
+// Tm kreleri yeniden dizer: yeni i. kre eski order[i]. kredir (scratch ara tampondur)
+void permuteSphereRotation(RotationState& rotation, const std::vector<int>& order, std::vector<float>& scratch);
+
+// Sabit bir yzeyle (duvar, gen a) temasta srtnme: temas noktas yzey boyunca kayyorsa Coulomb
+// snryla hem teleme hem dnme hz azaltlr. normal krenin merkezinden yzeye bakar; hz ve asal
+// hz basis'in erevesindedir, dnme deiimi basis ile dnyaya evrilerek rotation'a da eklenir.
+void applyWallFriction(RotationState& rotation, size_t s, float radius, const glm::vec3& normal, float normalSpeed,
+    float restitution, float friction, const glm::mat3& basis, glm::vec3& velocity, glm::vec3& angular);
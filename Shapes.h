@@ -0,0 +1,52 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+
+// Kapsl: yerel y ekseni boyunca 2 * halfLength uzunluunda bir doru parasnn radius kadar iirilmii
+struct Capsule {
+    glm::vec3 position;
+    glm::quat orientation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    float halfLength;
+    float radius;
+    glm::vec3 color;
+    glm::vec3 velocity;
+    int material = 0;
+    bool fixed = false; // Sabit ekiller sonsuz ktleli kabul edilir ve itmelerden etkilenmez
+};
+
+// Ynlendirilmi kutu (OBB); halfExtents yerel eksenlerdeki yar boyutlar
+struct Box {
+    glm::vec3 position;
+    glm::quat orientation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    glm::vec3 halfExtents;
+    glm::vec3 color;
+    glm::vec3 velocity;
+    int material = 0;
+    bool fixed = false;
+};
+
+// Krelerle ayn younluk: ktle = hacim * 3 / (4 pi), bylece sphereMass(r) = r^3 ile tutarl
+inline float capsuleMass(const Capsule& capsule) {
+    float r = capsule.radius;
+    return r * r * r + 1.5f * r * r * capsule.halfLength;
+}
+
+inline float boxMass(const Box& box) {
+    return 6.0f / 3.14159265f * box.halfExtents.x * box.halfExtents.y * box.halfExtents.z;
+}
+
+// Kapsl ekseninin dnya koordinatlarndaki yars: u noktalar position +- capsuleHalfAxis
+inline glm::vec3 capsuleHalfAxis(const Capsule& capsule) {
+    return capsule.orientation * glm::vec3(0.0f, capsule.halfLength, 0.0f);
+}
+
+// ekli tamamen ieren krenin yarap (geni faz iin)
+inline float capsuleBoundingRadius(const Capsule& capsule) {
+    return capsule.halfLength + capsule.radius;
+}
+
+inline float boxBoundingRadius(const Box& box) {
+    return glm::length(box.halfExtents);
+}
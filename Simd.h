@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+
+// 8 eritli kayan nokta ve tamsay vektrleri. AVX2 ile derlenirse (/arch:AVX2) dorudan
+// intrinsic'lere iner, aksi halde ayn arayz derleyicinin vektrletirebilecei dnglerle salar.
+const int SIMD_WIDTH = 8;
+
+#if defined(__AVX2__)
+
+struct SimdFloat { __m256 v; };
+struct SimdInt { __m256i v; };
+
+inline SimdFloat simdSet(float x) { return { _mm256_set1_ps(x) }; }
+inline SimdFloat simdLoad(const float* p) { return { _mm256_loadu_ps(p) }; }
+inline void simdStore(float* p, SimdFloat a) { _mm256_storeu_ps(p, a.v); }
+inline SimdFloat simdGather(const float* base, SimdInt index) { return { _mm256_i32gather_ps(base, index.v, 4) }; }
+
+inline SimdFloat operator+(SimdFloat a, SimdFloat b) { return { _mm256_add_ps(a.v, b.v) }; }
+inline SimdFloat operator-(SimdFloat a, SimdFloat b) { return { _mm256_sub_ps(a.v, b.v) }; }
+inline SimdFloat operator*(SimdFloat a, SimdFloat b) { return { _mm256_mul_ps(a.v, b.v) }; }
+inline SimdFloat operator/(SimdFloat a, SimdFloat b) { return { _mm256_div_ps(a.v, b.v) }; }
+inline SimdFloat simdMin(SimdFloat a, SimdFloat b) { return { _mm256_min_ps(a.v, b.v) }; }
+inline SimdFloat simdMax(SimdFloat a, SimdFloat b) { return { _mm256_max_ps(a.v, b.v) }; }
+inline SimdFloat simdSqrt(SimdFloat a) { return { _mm256_sqrt_ps(a.v) }; }
+inline SimdFloat simdRound(SimdFloat a) { return { _mm256_round_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC) }; }
+inline SimdFloat simdLaneIndex() { return { _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f) }; }
+
+// Karlatrmalar tm bitleri 1 olan erit maskeleri dndrr
+inline SimdFloat simdLess(SimdFloat a, SimdFloat b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ) }; }
+inline SimdFloat simdGreater(SimdFloat a, SimdFloat b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ) }; }
+inline SimdFloat simdAnd(SimdFloat a, SimdFloat b) { return { _mm256_and_ps(a.v, b.v) }; }
+inline SimdFloat simdOr(SimdFloat a, SimdFloat b) { return { _mm256_or_ps(a.v, b.v) }; }
+inline SimdFloat simdSelect(SimdFloat mask, SimdFloat a, SimdFloat b) { return { _mm256_blendv_ps(b.v, a.v, mask.v) }; }
+inline int simdMoveMask(SimdFloat mask) { return _mm256_movemask_ps(mask.v); }
+
+inline SimdInt simdSetInt(int x) { return { _mm256_set1_epi32(x) }; }
+inline SimdInt simdLoadInt(const int* p) { return { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)) }; }
+inline void simdStoreInt(int* p, SimdInt a) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), a.v); }
+inline SimdInt simdGatherInt(const int* base, SimdInt index) { return { _mm256_i32gather_epi32(base, index.v, 4) }; }
+inline SimdInt operator+(SimdInt a, SimdInt b) { return { _mm256_add_epi32(a.v, b.v) }; }
+inline SimdInt operator*(SimdInt a, SimdInt b) { return { _mm256_mullo_epi32(a.v, b.v) }; }
+inline SimdInt operator-(SimdInt a, SimdInt b) { return { _mm256_sub_epi32(a.v, b.v) }; }
+
+// Bit dzeyi ilemler; kaydrma iaretsizdir
+inline SimdInt simdAndInt(SimdInt a, SimdInt b) { return { _mm256_and_si256(a.v, b.v) }; }
+inline SimdInt simdOrInt(SimdInt a, SimdInt b) { return { _mm256_or_si256(a.v, b.v) }; }
+inline SimdInt simdXorInt(SimdInt a, SimdInt b) { return { _mm256_xor_si256(a.v, b.v) }; }
+inline SimdInt simdShiftRightInt(SimdInt a, int bits) { return { _mm256_srl_epi32(a.v, _mm_cvtsi32_si128(bits)) }; }
+inline SimdInt simdAsInt(SimdFloat a) { return { _mm256_castps_si256(a.v) }; }
+inline SimdFloat simdAsFloat(SimdInt a) { return { _mm256_castsi256_ps(a.v) }; }
+inline SimdFloat simdToFloat(SimdInt a) { return { _mm256_cvtepi32_ps(a.v) }; }
+inline SimdInt simdToInt(SimdFloat a) { return { _mm256_cvttps_epi32(a.v) }; } // Sfra doru keser
+
+// aretsiz 32x32 -> 64 bit arpm: AVX2 yalnzca ift eritleri arptndan tek eritler kaydrlp ayrca arplr
+inline void simdMulHiLo(SimdInt a, uint32_t b, SimdInt& hi, SimdInt& lo) {
+    __m256i multiplier = _mm256_set1_epi32(static_cast<int>(b));
+    __m256i even = _mm256_mul_epu32(a.v, multiplier);
+    __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a.v, 32), multiplier);
+    lo.v = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+    hi.v = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+}
+
+#else
+
+struct SimdFloat { float v[SIMD_WIDTH]; };
+struct SimdInt { int32_t v[SIMD_WIDTH]; };
+
+#define SIMD_LANES(expr) for (int lane = 0; lane < SIMD_WIDTH; ++lane) { expr; }
+
+inline SimdFloat simdSet(float x) { SimdFloat r; SIMD_LANES(r.v[lane] = x) return r; }
+inline SimdFloat simdLoad(const float* p) { SimdFloat r; SIMD_LANES(r.v[lane] = p[lane]) return r; }
+inline void simdStore(float* p, SimdFloat a) { SIMD_LANES(p[lane] = a.v[lane]) }
+inline SimdFloat simdGather(const float* base, SimdInt index) { SimdFloat r; SIMD_LANES(r.v[lane] = base[index.v[lane]]) return r; }
+
+inline SimdFloat operator+(SimdFloat a, SimdFloat b) { SimdFloat r; SIMD_LANES(r.v[lane] = a.v[lane] + b.v[lane]) return r; }
+inline SimdFloat operator-(SimdFloat a, SimdFloat b) { SimdFloat r; SIMD_LANES(r.v[lane] = a.v[lane] - b.v[lane]) return r; }
+inline SimdFloat operator*(SimdFloat a, SimdFloat b) { SimdFloat r; SIMD_LANES(r.v[lane] = a.v[lane] * b.v[lane]) return r; }
+inline SimdFloat operator/(SimdFloat a, SimdFloat b) { SimdFloat r; SIMD_LANES(r.v[lane] = a.v[lane] / b.v[lane]) return r; }
+inline SimdFloat simdMin(SimdFloat a, SimdFloat b) { SimdFloat r; SIMD_LANES(r.v[lane] = a.v[lane] < b.v[lane] ? a.v[lane] : b.v[lane]) return r; }
+inline SimdFloat simdMax(SimdFloat a, SimdFloat b) { SimdFloat r; SIMD_LANES(r.v[lane] = a.v[lane] > b.v[lane] ? a.v[lane] : b.v[lane]) return r; }
+inline SimdFloat simdSqrt(SimdFloat a) { SimdFloat r; SIMD_LANES(r.v[lane] = std::sqrt(a.v[lane])) return r; }
+inline SimdFloat simdRound(SimdFloat a) { SimdFloat r; SIMD_LANES(r.v[lane] = std::nearbyint(a.v[lane])) return r; }
+inline SimdFloat simdLaneIndex() { SimdFloat r; SIMD_LANES(r.v[lane] = static_cast<float>(lane)) return r; }
+
+// Maskeler, AVX2 yolundaki gibi tm bitleri 1 olan eritlerle temsil edilir
+inline float simdMaskBits(bool b) { uint32_t bits = b ? 0xFFFFFFFFu : 0u; float f; std::memcpy(&f, &bits, 4); return f; }
+inline uint32_t simdBits(float f) { uint32_t bits; std::memcpy(&bits, &f, 4); return bits; }
+inline float simdFromBits(uint32_t bits) { float f; std::memcpy(&f, &bits, 4); return f; }
+
+inline SimdFloat simdLess(SimdFloat a, SimdFloat b) { SimdFloat r; SIMD_LANES(r.v[lane] = simdMaskBits(a.v[lane] < b.v[lane])) return r; }
+inline SimdFloat simdGreater(SimdFloat a, SimdFloat b) { SimdFloat r; SIMD_LANES(r.v[lane] = simdMaskBits(a.v[lane] > b.v[lane])) return r; }
+inline SimdFloat simdAnd(SimdFloat a, SimdFloat b) { SimdFloat r; SIMD_LANES(r.v[lane] = simdFromBits(simdBits(a.v[lane]) & simdBits(b.v[lane]))) return r; }
+inline SimdFloat simdOr(SimdFloat a, SimdFloat b) { SimdFloat r; SIMD_LANES(r.v[lane] = simdFromBits(simdBits(a.v[lane]) | simdBits(b.v[lane]))) return r; }
+inline SimdFloat simdSelect(SimdFloat mask, SimdFloat a, SimdFloat b) { SimdFloat r; SIMD_LANES(r.v[lane] = simdBits(mask.v[lane]) ? a.v[lane] : b.v[lane]) return r; }
+inline int simdMoveMask(SimdFloat mask) { int bits = 0; SIMD_LANES(bits |= (simdBits(mask.v[lane]) >> 31) << lane) return bits; }
+
+inline SimdInt simdSetInt(int x) { SimdInt r; SIMD_LANES(r.v[lane] = x) return r; }
+inline SimdInt simdLoadInt(const int* p) { SimdInt r; SIMD_LANES(r.v[lane] = p[lane]) return r; }
+inline void simdStoreInt(int* p, SimdInt a) { SIMD_LANES(p[lane] = a.v[lane]) }
+inline SimdInt simdGatherInt(const int* base, SimdInt index) { SimdInt r; SIMD_LANES(r.v[lane] = base[index.v[lane]]) return r; }
+inline SimdInt operator+(SimdInt a, SimdInt b) { SimdInt r; SIMD_LANES(r.v[lane] = a.v[lane] + b.v[lane]) return r; }
+inline SimdInt operator*(SimdInt a, SimdInt b) { SimdInt r; SIMD_LANES(r.v[lane] = static_cast<int32_t>(static_cast<uint32_t>(a.v[lane]) * static_cast<uint32_t>(b.v[lane]))) return r; }
+inline SimdInt operator-(SimdInt a, SimdInt b) { SimdInt r; SIMD_LANES(r.v[lane] = static_cast<int32_t>(static_cast<uint32_t>(a.v[lane]) - static_cast<uint32_t>(b.v[lane]))) return r; }
+
+inline SimdInt simdAndInt(SimdInt a, SimdInt b) { SimdInt r; SIMD_LANES(r.v[lane] = a.v[lane] & b.v[lane]) return r; }
+inline SimdInt simdOrInt(SimdInt a, SimdInt b) { SimdInt r; SIMD_LANES(r.v[lane] = a.v[lane] | b.v[lane]) return r; }
+inline SimdInt simdXorInt(SimdInt a, SimdInt b) { SimdInt r; SIMD_LANES(r.v[lane] = a.v[lane] ^ b.v[lane]) return r; }
+inline SimdInt simdShiftRightInt(SimdInt a, int bits) { SimdInt r; SIMD_LANES(r.v[lane] = static_cast<int32_t>(static_cast<uint32_t>(a.v[lane]) >> bits)) return r; }
+inline SimdInt simdAsInt(SimdFloat a) { SimdInt r; SIMD_LANES(r.v[lane] = static_cast<int32_t>(simdBits(a.v[lane]))) return r; }
+inline SimdFloat simdAsFloat(SimdInt a) { SimdFloat r; SIMD_LANES(r.v[lane] = simdFromBits(static_cast<uint32_t>(a.v[lane]))) return r; }
+inline SimdFloat simdToFloat(SimdInt a) { SimdFloat r; SIMD_LANES(r.v[lane] = static_cast<float>(a.v[lane])) return r; }
+inline SimdInt simdToInt(SimdFloat a) { SimdInt r; SIMD_LANES(r.v[lane] = static_cast<int32_t>(a.v[lane])) return r; }
+
+inline void simdMulHiLo(SimdInt a, uint32_t b, SimdInt& hi, SimdInt& lo) {
+    SIMD_LANES(uint64_t product = static_cast<uint64_t>(static_cast<uint32_t>(a.v[lane])) * b;
+        hi.v[lane] = static_cast<int32_t>(product >> 32); lo.v[lane] = static_cast<int32_t>(product))
+}
+
+#undef SIMD_LANES
+
+#endif
+
+inline SimdFloat simdDot(SimdFloat ax, SimdFloat ay, SimdFloat az, SimdFloat bx, SimdFloat by, SimdFloat bz) {
+    return ax * bx + ay * by + az * bz;
+}
+
+inline SimdFloat simdAbs(SimdFloat a) {
+    return simdMax(a, simdSet(0.0f) - a);
+}
+
+inline SimdFloat simdClamp(SimdFloat a, SimdFloat lo, SimdFloat hi) {
+    return simdMin(simdMax(a, lo), hi);
+}
@@ -0,0 +1,377 @@
+#include "Simulation.h"
+#include "Parallel.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+
+namespace {
+
+// Kapsl ve kutular iin duvar tepkisi: extent, eklin her eksendeki yar geniliidir.
+// Yalnzca duvara doru giden hz yanstlr; srtnme teet hz Coulomb snryla azaltr.
+void bounceShapeOffWalls(glm::vec3& position, glm::vec3& velocity, const glm::vec3& extent,
+    float halfCubeSize, float restitution, float friction) {
+    for (int i = 0; i < 3; ++i) {
+        bool positiveWall = position[i] + extent[i] > halfCubeSize && velocity[i] > 0.0f;
+        bool negativeWall = position[i] - extent[i] < -halfCubeSize && velocity[i] < 0.0f;
+        if (!positiveWall && !negativeWall) continue;
+
+        float normalSpeed = std::abs(velocity[i]);
+        velocity[i] *= -restitution;
+        glm::vec3 tangent = velocity;
+        tangent[i] = 0.0f;
+        float tangentSpeed = glm::length(tangent);
+        if (tangentSpeed > 0.0f) {
+            float reduction = std::min(friction * (1.0f + restitution) * normalSpeed, tangentSpeed);
+            velocity -= tangent * (reduction / tangentSpeed);
+        }
+    }
+}
+
+// bounceOffBoxWalls'tan gemi erevenin temaslar iin srtnme, dnme ve dnyaya geri yazma.
+// originOf krenin kabnn merkezini verir (tek kapta hep container.position).
+template <typename OriginOf>
+void finishBoxWallContacts(std::vector<Sphere>& spheres, SimulationContext& context, const Container& container,
+    OriginOf originOf) {
+    const ContainerFrame& frame = context.containerFrame;
+    const glm::mat3 basis = glm::mat3_cast(container.orientation);
+    const glm::mat3 toLocal = glm::transpose(basis);
+    const int wallRow = context.wallMaterial * MAX_MATERIALS;
+    for (int s : frame.contacts) {
+        Sphere& sphere = spheres[s];
+        float restitution = context.materials.restitution[wallRow + sphere.material];
+        float friction = context.materials.friction[wallRow + sphere.material];
+        glm::vec3 position(frame.positionX[s], frame.positionY[s], frame.positionZ[s]);
+        glm::vec3 velocity(frame.velocityX[s], frame.velocityY[s], frame.velocityZ[s]); // Duvara gre
+        glm::vec3 impact(frame.impactX[s], frame.impactY[s], frame.impactZ[s]);
+        glm::vec3 angular = toLocal * (sphereAngularVelocity(context.rotation, s) - container.angularVelocity);
+        for (int i = 0; i < 3; ++i) {
+            if (impact[i] == 0.0f) continue;
+            glm::vec3 normal(0.0f);
+            normal[i] = impact[i] > 0.0f ? 1.0f : -1.0f;
+            applyWallFriction(context.rotation, s, sphere.radius, normal, std::abs(impact[i]), restitution, friction,
+                basis, velocity, angular);
+        }
+        sphere.position = originOf(s) + basis * position;
+        sphere.velocity = basis * velocity + containerPointVelocity(container, sphere.position);
+    }
+}
+
+// Tek krenin kutu duvar tepkisi (duvar takviminin seyrek listesi iin). position ve velocity kap
+// erevesindedir, hz duvara grelidir; ikisi de tepkiden sonraki deerlerle gncellenir.
+void bounceSphereOffBox(std::vector<Sphere>& spheres, SimulationContext& context, int s, glm::vec3& position,
+    glm::vec3& velocity, float halfCubeSize, const glm::mat3& basis) {
+    const Container& container = context.container;
+    Sphere& sphere = spheres[s];
+    const int wallRow = context.wallMaterial * MAX_MATERIALS;
+    float restitution = context.materials.restitution[wallRow + sphere.material];
+    float friction = context.materials.friction[wallRow + sphere.material];
+    // Kayma, krenin duvara gre dnmesinden gelir
+    glm::vec3 angular = glm::transpose(basis) * (sphereAngularVelocity(context.rotation, s) - container.angularVelocity);
+
+    const float limit = halfCubeSize - sphere.radius;
+    for (int i = 0; i < 3; ++i) {
+        // bounceOffBoxWalls ile ayn kural: yalnzca duvara doru giden hz yansr, konum ieri kstrlr
+        bool positiveWall = position[i] > limit && velocity[i] > 0.0f;
+        bool negativeWall = position[i] < -limit && velocity[i] < 0.0f;
+        position[i] = glm::clamp(position[i], -limit, limit);
+        if (!positiveWall && !negativeWall) continue;
+
+        float normalSpeed = std::abs(velocity[i]);
+        velocity[i] *= -restitution;
+        glm::vec3 normal(0.0f);
+        normal[i] = positiveWall ? 1.0f : -1.0f;
+        applyWallFriction(context.rotation, s, sphere.radius, normal, normalSpeed, restitution, friction,
+            basis, velocity, angular);
+    }
+    sphere.position = container.position + basis * position;
+    sphere.velocity = basis * velocity + containerPointVelocity(container, sphere.position);
+}
+
+// Duvar takvimi yalnzca sabit kutu duvarlarnda ve kre hzlarn yalnzca kre-kre arpmalarnn
+// (ve sabit d ivmenin) deitirdii sahnelerde geerlidir; dier durumlarda tm kreler taranr.
+bool usesWallSchedule(const SimulationContext& context, float deltaTime) {
+    const Container& container = context.container;
+    return context.wallSchedule.enabled && deltaTime > 0.0f
+        && context.boundary == BOUNDARY_WALLS && !context.distanceField.enabled
+        && container.velocity == glm::vec3(0.0f) && container.angularVelocity == glm::vec3(0.0f)
+        && context.mode == SIMULATION_IMPULSE && context.batch.origins.empty()
+        && context.capsules.empty() && context.boxes.empty() && context.clumps.count == 0 && context.meshes.empty()
+        && !context.gravity.settings.enabled && !context.particleMesh.settings.enabled;
+}
+
+// Takvim dnda geen admlardan sonra tahminler geersizdir; dueStep boalnca takvim ilk
+// kullanmda sfrlanr
+void dropWallPredictions(WallSchedule& schedule) {
+    schedule.dueStep.clear();
+    schedule.invalidated.clear();
+}
+
+// Uzaklk alan temaslar: normal i blgeye bakar. Duvar eksenlere hizal olmadndan hzn normal
+// bileeni yanstlr, yalnzca duvara doru gidiyorsa; kre alann yzeyine geri itilir.
+void bounceSpheresOffDistanceField(std::vector<Sphere>& spheres, SimulationContext& context, const glm::mat3& basis) {
+    const Container& container = context.container;
+    const ContainerFrame& frame = context.containerFrame;
+    const DistanceField& field = context.distanceField;
+    const glm::mat3 toLocal = glm::transpose(basis);
+    const int wallRow = context.wallMaterial * MAX_MATERIALS;
+
+    for (size_t c = 0; c < frame.contacts.size(); ++c) {
+        int s = frame.contacts[c];
+        Sphere& sphere = spheres[s];
+        float restitution = context.materials.restitution[wallRow + sphere.material];
+        float friction = context.materials.friction[wallRow + sphere.material];
+        const glm::vec3& inward = field.contactNormal[c];
+        glm::vec3 velocity(frame.velocityX[s], frame.velocityY[s], frame.velocityZ[s]);
+        glm::vec3 angular = toLocal * (sphereAngularVelocity(context.rotation, s) - container.angularVelocity);
+
+        sphere.position += basis * (inward * (sphere.radius - field.contactDistance[c]));
+        float normalVelocity = glm::dot(velocity, inward);
+        if (normalVelocity < 0.0f) {
+            velocity -= inward * ((1.0f + restitution) * normalVelocity);
+            applyWallFriction(context.rotation, s, sphere.radius, -inward, -normalVelocity, restitution, friction,
+                basis, velocity, angular);
+        }
+        sphere.velocity = basis * velocity + containerPointVelocity(container, sphere.position);
+    }
+}
+
+} // namespace
+
+
+void checkCollisions(std::vector<Sphere>& spheres, SimulationContext& context, float period) {
+    resizeRotationState(context.rotation, spheres.size());
+
+    // Yalnzca kre ieren sahnelerde vekil dizisi ve kovalama gerekmez
+    if (context.capsules.empty() && context.boxes.empty() && context.clumps.count == 0) {
+        if (period > 0.0f) {
+            buildPeriodicSpatialGrid(context.grid, spheres, period);
+        } else {
+            buildSpatialGrid(context.grid, spheres);
+        }
+        findCandidatePairs(context.grid, context.pairs);
+        std::vector<int>* touched = context.wallSchedule.enabled ? &context.wallSchedule.invalidated : nullptr;
+        resolveSphereSpherePairs(spheres, context.rotation, context.pairs, context.materials, period, touched);
+        return;
+    }
+
+    NarrowPhaseBuffers& buffers = context.narrowPhase;
+    buildShapeProxies(buffers, spheres, context.clumps, context.capsules, context.boxes);
+    if (period > 0.0f) {
+        buildPeriodicSpatialGrid(context.grid, buffers.proxyCenters, buffers.proxyRadii, period);
+    } else {
+        buildSpatialGrid(context.grid, buffers.proxyCenters, buffers.proxyRadii);
+    }
+    findCandidatePairs(context.grid, context.pairs);
+    resolveShapePairs(spheres, context.rotation, context.clumps, context.capsules, context.boxes, context.pairs, buffers,
+        context.materials, period);
+}
+
+void checkCubeCollisions(std::vector<Sphere>& spheres, float cubeSize, SimulationContext& context, float deltaTime) {
+    resizeRotationState(context.rotation, spheres.size());
+    float halfCubeSize = cubeSize / 2.0f;
+    const Container& container = context.container;
+    const glm::mat3 basis = glm::mat3_cast(container.orientation);
+    const glm::mat3 toLocal = glm::transpose(basis);
+
+    // Kreler toplu olarak kap erevesine tanr; tepki yalnzca duvarla rtenler iin hesaplanr.
+    // Periyodik snrda krelerin duvar yoktur.
+    ContainerFrame& frame = context.containerFrame;
+    const bool scheduled = usesWallSchedule(context, deltaTime);
+    if (!scheduled) {
+        dropWallPredictions(context.wallSchedule);
+    }
+    if (context.boundary == BOUNDARY_PERIODIC) {
+        frame.contacts.clear();
+    } else if (context.distanceField.enabled) {
+        // Kutu duvar yerine uzaklk alan: dnm sonsuz yar genilikle yaplr, temaslar alandan gelir
+        transformToContainerFrame(spheres, container, std::numeric_limits<float>::infinity(), frame);
+        findDistanceFieldContacts(context.distanceField, frame, spheres.size());
+        bounceSpheresOffDistanceField(spheres, context, basis);
+    } else if (scheduled) {
+        // Sabit kutu: yalnzca bu admda duvara varabilecek kreler denetlenir
+        WallSchedule& schedule = context.wallSchedule;
+        if (schedule.dueStep.size() != spheres.size()) {
+            resetWallSchedule(schedule, spheres.size());
+        }
+        frame.contacts.clear();
+        collectDueSpheres(schedule);
+        const BodyForces& forces = context.bodyForces;
+        const glm::vec3 acceleration = toLocal * (forces.gravity + forces.acceleration);
+        for (int s : schedule.due) {
+            Sphere& sphere = spheres[s];
+            glm::vec3 position = toLocal * (sphere.position - container.position);
+            glm::vec3 velocity = toLocal * sphere.velocity;
+            float reach = glm::max(glm::max(std::abs(position.x), std::abs(position.y)), std::abs(position.z)) + sphere.radius;
+            if (reach > halfCubeSize) {
+                bounceSphereOffBox(spheres, context, s, position, velocity, halfCubeSize, basis);
+            }
+            scheduleWallCheck(schedule, s, position, velocity, sphere.radius, halfCubeSize, acceleration, deltaTime);
+        }
+        advanceWallSchedule(schedule);
+    } else {
+        // Normal tepki ve ieri itme tm kreler iin SIMD ekirdeindedir; srtnme ve dnyaya geri
+        // yazma yalnzca duvarla rtm krelere yaplr
+        transformToContainerFrame(spheres, container, halfCubeSize, frame);
+        bounceOffBoxWalls(spheres, &context.materials.restitution[context.wallMaterial * MAX_MATERIALS], halfCubeSize, frame);
+        finishBoxWallContacts(spheres, context, container, [&](int) { return container.position; });
+    }
+
+    // ekiller de kap erevesinde, duvara gre hzlaryla sektirilir
+    auto bounceOffContainer = [&](glm::vec3& position, glm::vec3& velocity, const glm::vec3& localExtent, int row) {
+        glm::vec3 wallVelocity = containerPointVelocity(container, position);
+        glm::vec3 localPosition = toLocal * (position - container.position);
+        glm::vec3 localVelocity = toLocal * (velocity - wallVelocity);
+        bounceShapeOffWalls(localPosition, localVelocity, localExtent, halfCubeSize,
+            context.materials.restitution[row], context.materials.friction[row]);
+        velocity = basis * localVelocity + wallVelocity;
+    };
+    for (Capsule& capsule : context.capsules) {
+        if (capsule.fixed) continue;
+        int row = context.wallMaterial * MAX_MATERIALS + capsule.material;
+        glm::vec3 extent = glm::abs(toLocal * capsuleHalfAxis(capsule)) + capsule.radius;
+        bounceOffContainer(capsule.position, capsule.velocity, extent, row);
+    }
+    for (Box& box : context.boxes) {
+        if (box.fixed) continue;
+        int row = context.wallMaterial * MAX_MATERIALS + box.material;
+        // Kutunun kap eksenleri zerindeki izdm: sum_k |R_ik| h_k
+        glm::mat3 axes = toLocal * glm::mat3_cast(box.orientation);
+        glm::vec3 extent = glm::abs(axes[0]) * box.halfExtents.x + glm::abs(axes[1]) * box.halfExtents.y + glm::abs(axes[2]) * box.halfExtents.z;
+        bounceOffContainer(box.position, box.velocity, extent, row);
+    }
+
+    checkClumpWallCollisions(context.clumps, cubeSize, container, context.materials, context.wallMaterial);
+}
+
+void checkBatchCollisions(std::vector<Sphere>& spheres, SimulationContext& context) {
+    const ContainerBatch& batch = context.batch;
+    // Kreler havuz dnda eklenip karlrsa atamalar kayar ve kutular yanl kreleri grr
+    assert(batch.sphereContainer.size() == spheres.size() && "her krenin bir kutu atamas olmal");
+    resizeRotationState(context.rotation, spheres.size());
+
+    // Her kutunun hcreleri ayr bir kafeste durduu iin adaylar yalnzca ayn kutudan gelir
+    buildBatchedSpatialGrid(context.grid, spheres, batch.sphereContainer, batch.origins, batch.halfSize);
+    findCandidatePairs(context.grid, context.pairs);
+    resolveSphereSpherePairs(spheres, context.rotation, context.pairs, context.materials);
+
+    // Duvarlar tek kutudaki gibi SIMD ekirdeinden geer; yalnzca kutu merkezi kreye gre seilir
+    ContainerFrame& frame = context.containerFrame;
+    transformToBatchFrames(spheres, batch, frame);
+    bounceOffBoxWalls(spheres, &context.materials.restitution[context.wallMaterial * MAX_MATERIALS], batch.halfSize, frame);
+    finishBoxWallContacts(spheres, context, Container(), [&](int s) { return batch.origins[batch.sphereContainer[s]]; });
+}
+
+void updateShapePositions(SimulationContext& context, float deltaTime) {
+    const BodyForces& forces = context.bodyForces;
+    const glm::vec3 impulse = (forces.gravity + forces.acceleration) * deltaTime;
+    const float damping = std::exp(-forces.drag * deltaTime);
+    for (Capsule& capsule : context.capsules) {
+        if (capsule.fixed) continue;
+        capsule.velocity = capsule.velocity * damping + impulse;
+        capsule.position += capsule.velocity * deltaTime;
+    }
+    for (Box& box : context.boxes) {
+        if (box.fixed) continue;
+        box.velocity = box.velocity * damping + impulse;
+        box.position += box.velocity * deltaTime;
+    }
+    integrateClumps(context.clumps, deltaTime, impulse, damping);
+    updateClumpMembers(context.clumps);
+}
+
+void updateSpherePositions(std::vector<Sphere>& spheres, float deltaTime, const BodyForces& forces, float period) {
+    // Alanlar kare bana bir kez hza evrilir; kre bana bir okuma ve bir yazma kalr
+    const glm::vec3 impulse = (forces.gravity + forces.acceleration) * deltaTime;
+    const float damping = std::exp(-forces.drag * deltaTime);
+    // Dalsz sarma: x - L floor((x + L/2) / L). Ak snrda L = 0 ve x deimez.
+    const float half = 0.5f * period;
+    const float inversePeriod = period > 0.0f ? 1.0f / period : 0.0f;
+    parallelFor(spheres.size(), [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; ++i) {
+            Sphere& sphere = spheres[i];
+            // Yar rtk Euler: nce hz, sonra yeni hzla pozisyon
+            sphere.velocity = sphere.velocity * damping + impulse;
+            sphere.position += sphere.velocity * deltaTime;
+            sphere.position -= period * glm::floor((sphere.position + half) * inversePeriod);
+        }
+    }, 4096);
+}
+
+void updateSimulation(std::vector<Sphere>& spheres, float cubeSize, float deltaTime, SimulationContext& context) {
+    // Dier modlar ve kutu dnyas checkCubeCollisions'a uramadan dner; kreler tahminsiz hareket ettii
+    // iin takvim burada braklr
+    if (!usesWallSchedule(context, deltaTime)) {
+        dropWallPredictions(context.wallSchedule);
+    }
+
+    // Uzun menzilli ekim tm modlarda kare banda hzlara eklenir
+    if (context.gravity.settings.enabled) {
+        applyBarnesHutGravity(spheres, context.gravity, deltaTime);
+    }
+    if (context.particleMesh.settings.enabled) {
+        applyParticleMeshForces(spheres, cubeSize, context.particleMesh, deltaTime);
+    }
+
+    if (context.mode == SIMULATION_DEM) {
+        updateDemSimulation(spheres, cubeSize, deltaTime, context);
+        return;
+    }
+    if (context.mode == SIMULATION_LENNARD_JONES) {
+        updateLennardJonesSimulation(spheres, cubeSize, deltaTime, context);
+        return;
+    }
+    if (context.mode == SIMULATION_SPH) {
+        updateSphSimulation(spheres, cubeSize, deltaTime, context);
+        return;
+    }
+    if (context.mode == SIMULATION_MONTE_CARLO) {
+        updateMonteCarloSimulation(spheres, cubeSize, context);
+        return;
+    }
+
+    resizeRotationState(context.rotation, spheres.size());
+
+    // Bir nceki admn aday iftleri yerellii ler; gerekirse kreler bu admdan nce yeniden dizilir
+    if (context.sphereOrder.settings.enabled) {
+        updateSphereOrder(spheres, context);
+    }
+
+    // Langevin modu itmeli modun admna yalnzca hz snm ve sl grlt ekler. Grlt kalc
+    // tutamalarla anahtarlanr; harita kapalysa ya da kreler dardan deitiyse yeniden kurulur.
+    if (context.mode == SIMULATION_LANGEVIN) {
+        if (!context.handles.enabled || context.handles.denseSlot.size() != spheres.size()) {
+            resetSphereHandles(context.handles, spheres.size());
+        }
+        applyLangevinThermostat(spheres, context.handles, context.langevin, deltaTime);
+    }
+
+    // Ak senaryolar: havuzlara den kreler kar, yayclar yenilerini ekler
+    if (!context.pool.emitters.empty() || !context.pool.sinks.empty()) {
+        updateSpherePool(spheres, context, deltaTime);
+    }
+
+    // Pozisyonlar ve ynelimleri gncelle. Kutu dnyas yalnzca duvarldr: kreler origins'teki
+    // kutularda durduundan tek kpe sarlmaz, periyodik snr yok saylr.
+    const bool batched = !context.batch.origins.empty();
+    const float period = context.boundary == BOUNDARY_PERIODIC && !batched ? cubeSize : 0.0f;
+    updateSpherePositions(spheres, deltaTime, context.bodyForces, period);
+    updateShapePositions(context, deltaTime);
+    integrateOrientations(context.rotation, deltaTime);
+    advanceContainer(context.container, deltaTime);
+
+    // Kutu dnyasnda tm kutular tek geite arptrlr; cubeSize ve container kullanlmaz
+    if (batched) {
+        checkBatchCollisions(spheres, context);
+        return;
+    }
+
+    // arpmalar kontrol et
+    checkCollisions(spheres, context, period);
+    collideSpheresWithMeshes(spheres, context.rotation, context.meshes, context.materials);
+
+    // Kp snrlar ile arpmay kontrol et
+    checkCubeCollisions(spheres, cubeSize, context, deltaTime);
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "Sphere.h"
+#include "Shapes.h"
+#include "Clump.h"
+#include "Container.h"
+#include "Emitter.h"
+#include "SphereHandles.h"
+#include "SphereOrder.h"
+#include "DistanceField.h"
+#include "Material.h"
+#include "NarrowPhase.h"
+#include "Rotation.h"
+#include "TriangleMesh.h"
+#include "WallSchedule.h"
+#include "SpatialGrid.h"
+#include "BarnesHut.h"
+#include "Dem.h"
+#include "ParticleMesh.h"
+#include "LennardJones.h"
+#include "Sph.h"
+#include "Langevin.h"
+#include "MonteCarlo.h"
+#include <vector>
+
+
+// updateSimulation'n kulland fizik modeli
+enum SimulationMode {
+    SIMULATION_IMPULSE,       // Anlk itmeli esnek arpmalar (varsaylan)
+    SIMULATION_DEM,           // HertzMindlin yumuak temas kuvvetleri
+    SIMULATION_LENNARD_JONES, // Kesilmi ve kaydrlm Lennard-Jones potansiyeli (molekler dinamik)
+    SIMULATION_SPH,           // Kreler akkan paracklar (dzgnletirilmi parack hidrodinamii)
+    SIMULATION_LANGEVIN,      // tmeli arpmalar ve Brown hareketi (Langevin termostat)
+    SIMULATION_MONTE_CARLO,   // Sert kre Metropolis rneklemesi; zaman yok, yalnzca konumlar deiir
+};
+
+// tmeli modlarda krelerin kp snrndaki davran
+enum BoundaryMode {
+    BOUNDARY_WALLS,    // Kabn duvarlarndan sekme (varsaylan)
+    BOUNDARY_PERIODIC, // Kreler kar yzden geri girer; iftler en yakn grntyle snanr
+};
+
+
+// Tm cisimlere etkiyen dzgn d alanlar. Her modun konum admyla ayn geite uygulanr,
+// bylece krenin durumu adm bana bir kez okunup yazlr.
+struct BodyForces {
+    glm::vec3 gravity = glm::vec3(0.0f);
+    glm::vec3 acceleration = glm::vec3(0.0f); // Ktleden bamsz ek sabit ivme
+    float drag = 0.0f;                        // Dorusal srkleme (1 / s): v <- v exp(-drag dt)
+};
+
+// Kreler dnda bir simlasyon admnn ihtiya duyduu tm durum
+struct SimulationContext {
+    SimulationMode mode = SIMULATION_IMPULSE;
+    // Periyodik snrda kap eksenlere hizal, merkezi orijinde kabul edilir; kapsl, kutu ve gvdeler
+    // sarlmaz, duvarlardan sekmeye devam eder
+    BoundaryMode boundary = BOUNDARY_WALLS;
+    MaterialTable materials;
+    int wallMaterial = 0; // Kp duvarlarnn malzemesi
+    RotationState rotation;
+    BodyForces bodyForces;
+
+    // Kp duvarlarnn dnm ve hz; itmeli modlarda duvar hareketi sekmeye katlr.
+    // Dier modlar eksenlere hizal, sabit kp kullanr.
+    Container container;
+    ContainerFrame containerFrame;
+    // Doluysa kreler batch.origins'teki bamsz kutulara dalr ve tek kap yerine bunlar kullanlr.
+    // Kutular yalnzca duvarldr; boundary periyodik olsa da kreler sarlmaz.
+    ContainerBatch batch;
+    // Kutu yerine rastgele biimli kap (enabled ile); kap erevesinde piirilir
+    DistanceField distanceField;
+    // Duvara yaklamayan kreleri duvar denetiminden karan takvim (enabled ile; yalnzca sabit kutuda)
+    WallSchedule wallSchedule;
+
+    // ok kreli kat gvdeler
+    ClumpSystem clumps;
+
+    // Kre d ekiller; yalnzca teleme yaparlar, ynelimleri sabittir
+    std::vector<Capsule> capsules;
+    std::vector<Box> boxes;
+
+    // Sabit gen a engelleri (dnya koordinatlarnda, BVH kurulmu olarak eklenir)
+    std::vector<TriangleMesh> meshes;
+
+    // Yayclar, havuzlar ve sabit kapasiteli kre havuzu (itmeli modlarda)
+    SpherePool pool;
+    // Kalc kre tutamalar (ilk insertSphere ya da resetSphereHandles ile alr)
+    SphereHandleMap handles;
+
+    // Yerellik bozulunca krelerin Morton srasna yeniden dizilmesi (settings.enabled ile; itmeli modlarda)
+    SphereOrder sphereOrder;
+
+    // Admlar arasnda yeniden kullanlan geni ve dar faz tamponlar
+    SpatialGrid grid;
+    CandidatePairs pairs;
+    NarrowPhaseBuffers narrowPhase;
+
+    // Kreler aras karlkl ktle ekimi (settings.enabled ile alr)
+    BarnesHutState gravity;
+    // A zerinden uzun menzilli ekim; periyodik ya da yaltlm kp
+    ParticleMeshState particleMesh;
+
+    // Modlara zg durum
+    DemState dem;
+    LennardJonesState lennardJones;
+    SphState sph;
+    LangevinState langevin;
+    MonteCarloState monteCarlo;
+};
+
+// Kreler ve dier ekiller aras arpmay kontrol et. period > 0 ise kenar period olan periyodik kp.
+void checkCollisions(std::vector<Sphere>& spheres, SimulationContext& context, float period = 0.0f);
+
+// Kutu dnyas (context.batch): ayn kutudaki kre iftleri ve her krenin kendi kutusunun duvarlar.
+// Yalnzca kreler desteklenir.
+void checkBatchCollisions(std::vector<Sphere>& spheres, SimulationContext& context);
+
+// Krelerin, ekillerin ve kp snrlarnn arpmasn kontrol et. deltaTime verilirse (ve
+// wallSchedule aksa) kreler yalnzca tahmin edilen duvar temas admlarnda denetlenir.
+void checkCubeCollisions(std::vector<Sphere>& spheres, float cubeSize, SimulationContext& context, float deltaTime = 0.0f);
+
+// Krelerin hzna d alanlar ekle ve pozisyonunu gncelle (tek gei). period > 0 ise konumlar
+// ayn geite [-period/2, period/2) aralna sarlr.
+void updateSpherePositions(std::vector<Sphere>& spheres, float deltaTime, const BodyForces& forces, float period = 0.0f);
+
+// Sabit olmayan kapsl ve kutular d alanlarla hzlandrp tele, gvdeleri ilerletip ye konumlarn yenile
+void updateShapePositions(SimulationContext& context, float deltaTime);
+
+void updateSimulation(std::vector<Sphere>& spheres, float cubeSize, float deltaTime, SimulationContext& context);
@@ -0,0 +1,223 @@
+#include "SpatialGrid.h"
+#include "Simd.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace {
+
+// 26 komudan yalnzca "ileri" yndeki 13'; her ift bylece bir kez bulunur
+const glm::ivec3 kForwardNeighbours[13] = {
+    { 1, 0, 0 }, { -1, 1, 0 }, { 0, 1, 0 }, { 1, 1, 0 },
+    { -1, -1, 1 }, { 0, -1, 1 }, { 1, -1, 1 },
+    { -1, 0, 1 }, { 0, 0, 1 }, { 1, 0, 1 },
+    { -1, 1, 1 }, { 0, 1, 1 }, { 1, 1, 1 },
+};
+
+// Sayma sralamas; cellAt krenin hcre koordinatn verir
+template <typename CellAt>
+void sortIntoCells(SpatialGrid& grid, int count, CellAt cellAt) {
+    const int cellCount = grid.dims.x * grid.dims.y * grid.dims.z;
+    grid.cellStart.assign(cellCount + 1, 0);
+    grid.sphereCell.resize(count);
+    for (int i = 0; i < count; ++i) {
+        glm::ivec3 c = cellAt(i);
+        int cell = (c.z * grid.dims.y + c.y) * grid.dims.x + c.x;
+        grid.sphereCell[i] = cell;
+        grid.cellStart[cell + 1]++;
+    }
+    for (int c = 0; c < cellCount; ++c) {
+        grid.cellStart[c + 1] += grid.cellStart[c];
+    }
+    grid.cellEntries.resize(count);
+    std::vector<int> cursor(grid.cellStart.begin(), grid.cellStart.end() - 1);
+    for (int i = 0; i < count; ++i) {
+        grid.cellEntries[cursor[grid.sphereCell[i]]++] = i;
+    }
+}
+
+template <typename PositionAt, typename RadiusAt>
+void buildGrid(SpatialGrid& grid, int count, PositionAt positionAt, RadiusAt radiusAt, float minCellSize) {
+    glm::vec3 lo(0.0f), hi(0.0f);
+    float maxRadius = 0.0f;
+    if (count > 0) {
+        lo = hi = positionAt(0);
+    }
+    for (int i = 0; i < count; ++i) {
+        lo = glm::min(lo, positionAt(i));
+        hi = glm::max(hi, positionAt(i));
+        maxRadius = std::max(maxRadius, radiusAt(i));
+    }
+
+    // Hcre says kre saysnn birka katn gemesin; seyrek sahnelerde hcre bytlr
+    float cellSize = std::max(2.0f * maxRadius, std::max(minCellSize, 1e-6f));
+    glm::vec3 extent = hi - lo;
+    const double maxCells = 4.0 * std::max(count, 1) + 64.0;
+    for (;;) {
+        glm::dvec3 dims = glm::floor(glm::dvec3(extent) / static_cast<double>(cellSize)) + 1.0;
+        if (dims.x * dims.y * dims.z <= maxCells) break;
+        cellSize *= 1.5f;
+    }
+
+    grid.origin = lo;
+    grid.cellSize = cellSize;
+    grid.dims = glm::ivec3(glm::floor(extent / cellSize)) + 1;
+    grid.periodic = false;
+
+    float inverseCell = 1.0f / cellSize;
+    sortIntoCells(grid, count, [&](int i) {
+        return glm::clamp(glm::ivec3((positionAt(i) - lo) * inverseCell), glm::ivec3(0), grid.dims - 1);
+    });
+}
+
+template <typename PositionAt, typename RadiusAt>
+void buildPeriodicGrid(SpatialGrid& grid, int count, PositionAt positionAt, RadiusAt radiusAt, float period) {
+    float maxRadius = 0.0f;
+    for (int i = 0; i < count; ++i) {
+        maxRadius = std::max(maxRadius, radiusAt(i));
+    }
+
+    // Hcre periyodu tam blmeli ve en byk aptan kk olmamal
+    int cells = static_cast<int>(period / std::max(2.0f * maxRadius, 1e-6f));
+    const double maxCells = 4.0 * std::max(count, 1) + 64.0;
+    while (cells > 1 && static_cast<double>(cells) * cells * cells > maxCells) {
+        --cells;
+    }
+    if (cells < 3) cells = 1;
+
+    grid.origin = glm::vec3(-0.5f * period);
+    grid.cellSize = period / cells;
+    grid.dims = glm::ivec3(cells);
+    grid.periodic = true;
+
+    // Konumlar sarlm olsa da yuvarlama kenarda bir hcre tarabilir; indeks de sarlr
+    float inverseCell = 1.0f / grid.cellSize;
+    sortIntoCells(grid, count, [&](int i) {
+        glm::ivec3 c = glm::ivec3(glm::floor((positionAt(i) - grid.origin) * inverseCell));
+        return ((c % cells) + cells) % cells;
+    });
+}
+
+} // namespace
+
+
+void buildSpatialGrid(SpatialGrid& grid, const std::vector<Sphere>& spheres, float minCellSize) {
+    buildGrid(grid, static_cast<int>(spheres.size()),
+        [&](int i) { return spheres[i].position; },
+        [&](int i) { return spheres[i].radius; },
+        minCellSize);
+}
+
+void buildSpatialGrid(SpatialGrid& grid, const std::vector<glm::vec3>& centers, const std::vector<float>& radii, float minCellSize) {
+    buildGrid(grid, static_cast<int>(centers.size()),
+        [&](int i) { return centers[i]; },
+        [&](int i) { return radii[i]; },
+        minCellSize);
+}
+
+void buildSpatialGrid(SpatialGrid& grid, const float* x, const float* y, const float* z, const float* radii, int count, float minCellSize) {
+    buildGrid(grid, count,
+        [&](int i) { return glm::vec3(x[i], y[i], z[i]); },
+        [&](int i) { return radii[i]; },
+        minCellSize);
+}
+
+void buildPeriodicSpatialGrid(SpatialGrid& grid, const std::vector<Sphere>& spheres, float period) {
+    buildPeriodicGrid(grid, static_cast<int>(spheres.size()),
+        [&](int i) { return spheres[i].position; },
+        [&](int i) { return spheres[i].radius; },
+        period);
+}
+
+void buildPeriodicSpatialGrid(SpatialGrid& grid, const std::vector<glm::vec3>& centers, const std::vector<float>& radii, float period) {
+    buildPeriodicGrid(grid, static_cast<int>(centers.size()),
+        [&](int i) { return centers[i]; },
+        [&](int i) { return radii[i]; },
+        period);
+}
+
+void buildBatchedSpatialGrid(SpatialGrid& grid, const std::vector<Sphere>& spheres,
+    const std::vector<int>& sphereContainer, const std::vector<glm::vec3>& origins, float halfSize) {
+    const int count = static_cast<int>(spheres.size());
+    const int containers = std::max(static_cast<int>(origins.size()), 1);
+    float maxRadius = 0.0f;
+    for (const Sphere& sphere : spheres) {
+        maxRadius = std::max(maxRadius, sphere.radius);
+    }
+
+    // Kap bana kenar hcre says kab tam bler; toplam hcre says kre saysnn birka katn gemez
+    int cells = std::max(static_cast<int>(2.0f * halfSize / std::max(2.0f * maxRadius, 1e-6f)), 1);
+    const double maxCells = 4.0 * std::max(count, 1) + 64.0;
+    while (cells > 1 && static_cast<double>(containers) * cells * cells * (cells + 1) > maxCells) {
+        --cells;
+    }
+
+    grid.origin = glm::vec3(-halfSize);
+    grid.cellSize = 2.0f * halfSize / cells;
+    grid.dims = glm::ivec3(cells, cells, containers * (cells + 1));
+    grid.periodic = false;
+
+    float inverseCell = 1.0f / grid.cellSize;
+    sortIntoCells(grid, count, [&](int i) {
+        int container = sphereContainer[i];
+        glm::ivec3 c = glm::clamp(glm::ivec3((spheres[i].position - origins[container] + halfSize) * inverseCell),
+            glm::ivec3(0), glm::ivec3(cells - 1));
+        c.z += container * (cells + 1);
+        return c;
+    });
+}
+
+void findCandidatePairs(const SpatialGrid& grid, CandidatePairs& pairs) {
+    pairs.first.clear();
+    pairs.second.clear();
+
+    for (int cz = 0; cz < grid.dims.z; ++cz) {
+        for (int cy = 0; cy < grid.dims.y; ++cy) {
+            for (int cx = 0; cx < grid.dims.x; ++cx) {
+                int cell = (cz * grid.dims.y + cy) * grid.dims.x + cx;
+                int begin = grid.cellStart[cell];
+                int end = grid.cellStart[cell + 1];
+                if (begin == end) continue;
+
+                // Ayn hcre iindeki iftler
+                for (int a = begin; a < end; ++a) {
+                    for (int b = a + 1; b < end; ++b) {
+                        pairs.first.push_back(grid.cellEntries[a]);
+                        pairs.second.push_back(grid.cellEntries[b]);
+                    }
+                }
+
+                // leri komu hcrelerle iftler. Periyodik zgarada indeks sarlr; tek hcreli
+                // zgarada birden ok kaydrma ayn hcreye der, bunlar atlanr.
+                int visited[13];
+                int visitedCount = 0;
+                for (const glm::ivec3& offset : kForwardNeighbours) {
+                    glm::ivec3 n = glm::ivec3(cx, cy, cz) + offset;
+                    if (grid.periodic) {
+                        n = (n + grid.dims) % grid.dims;
+                    } else if (n.x < 0 || n.y < 0 || n.z < 0 || n.x >= grid.dims.x || n.y >= grid.dims.y || n.z >= grid.dims.z) {
+                        continue;
+                    }
+                    int neighbour = (n.z * grid.dims.y + n.y) * grid.dims.x + n.x;
+                    if (neighbour == cell || std::find(visited, visited + visitedCount, neighbour) != visited + visitedCount) continue;
+                    visited[visitedCount++] = neighbour;
+                    int neighbourBegin = grid.cellStart[neighbour];
+                    int neighbourEnd = grid.cellStart[neighbour + 1];
+                    for (int a = begin; a < end; ++a) {
+                        for (int b = neighbourBegin; b < neighbourEnd; ++b) {
+                            pairs.first.push_back(grid.cellEntries[a]);
+                            pairs.second.push_back(grid.cellEntries[b]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    pairs.count = static_cast<int>(pairs.first.size());
+    while (pairs.first.size() % SIMD_WIDTH != 0) {
+        pairs.first.push_back(0);
+        pairs.second.push_back(0);
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Sphere.h"
+#include <glm/glm.hpp>
+#include <vector>
+
+
+// Dzgn hcre zgaras (geni faz). Kreler hcre numarasna gre sayma sralamasyla dizilir;
+// bir hcredeki kreler cellEntries[cellStart[c] .. cellStart[c + 1]) aralndadr.
+struct SpatialGrid {
+    glm::vec3 origin = glm::vec3(0.0f);
+    float cellSize = 1.0f;
+    glm::ivec3 dims = glm::ivec3(1);
+    bool periodic = false; // Kar yzlerdeki hcreler komudur; zgara periyot kpn tam der
+    std::vector<int> cellStart;
+    std::vector<int> cellEntries;
+    std::vector<int> sphereCell;
+};
+
+// Aday arpma iftleri, SIMD ekirdeklerinin 8'er 8'er okuyabilmesi iin ayr dizilerde.
+// Sonu (0, 0) iftleriyle SIMD_WIDTH katna tamamlanr; bu iftler mesafe sfr olduu iin elenir.
+struct CandidatePairs {
+    std::vector<int> first;
+    std::vector<int> second;
+    int count = 0; // Dolgu hari gerek ift says
+};
+
+// Hcre boyu en byk aptan kk olmaz, bylece temas eden kreler komu hcrelerde kalr
+void buildSpatialGrid(SpatialGrid& grid, const std::vector<Sphere>& spheres, float minCellSize = 0.0f);
+
+// Kre olmayan ekiller iin: her vekil (proxy) bir merkez ve onu saran krenin yarapyla verilir
+void buildSpatialGrid(SpatialGrid& grid, const std::vector<glm::vec3>& centers, const std::vector<float>& radii, float minCellSize = 0.0f);
+
+// Konumlar ayr dizilerde (SoA) tutan modlar iin
+void buildSpatialGrid(SpatialGrid& grid, const float* x, const float* y, const float* z, const float* radii, int count, float minCellSize = 0.0f);
+
+// Periyodik snr iin: zgara [-period/2, period/2) kpn tam der, hcreler periyodu tam bler.
+// Kenar bana 3'ten az hcre sarsa tek hcre kullanlr (komu listesinde tekrar olmamas iin).
+void buildPeriodicSpatialGrid(SpatialGrid& grid, const std::vector<Sphere>& spheres, float period);
+void buildPeriodicSpatialGrid(SpatialGrid& grid, const std::vector<glm::vec3>& centers, const std::vector<float>& radii, float period);
+
+// ok kapl dnya iin: her kabn kendi hcre kafesi vardr (merkezi origins[k], yar genilii
+// halfSize) ve kafesler z ekseninde aralarnda bo bir katmanla st ste dizilir. Komu aramas bu
+// yzden yalnzca ayn kaptaki kreleri eler.
+void buildBatchedSpatialGrid(SpatialGrid& grid, const std::vector<Sphere>& spheres,
+    const std::vector<int>& sphereContainer, const std::vector<glm::vec3>& origins, float halfSize);
+
+// Ayn ve komu hcrelerdeki her kre iftini bir kez yazar
+void findCandidatePairs(const SpatialGrid& grid, CandidatePairs& pairs);
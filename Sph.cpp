@@ -0,0 +1,262 @@
+#include "Sph.h"
+#include "Parallel.h"
+#include "Simd.h"
+#include "Simulation.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace {
+
+const float kPi = 3.14159265f;
+
+void resizeSphState(SphState& sph, size_t count) {
+    size_t padded = (count + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH;
+    for (std::vector<float>* array : { &sph.positionX, &sph.positionY, &sph.positionZ, &sph.radius,
+             &sph.velocityX, &sph.velocityY, &sph.velocityZ, &sph.accelerationX, &sph.accelerationY, &sph.accelerationZ,
+             &sph.mass, &sph.density, &sph.pressure }) {
+        array->assign(padded, 0.0f);
+    }
+    sph.material.assign(padded, 0);
+    sph.count = count;
+}
+
+void loadSphState(SphState& sph, const std::vector<Sphere>& spheres) {
+    parallelFor(spheres.size(), [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; ++i) {
+            const Sphere& sphere = spheres[i];
+            sph.positionX[i] = sphere.position.x;
+            sph.positionY[i] = sphere.position.y;
+            sph.positionZ[i] = sphere.position.z;
+            sph.radius[i] = sphere.radius;
+            sph.velocityX[i] = sphere.velocity.x;
+            sph.velocityY[i] = sphere.velocity.y;
+            sph.velocityZ[i] = sphere.velocity.z;
+            sph.mass[i] = sphereMass(sphere.radius);
+            sph.material[i] = sphere.material;
+        }
+    });
+}
+
+void storeSphState(const SphState& sph, std::vector<Sphere>& spheres) {
+    parallelFor(spheres.size(), [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; ++i) {
+            spheres[i].position = glm::vec3(sph.positionX[i], sph.positionY[i], sph.positionZ[i]);
+            spheres[i].velocity = glm::vec3(sph.velocityX[i], sph.velocityY[i], sph.velocityZ[i]);
+        }
+    });
+}
+
+// Hcre boyu h'den kk olmad iin h iindeki komular 27 hcrede kalr. Satrlar nce i
+// parac bana toplanr, nek toplamndan sonra CSR dizisine kopyalanr.
+void findSphNeighbours(SphState& sph, const SpatialGrid& grid, float smoothingLength) {
+    const int count = static_cast<int>(sph.count);
+    const int threads = parallelThreadCount();
+    const float reachSquared = smoothingLength * smoothingLength;
+    sph.threadNeighbours.resize(threads);
+    sph.threadBegin.assign(threads, 0);
+    for (int t = 0; t < threads; ++t) {
+        sph.threadNeighbours[t].clear();
+    }
+    sph.neighbourStart.assign(count + 1, 0);
+
+    parallelFor(count, [&](size_t begin, size_t end, int thread) {
+        std::vector<int>& neighbours = sph.threadNeighbours[thread];
+        sph.threadBegin[thread] = begin;
+        for (size_t i = begin; i < end; ++i) {
+            int cell = grid.sphereCell[i];
+            int cx = cell % grid.dims.x;
+            int cy = (cell / grid.dims.x) % grid.dims.y;
+            int cz = cell / (grid.dims.x * grid.dims.y);
+            float xi = sph.positionX[i], yi = sph.positionY[i], zi = sph.positionZ[i];
+            size_t before = neighbours.size();
+
+            for (int z = std::max(cz - 1, 0); z <= std::min(cz + 1, grid.dims.z - 1); ++z) {
+                for (int y = std::max(cy - 1, 0); y <= std::min(cy + 1, grid.dims.y - 1); ++y) {
+                    for (int x = std::max(cx - 1, 0); x <= std::min(cx + 1, grid.dims.x - 1); ++x) {
+                        int neighbour = (z * grid.dims.y + y) * grid.dims.x + x;
+                        for (int e = grid.cellStart[neighbour]; e < grid.cellStart[neighbour + 1]; ++e) {
+                            int j = grid.cellEntries[e];
+                            float dx = sph.positionX[j] - xi;
+                            float dy = sph.positionY[j] - yi;
+                            float dz = sph.positionZ[j] - zi;
+                            if (j == static_cast<int>(i) || dx * dx + dy * dy + dz * dz >= reachSquared) continue;
+                            neighbours.push_back(j);
+                        }
+                    }
+                }
+            }
+            sph.neighbourStart[i + 1] = static_cast<int>(neighbours.size() - before);
+        }
+    }, 256);
+
+    for (int i = 0; i < count; ++i) {
+        sph.neighbourStart[i + 1] += sph.neighbourStart[i];
+    }
+
+    // Son satrn 8'li yklemeleri dizi iinde kalsn diye SIMD_WIDTH kadar tamamlanr
+    sph.neighbours.assign(sph.neighbourStart[count] + SIMD_WIDTH, 0);
+    parallelFor(threads, [&](size_t begin, size_t end, int) {
+        for (size_t t = begin; t < end; ++t) {
+            const std::vector<int>& neighbours = sph.threadNeighbours[t];
+            std::copy(neighbours.begin(), neighbours.end(), sph.neighbours.begin() + sph.neighbourStart[sph.threadBegin[t]]);
+        }
+    }, 1);
+}
+
+// rho_i = sum m_j W_poly6(r_ij), kendisi dahil; ardndan dorusal durum denklemiyle basn
+void computeSphDensity(SphState& sph, float smoothingLength) {
+    const float hSquared = smoothingLength * smoothingLength;
+    const float poly6 = 315.0f / (64.0f * kPi * std::pow(smoothingLength, 9.0f));
+    const float soundSquared = sph.settings.soundSpeed * sph.settings.soundSpeed;
+    const float restDensity = sph.settings.restDensity;
+
+    parallelFor(sph.count, [&](size_t begin, size_t end, int) {
+        const SimdFloat zero = simdSet(0.0f);
+        const SimdFloat reach = simdSet(hSquared);
+        alignas(32) float sums[SIMD_WIDTH];
+        for (size_t i = begin; i < end; ++i) {
+            SimdFloat xi = simdSet(sph.positionX[i]), yi = simdSet(sph.positionY[i]), zi = simdSet(sph.positionZ[i]);
+            SimdFloat sum = zero;
+            int rowBegin = sph.neighbourStart[i];
+            int rowEnd = sph.neighbourStart[i + 1];
+            for (int n = rowBegin; n < rowEnd; n += SIMD_WIDTH) {
+                SimdFloat valid = simdLess(simdLaneIndex(), simdSet(static_cast<float>(rowEnd - n)));
+                SimdInt j = simdLoadInt(&sph.neighbours[n]);
+                SimdFloat dx = simdGather(sph.positionX.data(), j) - xi;
+                SimdFloat dy = simdGather(sph.positionY.data(), j) - yi;
+                SimdFloat dz = simdGather(sph.positionZ.data(), j) - zi;
+                SimdFloat q = simdMax(reach - simdDot(dx, dy, dz, dx, dy, dz), zero);
+                sum = sum + simdSelect(valid, simdGather(sph.mass.data(), j) * q * q * q, zero);
+            }
+            simdStore(sums, sum);
+            float density = sph.mass[i] * hSquared * hSquared * hSquared;
+            for (int lane = 0; lane < SIMD_WIDTH; ++lane) {
+                density += sums[lane];
+            }
+            density *= poly6;
+            sph.density[i] = density;
+            sph.pressure[i] = std::max(soundSquared * (density - restDensity), 0.0f);
+        }
+    }, 256);
+}
+
+// Basn: -sum m_j (p_i + p_j) / (2 rho_j) grad W_spiky; viskozite: mu sum m_j (v_j - v_i) / rho_j lap W_visc.
+// kisi de rho_i'ye blnp d alanlarn sabit ivmesiyle birlikte ivmeye yazlr.
+void computeSphForces(SphState& sph, const BodyForces& forces, float smoothingLength) {
+    const float spiky = 45.0f / (kPi * std::pow(smoothingLength, 6.0f));
+    const float viscosity = sph.settings.viscosity;
+    const glm::vec3 gravity = forces.gravity + forces.acceleration;
+
+    parallelFor(sph.count, [&](size_t begin, size_t end, int) {
+        const SimdFloat zero = simdSet(0.0f);
+        const SimdFloat tiny = simdSet(1e-12f);
+        const SimdFloat half = simdSet(0.5f);
+        const SimdFloat h = simdSet(smoothingLength);
+        const SimdFloat mu = simdSet(viscosity);
+        alignas(32) float sums[3][SIMD_WIDTH];
+        for (size_t i = begin; i < end; ++i) {
+            SimdFloat xi = simdSet(sph.positionX[i]), yi = simdSet(sph.positionY[i]), zi = simdSet(sph.positionZ[i]);
+            SimdFloat vxi = simdSet(sph.velocityX[i]), vyi = simdSet(sph.velocityY[i]), vzi = simdSet(sph.velocityZ[i]);
+            SimdFloat pi = simdSet(sph.pressure[i]);
+            SimdFloat ax = zero, ay = zero, az = zero;
+            int rowBegin = sph.neighbourStart[i];
+            int rowEnd = sph.neighbourStart[i + 1];
+            for (int n = rowBegin; n < rowEnd; n += SIMD_WIDTH) {
+                SimdFloat valid = simdLess(simdLaneIndex(), simdSet(static_cast<float>(rowEnd - n)));
+                SimdInt j = simdLoadInt(&sph.neighbours[n]);
+                SimdFloat dx = xi - simdGather(sph.positionX.data(), j);
+                SimdFloat dy = yi - simdGather(sph.positionY.data(), j);
+                SimdFloat dz = zi - simdGather(sph.positionZ.data(), j);
+                SimdFloat distance = simdSqrt(simdMax(simdDot(dx, dy, dz, dx, dy, dz), tiny));
+                SimdFloat q = simdMax(h - distance, zero);
+                SimdFloat volume = simdGather(sph.mass.data(), j) / simdGather(sph.density.data(), j);
+
+                // Kuvvet i'yi j'den uzaklatrr: (x_i - x_j) / r ynnde
+                SimdFloat push = volume * half * (pi + simdGather(sph.pressure.data(), j)) * q * q / distance;
+                SimdFloat drag = mu * volume * q;
+                SimdFloat fx = push * dx + drag * (simdGather(sph.velocityX.data(), j) - vxi);
+                SimdFloat fy = push * dy + drag * (simdGather(sph.velocityY.data(), j) - vyi);
+                SimdFloat fz = push * dz + drag * (simdGather(sph.velocityZ.data(), j) - vzi);
+                ax = ax + simdSelect(valid, fx, zero);
+                ay = ay + simdSelect(valid, fy, zero);
+                az = az + simdSelect(valid, fz, zero);
+            }
+            simdStore(sums[0], ax);
+            simdStore(sums[1], ay);
+            simdStore(sums[2], az);
+            glm::vec3 force(0.0f);
+            for (int lane = 0; lane < SIMD_WIDTH; ++lane) {
+                force += glm::vec3(sums[0][lane], sums[1][lane], sums[2][lane]);
+            }
+            glm::vec3 acceleration = force * (spiky / sph.density[i]) + gravity;
+            sph.accelerationX[i] = acceleration.x;
+            sph.accelerationY[i] = acceleration.y;
+            sph.accelerationZ[i] = acceleration.z;
+        }
+    }, 256);
+}
+
+// Yar rtk Euler; kp geen parack duvara geri konur ve duvara doru hz sekme katsaysyla yansr
+void integrateSphState(SphState& sph, const MaterialTable& materials, int wallMaterial, float drag, float halfCubeSize, float deltaTime) {
+    const float damping = std::exp(-drag * deltaTime);
+    parallelFor(sph.positionX.size() / SIMD_WIDTH, [&](size_t begin, size_t end, int) {
+        const SimdFloat step = simdSet(deltaTime);
+        const SimdFloat decay = simdSet(damping);
+        const SimdFloat zero = simdSet(0.0f);
+        const SimdFloat half = simdSet(halfCubeSize);
+        const SimdInt wallRow = simdSetInt(wallMaterial * MAX_MATERIALS);
+        for (size_t block = begin; block < end; ++block) {
+            size_t i = block * SIMD_WIDTH;
+            SimdFloat limit = half - simdLoad(&sph.radius[i]);
+            SimdFloat restitution = simdGather(materials.restitution, wallRow + simdLoadInt(&sph.material[i]));
+            float* positions[3] = { &sph.positionX[i], &sph.positionY[i], &sph.positionZ[i] };
+            float* velocities[3] = { &sph.velocityX[i], &sph.velocityY[i], &sph.velocityZ[i] };
+            const float* accelerations[3] = { &sph.accelerationX[i], &sph.accelerationY[i], &sph.accelerationZ[i] };
+            for (int axis = 0; axis < 3; ++axis) {
+                SimdFloat v = simdLoad(velocities[axis]) * decay + step * simdLoad(accelerations[axis]);
+                SimdFloat x = simdLoad(positions[axis]) + step * v;
+                SimdFloat outward = simdOr(simdAnd(simdGreater(x, limit), simdGreater(v, zero)),
+                    simdAnd(simdLess(x, zero - limit), simdLess(v, zero)));
+                simdStore(velocities[axis], simdSelect(outward, zero - restitution * v, v));
+                simdStore(positions[axis], simdMax(simdMin(x, limit), zero - limit));
+            }
+        }
+    }, 64);
+}
+
+} // namespace
+
+
+void updateSphSimulation(std::vector<Sphere>& spheres, float cubeSize, float deltaTime, SimulationContext& context) {
+    SphState& sph = context.sph;
+    if (sph.count != spheres.size()) {
+        resizeSphState(sph, spheres.size());
+    }
+    if (spheres.empty() || deltaTime <= 0.0f) return;
+    loadSphState(sph, spheres);
+
+    float largestRadius = 0.0f, fastest = 0.0f;
+    for (const Sphere& sphere : spheres) {
+        largestRadius = std::max(largestRadius, sphere.radius);
+        fastest = std::max(fastest, glm::length(sphere.velocity));
+    }
+    const float smoothingLength = sph.settings.smoothingScale * largestRadius;
+    float stableStep = sph.settings.courant * smoothingLength / (sph.settings.soundSpeed + fastest);
+    int substeps = std::min(std::max(static_cast<int>(std::ceil(deltaTime / stableStep)), 1), sph.settings.maxSubsteps);
+    float step = deltaTime / substeps;
+    const int count = static_cast<int>(spheres.size());
+
+    for (int s = 0; s < substeps; ++s) {
+        // arpma modundaki zgara, hcre boyu en az h olacak ekilde yeniden kurulur
+        buildSpatialGrid(context.grid, sph.positionX.data(), sph.positionY.data(), sph.positionZ.data(), sph.radius.data(), count,
+            smoothingLength);
+        findSphNeighbours(sph, context.grid, smoothingLength);
+        computeSphDensity(sph, smoothingLength);
+        computeSphForces(sph, context.bodyForces, smoothingLength);
+        integrateSphState(sph, context.materials, context.wallMaterial, context.bodyForces.drag, cubeSize / 2.0f, step);
+    }
+
+    storeSphState(sph, spheres);
+}
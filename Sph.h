@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Sphere.h"
+#include <vector>
+
+
+struct SimulationContext;
+
+struct SphSettings {
+    float smoothingScale = 4.0f;  // ekirdek yarap h = smoothingScale * en byk kre yarap
+    float restDensity = 0.125f;   // Ktle r^3 olduundan, 2r aralkl kbik dizilimin younluu r^3 / (2r)^3
+    float soundSpeed = 20.0f;     // Basn p = c^2 (rho - rho0); ekme basnc sfrlanr
+    float viscosity = 0.02f;      // Dinamik viskozite
+    float courant = 0.4f;         // Alt adm <= courant * h / (c + en byk hz)
+    int maxSubsteps = 100;        // Kare bana alt adm snr; alrsa alt adm byr
+};
+
+// SPH modunun admlar aras durumu. Kreler kare banda SoA dizilere kopyalanr ve kare sonunda
+// geri yazlr; komu aramas checkCollisions'n kulland SimulationContext::grid zerinden yaplr.
+struct SphState {
+    SphSettings settings;
+
+    size_t count = 0; // Diziler SIMD_WIDTH katna tamamlanr; dolgu paracklarnn ktlesi sfrdr
+    std::vector<float> positionX, positionY, positionZ, radius;
+    std::vector<float> velocityX, velocityY, velocityZ;
+    std::vector<float> accelerationX, accelerationY, accelerationZ;
+    std::vector<float> mass, density, pressure;
+    std::vector<int> material;
+
+    // h iindeki komular (ynl, CSR, paracn kendisi hari)
+    std::vector<int> neighbourStart, neighbours;
+    std::vector<std::vector<int>> threadNeighbours;
+    std::vector<size_t> threadBegin;
+};
+
+// Younluk toplam, basn ve viskozite kuvvetleriyle bir kare ilerletir (Mller poly6, spiky ve
+// viskozite ekirdekleri). Kp duvarlar duvar malzemesinin sekme katsaysyla yanstr.
+void updateSphSimulation(std::vector<Sphere>& spheres, float cubeSize, float deltaTime, SimulationContext& context);
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+
+struct Sphere {
+    glm::vec3 position;
+    float radius;
+    glm::vec3 color;
+    glm::vec3 velocity; // Hz vektr eklendi
+    int material = 0;   // MaterialTable iindeki malzeme numaras
+};
+
+// Tm krelerin younluu ayn kabul edilir; itmelerde sabit arpan sadeletii iin ktle r^3
+inline float sphereMass(float radius) {
+    return radius * radius * radius;
+}
@@ -0,0 +1,310 @@
+#include "SphereBlocks.h"
+#include "Container.h"
+#include "Parallel.h"
+#include "SphereSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+
+namespace {
+
+double elapsedMs(std::chrono::steady_clock::time_point since) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since).count();
+}
+
+// Aday iftlerden gerekten temas edenleri sayar (AoS ve SoA dzenleri iin ortak lt)
+template <typename PositionAt, typename RadiusAt>
+int countContacts(const CandidatePairs& pairs, PositionAt positionAt, RadiusAt radiusAt) {
+    int contacts = 0;
+    for (int p = 0; p < pairs.count; ++p) {
+        int a = pairs.first[p], b = pairs.second[p];
+        glm::vec3 d = positionAt(b) - positionAt(a);
+        float reach = radiusAt(a) + radiusAt(b);
+        contacts += glm::dot(d, d) < reach * reach;
+    }
+    return contacts;
+}
+
+} // namespace
+
+
+void loadSphereBlocks(SphereBlocks& blocks, const std::vector<Sphere>& spheres) {
+    const size_t count = spheres.size();
+    blocks.count = count;
+    blocks.blocks.assign((count + SIMD_WIDTH - 1) / SIMD_WIDTH, SphereBlock()); // Sfrla balar
+    blocks.order.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        SphereBlock& block = blocks.blocks[i / SIMD_WIDTH];
+        const int lane = static_cast<int>(i % SIMD_WIDTH);
+        const Sphere& sphere = spheres[i];
+        block.x[lane] = sphere.position.x;
+        block.y[lane] = sphere.position.y;
+        block.z[lane] = sphere.position.z;
+        block.vx[lane] = sphere.velocity.x;
+        block.vy[lane] = sphere.velocity.y;
+        block.vz[lane] = sphere.velocity.z;
+        block.radius[lane] = sphere.radius;
+        block.material[lane] = sphere.material;
+        blocks.order[i] = static_cast<int>(i);
+    }
+}
+
+void storeSphereBlocks(const SphereBlocks& blocks, std::vector<Sphere>& spheres) {
+    spheres.resize(blocks.count);
+    for (size_t i = 0; i < blocks.count; ++i) {
+        const SphereBlock& block = blocks.blocks[i / SIMD_WIDTH];
+        const int lane = static_cast<int>(i % SIMD_WIDTH);
+        Sphere& sphere = spheres[blocks.order[i]];
+        sphere.position = glm::vec3(block.x[lane], block.y[lane], block.z[lane]);
+        sphere.velocity = glm::vec3(block.vx[lane], block.vy[lane], block.vz[lane]);
+        sphere.radius = block.radius[lane];
+        sphere.material = block.material[lane];
+    }
+}
+
+void integrateSphereBlocks(SphereBlocks& blocks, float deltaTime, const glm::vec3& acceleration, float drag) {
+    const SimdFloat step = simdSet(deltaTime);
+    const SimdFloat damping = simdSet(std::exp(-drag * deltaTime));
+    const SimdFloat impulse[3] = {
+        simdSet(acceleration.x * deltaTime), simdSet(acceleration.y * deltaTime), simdSet(acceleration.z * deltaTime),
+    };
+
+    parallelFor(blocks.blocks.size(), [&](size_t begin, size_t end, int) {
+        for (size_t b = begin; b < end; ++b) {
+            SphereBlock& block = blocks.blocks[b];
+            float* position[3] = { block.x, block.y, block.z };
+            float* velocity[3] = { block.vx, block.vy, block.vz };
+            for (int axis = 0; axis < 3; ++axis) {
+                SimdFloat v = simdLoad(velocity[axis]) * damping + impulse[axis];
+                simdStore(velocity[axis], v);
+                simdStore(position[axis], simdLoad(position[axis]) + v * step);
+            }
+        }
+    }, 512);
+}
+
+void bounceSphereBlocksOffWalls(SphereBlocks& blocks, float halfCubeSize, const float* wallRestitution) {
+    const SimdFloat half = simdSet(halfCubeSize);
+    const SimdFloat zero = simdSet(0.0f);
+
+    parallelFor(blocks.blocks.size(), [&](size_t begin, size_t end, int) {
+        for (size_t b = begin; b < end; ++b) {
+            SphereBlock& block = blocks.blocks[b];
+            SimdFloat restitution = simdGather(wallRestitution, simdLoadInt(block.material));
+            SimdFloat limit = half - simdLoad(block.radius);
+            SimdFloat lower = zero - limit;
+            float* position[3] = { block.x, block.y, block.z };
+            float* velocity[3] = { block.vx, block.vy, block.vz };
+            for (int axis = 0; axis < 3; ++axis) {
+                SimdFloat x = simdLoad(position[axis]);
+                SimdFloat v = simdLoad(velocity[axis]);
+                SimdFloat outward = simdOr(simdAnd(simdGreater(x, limit), simdGreater(v, zero)),
+                                           simdAnd(simdLess(x, lower), simdLess(v, zero)));
+                simdStore(velocity[axis], simdSelect(outward, zero - restitution * v, v));
+                simdStore(position[axis], simdClamp(x, lower, limit));
+            }
+        }
+    }, 512);
+}
+
+void sortSphereBlocks(SphereBlocks& blocks) {
+    const int count = static_cast<int>(blocks.count);
+    for (std::vector<float>* array : { &blocks.positionX, &blocks.positionY, &blocks.positionZ, &blocks.radius }) {
+        array->resize(count);
+    }
+    for (int i = 0; i < count; ++i) {
+        const SphereBlock& block = blocks.blocks[i / SIMD_WIDTH];
+        const int lane = i % SIMD_WIDTH;
+        blocks.positionX[i] = block.x[lane];
+        blocks.positionY[i] = block.y[lane];
+        blocks.positionZ[i] = block.z[lane];
+        blocks.radius[i] = block.radius[lane];
+    }
+    buildSpatialGrid(blocks.grid, blocks.positionX.data(), blocks.positionY.data(), blocks.positionZ.data(),
+        blocks.radius.data(), count);
+
+    // cellEntries[k], hcre srasnda k. yuvaya gelecek eski yuvadr; bo eritler kopyadan korunur
+    blocks.sorted = blocks.blocks;
+    blocks.sortedOrder.resize(count);
+    for (int k = 0; k < count; ++k) {
+        const int from = blocks.grid.cellEntries[k];
+        const SphereBlock& source = blocks.blocks[from / SIMD_WIDTH];
+        SphereBlock& target = blocks.sorted[k / SIMD_WIDTH];
+        const int a = from % SIMD_WIDTH, b = k % SIMD_WIDTH;
+        target.x[b] = source.x[a];
+        target.y[b] = source.y[a];
+        target.z[b] = source.z[a];
+        target.vx[b] = source.vx[a];
+        target.vy[b] = source.vy[a];
+        target.vz[b] = source.vz[a];
+        target.radius[b] = source.radius[a];
+        target.material[b] = source.material[a];
+        blocks.sortedOrder[k] = blocks.order[from];
+    }
+    blocks.blocks.swap(blocks.sorted);
+    blocks.order.swap(blocks.sortedOrder);
+}
+
+void findSphereBlockContacts(SphereBlocks& blocks, CandidatePairs& contacts) {
+    const SpatialGrid& grid = blocks.grid;
+    const int count = static_cast<int>(blocks.count);
+    const int threads = parallelThreadCount();
+    blocks.threadFirst.resize(threads);
+    blocks.threadSecond.resize(threads);
+    for (int t = 0; t < threads; ++t) {
+        blocks.threadFirst[t].clear();
+        blocks.threadSecond[t].clear();
+    }
+
+    // sortSphereBlocks'tan sonra yuva k'nn hcresi, cellStart aralndan bulunur
+    std::vector<int>& slotCell = blocks.slotCell;
+    slotCell.resize(count);
+    const int cellCount = grid.dims.x * grid.dims.y * grid.dims.z;
+    for (int c = 0; c < cellCount; ++c) {
+        for (int k = grid.cellStart[c]; k < grid.cellStart[c + 1]; ++k) {
+            slotCell[k] = c;
+        }
+    }
+
+    parallelFor(blocks.blocks.size(), [&](size_t begin, size_t end, int thread) {
+        std::vector<int>& first = blocks.threadFirst[thread];
+        std::vector<int>& second = blocks.threadSecond[thread];
+        for (size_t b = begin; b < end; ++b) {
+            const SphereBlock& block = blocks.blocks[b];
+            const int base = static_cast<int>(b) * SIMD_WIDTH;
+            const int lanes = std::min(SIMD_WIDTH, count - base);
+
+            // Bloun krelerinin hcrelerini saran kutu, bir hcre geniletilmi
+            glm::ivec3 lo(grid.dims), hi(-1);
+            for (int lane = 0; lane < lanes; ++lane) {
+                int cell = slotCell[base + lane];
+                glm::ivec3 c(cell % grid.dims.x, (cell / grid.dims.x) % grid.dims.y, cell / (grid.dims.x * grid.dims.y));
+                lo = glm::min(lo, c);
+                hi = glm::max(hi, c);
+            }
+            lo = glm::max(lo - 1, glm::ivec3(0));
+            hi = glm::min(hi + 1, grid.dims - 1);
+
+            SimdFloat ax = simdLoad(block.x), ay = simdLoad(block.y), az = simdLoad(block.z);
+            SimdFloat ar = simdLoad(block.radius);
+            // erit indeksleri bloa greli tutulur; mutlak indeks float'ta 2^24'ten sonra yuvarlanr
+            SimdFloat laneIndex = simdLaneIndex();
+            SimdFloat valid = simdLess(laneIndex, simdSet(static_cast<float>(lanes)));
+
+            for (int z = lo.z; z <= hi.z; ++z) {
+                for (int y = lo.y; y <= hi.y; ++y) {
+                    // Bir satrn hcreleri ardk olduundan kreleri de tek bir ardk aralktr
+                    int row = (z * grid.dims.y + y) * grid.dims.x;
+                    int from = std::max(grid.cellStart[row + lo.x], base + 1);
+                    int to = grid.cellStart[row + hi.x + 1];
+                    for (int j = from; j < to; ++j) {
+                        const SphereBlock& other = blocks.blocks[j / SIMD_WIDTH];
+                        const int lane = j % SIMD_WIDTH;
+                        SimdFloat dx = simdSet(other.x[lane]) - ax;
+                        SimdFloat dy = simdSet(other.y[lane]) - ay;
+                        SimdFloat dz = simdSet(other.z[lane]) - az;
+                        SimdFloat reach = simdSet(other.radius[lane]) + ar;
+                        // Her ift bir kez: yalnzca j > i olan eritler
+                        SimdFloat hit = simdAnd(simdLess(simdDot(dx, dy, dz, dx, dy, dz), reach * reach),
+                                                simdAnd(valid, simdGreater(simdSet(static_cast<float>(j - base)), laneIndex)));
+                        int mask = simdMoveMask(hit);
+                        while (mask) {
+                            int a = 0;
+                            while (!(mask & (1 << a))) ++a;
+                            mask &= mask - 1;
+                            first.push_back(blocks.order[base + a]);
+                            second.push_back(blocks.order[j]);
+                        }
+                    }
+                }
+            }
+        }
+    }, 64);
+
+    contacts.first.clear();
+    contacts.second.clear();
+    for (int t = 0; t < threads; ++t) {
+        contacts.first.insert(contacts.first.end(), blocks.threadFirst[t].begin(), blocks.threadFirst[t].end());
+        contacts.second.insert(contacts.second.end(), blocks.threadSecond[t].begin(), blocks.threadSecond[t].end());
+    }
+    contacts.count = static_cast<int>(contacts.first.size());
+    size_t padded = (contacts.first.size() + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH;
+    contacts.first.resize(padded, 0);
+    contacts.second.resize(padded, 0);
+}
+
+LayoutBenchmark benchmarkSphereLayout(const std::vector<Sphere>& spheres, SphereLayout layout, float cubeSize,
+    float deltaTime, int steps, const MaterialTable& materials, int wallMaterial, const glm::vec3& acceleration) {
+    LayoutBenchmark result;
+    const float half = 0.5f * cubeSize;
+    const float* wallRestitution = &materials.restitution[wallMaterial * MAX_MATERIALS];
+    std::vector<Sphere> aos = spheres;
+    SphereSystem soa;
+    std::vector<float> soaRestitution;
+    SphereBlocks aosoa;
+    ContainerFrame frame;
+    SpatialGrid grid;
+    CandidatePairs pairs;
+    if (layout == SPHERE_LAYOUT_SOA) loadSphereSystem(soa, spheres);
+    if (layout == SPHERE_LAYOUT_AOSOA) loadSphereBlocks(aosoa, spheres);
+
+    for (int step = 0; step < steps; ++step) {
+        auto start = std::chrono::steady_clock::now();
+        if (layout == SPHERE_LAYOUT_AOS) {
+            parallelFor(aos.size(), [&](size_t begin, size_t end, int) {
+                const glm::vec3 impulse = acceleration * deltaTime;
+                for (size_t i = begin; i < end; ++i) {
+                    aos[i].velocity += impulse;
+                    aos[i].position += aos[i].velocity * deltaTime;
+                }
+            }, 4096);
+        } else if (layout == SPHERE_LAYOUT_SOA) {
+            integrateSphereSystem(soa, deltaTime, acceleration, 0.0f);
+        } else {
+            integrateSphereBlocks(aosoa, deltaTime, acceleration, 0.0f);
+        }
+        result.integrateMs += elapsedMs(start);
+
+        start = std::chrono::steady_clock::now();
+        if (layout == SPHERE_LAYOUT_AOS) {
+            transformToContainerFrame(aos, Container(), half, frame);
+            bounceOffBoxWalls(aos, wallRestitution, half, frame);
+            for (int s : frame.contacts) {
+                aos[s].position = glm::vec3(frame.positionX[s], frame.positionY[s], frame.positionZ[s]);
+                aos[s].velocity = glm::vec3(frame.velocityX[s], frame.velocityY[s], frame.velocityZ[s]);
+            }
+        } else if (layout == SPHERE_LAYOUT_SOA) {
+            bounceSphereSystemOffWalls(soa, half, wallRestitution, soaRestitution);
+        } else {
+            bounceSphereBlocksOffWalls(aosoa, half, wallRestitution);
+        }
+        result.wallMs += elapsedMs(start);
+
+        start = std::chrono::steady_clock::now();
+        if (layout == SPHERE_LAYOUT_AOS) {
+            buildSpatialGrid(grid, aos);
+            findCandidatePairs(grid, pairs);
+            result.contacts = countContacts(pairs,
+                [&](int i) { return aos[i].position; }, [&](int i) { return aos[i].radius; });
+        } else if (layout == SPHERE_LAYOUT_SOA) {
+            buildSpatialGrid(grid, soa.x.data(), soa.y.data(), soa.z.data(), soa.radius.data(), static_cast<int>(soa.count));
+            findCandidatePairs(grid, pairs);
+            result.contacts = countContacts(pairs,
+                [&](int i) { return glm::vec3(soa.x[i], soa.y[i], soa.z[i]); }, [&](int i) { return soa.radius[i]; });
+        } else {
+            sortSphereBlocks(aosoa);
+            findSphereBlockContacts(aosoa, pairs);
+            result.contacts = pairs.count;
+        }
+        result.pairMs += elapsedMs(start);
+    }
+
+    if (steps > 0) {
+        result.integrateMs /= steps;
+        result.wallMs /= steps;
+        result.pairMs /= steps;
+    }
+    return result;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Sphere.h"
+#include "Material.h"
+#include "Simd.h"
+#include "SpatialGrid.h"
+#include <glm/glm.hpp>
+#include <vector>
+
+
+// AoSoA saklama: kreler SIMD_WIDTH'lik bloklarda, her alan blok iinde bitiik. Bir alann bir
+// blok yklemesi tam bir SIMD yazmacn doldurur; bir krenin tm alanlar ayn 256 baytlk bloktadr.
+// Genilik Simd.h'deki SIMD_WIDTH'tir (AVX2 iin 8); daha geni bir SIMD katman bloklar da geniletir.
+struct SphereBlock {
+    float x[SIMD_WIDTH], y[SIMD_WIDTH], z[SIMD_WIDTH];
+    float vx[SIMD_WIDTH], vy[SIMD_WIDTH], vz[SIMD_WIDTH];
+    float radius[SIMD_WIDTH];
+    int material[SIMD_WIDTH];
+};
+
+// Son bloun bo eritleri merkezde, sfr yarap ve hzla durur. Bloklar sortSphereBlocks ile hcre
+// srasna dizilir; order her yuvadaki krenin zgn indeksidir.
+struct SphereBlocks {
+    size_t count = 0;
+    std::vector<SphereBlock> blocks;
+    std::vector<int> order;
+
+    // Hcre sralamas ve ift testi iin ara tamponlar
+    SpatialGrid grid;
+    std::vector<float> positionX, positionY, positionZ, radius;
+    std::vector<SphereBlock> sorted;
+    std::vector<int> sortedOrder;
+    std::vector<int> slotCell;
+    std::vector<std::vector<int>> threadFirst, threadSecond;
+};
+
+// std::vector<Sphere> ile dnm; renk bloklarda tutulmaz, store yalnzca fiziksel alanlar yazar
+void loadSphereBlocks(SphereBlocks& blocks, const std::vector<Sphere>& spheres);
+void storeSphereBlocks(const SphereBlocks& blocks, std::vector<Sphere>& spheres);
+
+// Yar rtk Euler, blok bana bir ykleme ve bir yazma
+void integrateSphereBlocks(SphereBlocks& blocks, float deltaTime, const glm::vec3& acceleration, float drag);
+
+// Kutu duvarlar (merkez orijinde): yalnzca da giden hz yansr, konum ieri kstrlr; srtnmesiz
+void bounceSphereBlocksOffWalls(SphereBlocks& blocks, float halfCubeSize, const float* wallRestitution);
+
+// Kreleri zgara hcresi srasna dizer; findSphereBlockContacts bu sray ve blocks.grid'i kullanr
+void sortSphereBlocks(SphereBlocks& blocks);
+
+// Hcre sral bloklar zerinde temas eden iftler: her blok (8 erit) komu hcrelerindeki krelerle
+// tek tek yaynlanarak karlatrlr. iftler zgn kre indeksleriyle, her biri bir kez yazlr.
+void findSphereBlockContacts(SphereBlocks& blocks, CandidatePairs& contacts);
+
+// Karlatrma iin alma zamannda seilen saklama dzeni
+enum SphereLayout {
+    SPHERE_LAYOUT_AOS,   // std::vector<Sphere>
+    SPHERE_LAYOUT_SOA,   // SphereSystem
+    SPHERE_LAYOUT_AOSOA, // SphereBlocks
+};
+
+struct LayoutBenchmark {
+    double integrateMs = 0.0; // Adm bana ortalamalar
+    double wallMs = 0.0;
+    double pairMs = 0.0;      // Izgara (ve AoSoA'da hcre sralamas) dahil
+    int contacts = 0;         // Son admdaki temas says; dzenler arasnda ayn olmaldr
+};
+
+// Krelerin bir kopyas zerinde steps adm tmleme, duvar ve temas testi koar
+LayoutBenchmark benchmarkSphereLayout(const std::vector<Sphere>& spheres, SphereLayout layout, float cubeSize,
+    float deltaTime, int steps, const MaterialTable& materials, int wallMaterial, const glm::vec3& acceleration);
@@ -0,0 +1,136 @@
+#include "SphereHandles.h"
+#include "Simulation.h"
+
+#include <algorithm>
+#include <functional>
+
+
+void resetSphereHandles(SphereHandleMap& handles, size_t count) {
+    handles.enabled = true;
+    handles.slotIndex.resize(count);
+    handles.slotGeneration.assign(count, 1);
+    handles.denseSlot.resize(count);
+    handles.freeSlots.clear();
+    for (size_t i = 0; i < count; ++i) {
+        handles.slotIndex[i] = static_cast<uint32_t>(i);
+        handles.denseSlot[i] = static_cast<uint32_t>(i);
+    }
+}
+
+void reserveSphereHandles(SphereHandleMap& handles, size_t capacity) {
+    // Yuva says en fazla ayn anda yaayan kre says kadardr: yuvalar yeniden kullanlr
+    handles.slotIndex.reserve(capacity);
+    handles.slotGeneration.reserve(capacity);
+    handles.denseSlot.reserve(capacity);
+    handles.freeSlots.reserve(capacity);
+    handles.removeIndices.reserve(capacity);
+}
+
+SphereHandle sphereHandle(const SphereHandleMap& handles, size_t index) {
+    SphereHandle handle;
+    handle.slot = handles.denseSlot[index];
+    handle.generation = handles.slotGeneration[handle.slot];
+    return handle;
+}
+
+int findSphere(const SphereHandleMap& handles, SphereHandle handle) {
+    if (handle.slot >= handles.slotGeneration.size() || handles.slotGeneration[handle.slot] != handle.generation) {
+        return -1;
+    }
+    return static_cast<int>(handles.slotIndex[handle.slot]);
+}
+
+void addSphereHandle(SphereHandleMap& handles, size_t index) {
+    if (!handles.enabled) return;
+    uint32_t slot;
+    if (!handles.freeSlots.empty()) {
+        slot = handles.freeSlots.back();
+        handles.freeSlots.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(handles.slotGeneration.size());
+        handles.slotIndex.push_back(0);
+        handles.slotGeneration.push_back(1);
+    }
+    handles.slotIndex[slot] = static_cast<uint32_t>(index);
+    handles.denseSlot.push_back(slot);
+}
+
+void removeSphereHandle(SphereHandleMap& handles, size_t index) {
+    if (!handles.enabled) return;
+    const size_t last = handles.denseSlot.size() - 1;
+    const uint32_t slot = handles.denseSlot[index];
+    // Nesil taarsa 0 atlanr
+    uint32_t generation = handles.slotGeneration[slot] + 1;
+    handles.slotGeneration[slot] = generation != 0 ? generation : 1;
+    handles.freeSlots.push_back(slot);
+
+    if (index != last) {
+        const uint32_t moved = handles.denseSlot[last];
+        handles.denseSlot[index] = moved;
+        handles.slotIndex[moved] = static_cast<uint32_t>(index);
+    }
+    handles.denseSlot.pop_back();
+}
+
+void permuteSphereHandles(SphereHandleMap& handles, const std::vector<int>& order) {
+    if (!handles.enabled || handles.denseSlot.size() != order.size()) return;
+    handles.scratch.assign(handles.denseSlot.begin(), handles.denseSlot.end());
+    for (size_t i = 0; i < order.size(); ++i) {
+        const uint32_t slot = handles.scratch[order[i]];
+        handles.denseSlot[i] = slot;
+        handles.slotIndex[slot] = static_cast<uint32_t>(i);
+    }
+}
+
+SphereHandle insertSphere(std::vector<Sphere>& spheres, SimulationContext& context, const Sphere& sphere) {
+    SphereHandleMap& handles = context.handles;
+    if (!handles.enabled) resetSphereHandles(handles, spheres.size());
+    if (!spawnSphere(spheres, context, sphere)) return SphereHandle();
+    return sphereHandle(handles, spheres.size() - 1);
+}
+
+bool removeSphere(std::vector<Sphere>& spheres, SimulationContext& context, SphereHandle handle) {
+    int index = findSphere(context.handles, handle);
+    if (index < 0) return false;
+    despawnSphere(spheres, context, index);
+    return true;
+}
+
+size_t insertSpheres(std::vector<Sphere>& spheres, SimulationContext& context, const std::vector<Sphere>& added,
+    std::vector<SphereHandle>* handles) {
+    SphereHandleMap& map = context.handles;
+    if (!map.enabled) resetSphereHandles(map, spheres.size());
+    if (spheres.size() + added.size() > context.pool.capacity) {
+        reserveSpherePool(spheres, context, spheres.size() + added.size());
+    }
+
+    const size_t first = spheres.size();
+    for (const Sphere& sphere : added) {
+        spawnSphere(spheres, context, sphere);
+    }
+    if (handles) {
+        handles->resize(added.size());
+        for (size_t i = 0; i < added.size(); ++i) {
+            (*handles)[i] = sphereHandle(map, first + i);
+        }
+    }
+    return added.size();
+}
+
+size_t removeSpheres(std::vector<Sphere>& spheres, SimulationContext& context, const std::vector<SphereHandle>& removed) {
+    SphereHandleMap& map = context.handles;
+    std::vector<int>& indices = map.removeIndices;
+    indices.clear();
+    for (SphereHandle handle : removed) {
+        int index = findSphere(map, handle);
+        if (index >= 0) indices.push_back(index);
+    }
+
+    // Bykten ke: sondan tanan kre her zaman karlmayacak bir kredir
+    std::sort(indices.begin(), indices.end(), std::greater<int>());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+    for (int index : indices) {
+        despawnSphere(spheres, context, index);
+    }
+    return indices.size();
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Sphere.h"
+#include <cstdint>
+#include <vector>
+
+
+struct SimulationContext;
+
+// Kreye kalc tutama: yuva numaras ve o yuvann nesli. Kre karlnca yuvann nesli artar, eski
+// tutamalar geersizleir. Nesil 0 hibir zaman geerli deildir; varsaylan tutama botur.
+struct SphereHandle {
+    uint32_t slot = 0;
+    uint32_t generation = 0;
+};
+
+// Yuva haritas (slot map). Kreler yine spheres dizisinde youn durur ve scak dngler onu dorudan
+// iler; harita yalnzca tutama ile youn indeks arasndaki ift ynl elemedir. Havuzdan ekleme ve
+// karma (takas ve son eleman atma) ile Morton sralamas haritay kendiliinden gnceller.
+struct SphereHandleMap {
+    bool enabled = false; // resetSphereHandles ya da ilk insertSphere ile alr
+
+    std::vector<uint32_t> slotIndex;      // Yuva bana: krenin youn indeksi (bo yuvalarda anlamsz)
+    std::vector<uint32_t> slotGeneration; // Yuva bana: geerli nesil
+    std::vector<uint32_t> denseSlot;      // Kre bana: yuvas
+    std::vector<uint32_t> freeSlots;      // Bo yuvalar, son boalan nce kullanlr
+
+    // Toplu karma ve permtasyon iin ara tamponlar
+    std::vector<int> removeIndices;
+    std::vector<uint32_t> scratch;
+};
+
+// Haritay mevcut count kreyle kurar: kre i, i. yuvay alr
+void resetSphereHandles(SphereHandleMap& handles, size_t count);
+
+// Harita dizilerini capacity kre iin ayrr (reserveSpherePool arr)
+void reserveSphereHandles(SphereHandleMap& handles, size_t capacity);
+
+// Youn indeksteki krenin tutamac
+SphereHandle sphereHandle(const SphereHandleMap& handles, size_t index);
+
+// Tutamacn gsterdii krenin youn indeksi; kre karlmsa -1
+int findSphere(const SphereHandleMap& handles, SphereHandle handle);
+
+// Dizideki deiikliklerin haritaya yansmas (harita kapalysa etkisizdir). add, sona eklenen kre
+// iindir; remove, index'teki kreyi karp son kreyi onun yerine tar; permute, order[yeni] = eski.
+void addSphereHandle(SphereHandleMap& handles, size_t index);
+void removeSphereHandle(SphereHandleMap& handles, size_t index);
+void permuteSphereHandles(SphereHandleMap& handles, const std::vector<int>& order);
+
+// Tutamal ekleme ve karma; kre bana durum (dnme, duvar takvimi) spawnSphere/despawnSphere ile
+// birlikte tanr. Havuz doluysa insertSphere bo tutama dner.
+SphereHandle insertSphere(std::vector<Sphere>& spheres, SimulationContext& context, const Sphere& sphere);
+bool removeSphere(std::vector<Sphere>& spheres, SimulationContext& context, SphereHandle handle);
+
+// Toplu ilemler: ekleme kapasiteyi gerekirse bir kez bytr, tutamalar handles'a (varsa) yazar;
+// karma geersiz ve yinelenen tutamalar atlar. kisi de ilenen kre saysn dner.
+size_t insertSpheres(std::vector<Sphere>& spheres, SimulationContext& context, const std::vector<Sphere>& added,
+    std::vector<SphereHandle>* handles = nullptr);
+size_t removeSpheres(std::vector<Sphere>& spheres, SimulationContext& context, const std::vector<SphereHandle>& removed);
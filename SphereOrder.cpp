@@ -0,0 +1,177 @@
+#include "SphereOrder.h"
+#include "Parallel.h"
+#include "Simulation.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+
+namespace {
+
+// Eksen bana 10 bit: 30 bitlik kod nbellek yerellii iin yeterlidir ve indeksle tek anahtara sar
+const int kMortonBits = 10;
+
+uint32_t spreadBits(uint32_t value) {
+    value &= 0x3ff;
+    value = (value | value << 16) & 0x030000ff;
+    value = (value | value << 8) & 0x0300f00f;
+    value = (value | value << 4) & 0x030c30c3;
+    value = (value | value << 2) & 0x09249249;
+    return value;
+}
+
+// Anahtar: st 32 bitte Morton kodu, alt 32 bitte zgn indeks
+void computeMortonKeys(const std::vector<Sphere>& spheres, std::vector<uint64_t>& keys) {
+    const int threads = parallelThreadCount();
+    std::vector<glm::vec3> lower(threads, glm::vec3(1e30f)), upper(threads, glm::vec3(-1e30f));
+    parallelFor(spheres.size(), [&](size_t begin, size_t end, int thread) {
+        glm::vec3 low(1e30f), high(-1e30f);
+        for (size_t i = begin; i < end; ++i) {
+            low = glm::min(low, spheres[i].position);
+            high = glm::max(high, spheres[i].position);
+        }
+        lower[thread] = glm::min(lower[thread], low);
+        upper[thread] = glm::max(upper[thread], high);
+    });
+    glm::vec3 low(1e30f), high(-1e30f);
+    for (int t = 0; t < threads; ++t) {
+        low = glm::min(low, lower[t]);
+        high = glm::max(high, upper[t]);
+    }
+    const float cells = static_cast<float>((1 << kMortonBits) - 1);
+    const glm::vec3 scale = cells / glm::max(high - low, glm::vec3(1e-6f));
+
+    keys.resize(spheres.size());
+    parallelFor(spheres.size(), [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; ++i) {
+            glm::vec3 cell = glm::clamp((spheres[i].position - low) * scale, glm::vec3(0.0f), glm::vec3(cells));
+            uint32_t code = spreadBits(static_cast<uint32_t>(cell.x)) << 2 | spreadBits(static_cast<uint32_t>(cell.y)) << 1 |
+                spreadBits(static_cast<uint32_t>(cell.z));
+            keys[i] = static_cast<uint64_t>(code) << 32 | static_cast<uint64_t>(i);
+        }
+    }, 4096);
+}
+
+// Kodun 30 biti zerinde kararl LSD taban sralamas (8 bitlik 4 gei); eit kodlu kreler mevcut
+// sralarn korur, bylece zaten yerel olan blgeler yerinde kalr
+void sortKeys(std::vector<uint64_t>& keys, std::vector<uint64_t>& sorted) {
+    sorted.resize(keys.size());
+    for (int shift = 32; shift < 32 + 3 * kMortonBits; shift += 8) {
+        size_t offsets[256] = {};
+        for (uint64_t key : keys) {
+            ++offsets[(key >> shift) & 255];
+        }
+        size_t total = 0;
+        for (size_t& offset : offsets) {
+            size_t value = offset;
+            offset = total;
+            total += value;
+        }
+        for (uint64_t key : keys) {
+            sorted[offsets[(key >> shift) & 255]++] = key;
+        }
+        std::swap(keys, sorted);
+    }
+}
+
+} // namespace
+
+
+float measureSphereLocality(const CandidatePairs& pairs, size_t count, int window) {
+    if (pairs.count == 0) return 0.0f;
+
+    const int threads = parallelThreadCount();
+    std::vector<size_t> far(threads, 0), total(threads, 0);
+    const int limit = static_cast<int>(count);
+    parallelFor(pairs.count, [&](size_t begin, size_t end, int thread) {
+        size_t farPairs = 0, counted = 0;
+        for (size_t p = begin; p < end; ++p) {
+            int a = pairs.first[p];
+            int b = pairs.second[p];
+            if (a >= limit || b >= limit) continue; // ekil vekilleri
+            ++counted;
+            farPairs += std::abs(a - b) > window;
+        }
+        far[thread] += farPairs;
+        total[thread] += counted;
+    }, 16384);
+
+    size_t farPairs = 0, counted = 0;
+    for (int t = 0; t < threads; ++t) {
+        farPairs += far[t];
+        counted += total[t];
+    }
+    return counted > 0 ? static_cast<float>(farPairs) / static_cast<float>(counted) : 0.0f;
+}
+
+void reorderSpheres(std::vector<Sphere>& spheres, SimulationContext& context) {
+    SphereOrder& state = context.sphereOrder;
+    const size_t count = spheres.size();
+    computeMortonKeys(spheres, state.keys);
+    sortKeys(state.keys, state.sortedKeys);
+
+    state.order.resize(count);
+    state.newIndex.resize(count);
+    state.sortedSpheres.resize(count);
+    parallelFor(count, [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; ++i) {
+            int previous = static_cast<int>(state.keys[i] & 0xffffffffu);
+            state.order[i] = previous;
+            state.newIndex[previous] = static_cast<int>(i);
+            state.sortedSpheres[i] = spheres[previous];
+        }
+    }, 4096);
+    std::swap(spheres, state.sortedSpheres);
+
+    // Kre bana durum ayn permtasyonla tanr
+    resizeRotationState(context.rotation, count);
+    permuteSphereRotation(context.rotation, state.order, state.scratch);
+    permuteWallSchedule(context.wallSchedule, state.order, state.newIndex);
+    permuteSphereHandles(context.handles, state.order);
+    std::vector<int>& sphereContainer = context.batch.sphereContainer;
+    if (sphereContainer.size() == count) {
+        state.scratchIndex.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            state.scratchIndex[i] = sphereContainer[state.order[i]];
+        }
+        std::swap(sphereContainer, state.scratchIndex);
+    }
+
+    ++state.reorders;
+    state.baseline = -1.0f;
+}
+
+bool updateSphereOrder(std::vector<Sphere>& spheres, SimulationContext& context) {
+    SphereOrder& state = context.sphereOrder;
+    const long long step = state.step++;
+    if (step < state.nextCheck || spheres.size() < 2) return false;
+    state.nextCheck = step + std::max(state.settings.checkInterval, 1);
+
+    // lk denetimde balang sras bilinmediinden her zaman sralanr; sonraki admda llen deer
+    // taban olur. nceki admn iftleri sralamadan nceki indeksleri tad iin taban bir adm bekler.
+    if (state.reorders == 0) {
+        reorderSpheres(spheres, context);
+        state.nextCheck = step + 1;
+        return true;
+    }
+
+    const float metric = measureSphereLocality(context.pairs, spheres.size(), state.settings.window);
+    state.lastMetric = metric;
+    if (state.baseline < 0.0f) {
+        state.baseline = metric;
+        return false;
+    }
+    if (metric <= state.settings.minimumFarFraction || metric <= state.baseline * state.settings.degradation) {
+        return false;
+    }
+    reorderSpheres(spheres, context);
+    state.nextCheck = step + 1;
+    return true;
+}
+
+void remapSphereIndices(const SphereOrder& order, std::vector<int>& indices) {
+    const int count = static_cast<int>(order.newIndex.size());
+    for (int& index : indices) {
+        if (index >= 0 && index < count) index = order.newIndex[index];
+    }
+}
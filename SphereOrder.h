@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Sphere.h"
+#include "SpatialGrid.h"
+#include <cstdint>
+#include <vector>
+
+
+struct SimulationContext;
+
+struct SphereOrderSettings {
+    bool enabled = false;
+    int checkInterval = 32;          // Yerellik ls bu kadar admda bir hesaplanr
+    int window = 256;                // ndeks fark bundan byk olan aday iftler "uzak" saylr
+    float degradation = 1.5f;        // Uzak oran sralamadan hemen sonraki deerin bu katn anca sralanr
+    float minimumFarFraction = 0.05f; // Bu orann altnda hi sralanmaz
+};
+
+// Krelerin bellekteki sras. Admlar ilerledike uzayda komu kreler dizide birbirinden uzaklar
+// ve geni/dar faz nbellei karr; yerellik bozulunca tm kre durumu konumlarn Morton koduna gre
+// yeniden dizilir. l, bir nceki admn aday iftlerinden indeks fark window'u aanlarn orandr.
+struct SphereOrder {
+    SphereOrderSettings settings;
+    long long step = 0;
+    long long nextCheck = 0;
+    float baseline = -1.0f; // Son sralamadan sonraki ilk l; henz llmediyse negatif
+    float lastMetric = 0.0f;
+    int reorders = 0;       // Dardaki indeks tutucular bu saya deiince remapSphereIndices arr
+
+    // Son sralamann elemeleri: order[yeni] = eski, newIndex[eski] = yeni
+    std::vector<int> order, newIndex;
+
+    // Ara tamponlar
+    std::vector<uint64_t> keys, sortedKeys;
+    std::vector<Sphere> sortedSpheres;
+    std::vector<float> scratch;
+    std::vector<int> scratchIndex;
+    std::vector<size_t> threadFar;
+};
+
+// Aday iftlerden (count'tan kk indeksliler) indeks fark window'u aanlarn oran
+float measureSphereLocality(const CandidatePairs& pairs, size_t count, int window);
+
+// Kreleri ve kre bana tm durumu (dnme, duvar takvimi, kutu dnyas atamalar, tutamalar) Morton
+// srasna dizer
+void reorderSpheres(std::vector<Sphere>& spheres, SimulationContext& context);
+
+// Adm bana arlr: ilk denetimde ve yerellik bozulduunda sralar; sraladysa true dner
+bool updateSphereOrder(std::vector<Sphere>& spheres, SimulationContext& context);
+
+// Son sralamadan nce alnm kre indekslerini yeni indekslere evirir; negatif indeksler korunur.
+// SphereHandle kullanan kodun bunu armas gerekmez.
+void remapSphereIndices(const SphereOrder& order, std::vector<int>& indices);
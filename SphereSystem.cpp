@@ -0,0 +1,101 @@
+#include "SphereSystem.h"
+#include "Parallel.h"
+#include "Simd.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace {
+
+// Bir eksende duvar tepkisi. Dallanma yok: seim 0/1 arpanyla harmanlanr, kstrma min/max'a iner
+// ve derleyici dngy dorudan vektrletirir. Malzeme aramas (toplama) dngnn dndadr.
+void bounceAxis(float* position, float* velocity, const float* radius, const float* restitution,
+    size_t begin, size_t end, float halfCubeSize) {
+    for (size_t i = begin; i < end; ++i) {
+        float limit = halfCubeSize - radius[i];
+        float p = position[i];
+        float v = velocity[i];
+        float outward = static_cast<float>(((p > limit) & (v > 0.0f)) | ((p < -limit) & (v < 0.0f)));
+        velocity[i] = v - outward * (1.0f + restitution[i]) * v;
+        position[i] = std::min(std::max(p, -limit), limit);
+    }
+}
+
+// Sabitler deerle gelir: lambda yakalamasyla gelen referanslar dizilere yazmayla rtebilir
+// sayldndan dng vektrlemezdi
+void integrateAxis(float* position, float* velocity, size_t begin, size_t end, float impulse, float damping,
+    float deltaTime) {
+    for (size_t i = begin; i < end; ++i) {
+        float v = velocity[i] * damping + impulse;
+        velocity[i] = v;
+        position[i] += v * deltaTime;
+    }
+}
+
+} // namespace
+
+
+void loadSphereSystem(SphereSystem& system, const std::vector<Sphere>& spheres) {
+    const size_t count = spheres.size();
+    const size_t padded = (count + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH;
+    system.count = count;
+    for (std::vector<float>* array : { &system.x, &system.y, &system.z, &system.vx, &system.vy, &system.vz, &system.radius }) {
+        array->assign(padded, 0.0f);
+    }
+    system.material.assign(padded, 0);
+    system.color.resize(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        const Sphere& sphere = spheres[i];
+        system.x[i] = sphere.position.x;
+        system.y[i] = sphere.position.y;
+        system.z[i] = sphere.position.z;
+        system.vx[i] = sphere.velocity.x;
+        system.vy[i] = sphere.velocity.y;
+        system.vz[i] = sphere.velocity.z;
+        system.radius[i] = sphere.radius;
+        system.color[i] = sphere.color;
+        system.material[i] = sphere.material;
+    }
+}
+
+void storeSphereSystem(const SphereSystem& system, std::vector<Sphere>& spheres) {
+    spheres.resize(system.count);
+    for (size_t i = 0; i < system.count; ++i) {
+        Sphere& sphere = spheres[i];
+        sphere.position = glm::vec3(system.x[i], system.y[i], system.z[i]);
+        sphere.velocity = glm::vec3(system.vx[i], system.vy[i], system.vz[i]);
+        sphere.radius = system.radius[i];
+        sphere.color = system.color[i];
+        sphere.material = system.material[i];
+    }
+}
+
+void integrateSphereSystem(SphereSystem& system, float deltaTime, const glm::vec3& acceleration, float drag) {
+    const glm::vec3 impulse = acceleration * deltaTime;
+    const float damping = std::exp(-drag * deltaTime);
+    float* position[3] = { system.x.data(), system.y.data(), system.z.data() };
+    float* velocity[3] = { system.vx.data(), system.vy.data(), system.vz.data() };
+
+    // Eksenler ayr dz dnglerdir: her biri iki diziyi srayla okuyup yazar
+    parallelFor(system.x.size(), [&](size_t begin, size_t end, int) {
+        for (int axis = 0; axis < 3; ++axis) {
+            integrateAxis(position[axis], velocity[axis], begin, end, impulse[axis], damping, deltaTime);
+        }
+    }, 4096);
+}
+
+void bounceSphereSystemOffWalls(SphereSystem& system, float halfCubeSize, const float* wallRestitution,
+    std::vector<float>& restitution) {
+    const size_t padded = system.x.size();
+    restitution.resize(padded);
+    parallelFor(padded, [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; ++i) {
+            restitution[i] = wallRestitution[system.material[i]];
+        }
+        bounceAxis(system.x.data(), system.vx.data(), system.radius.data(), restitution.data(), begin, end, halfCubeSize);
+        bounceAxis(system.y.data(), system.vy.data(), system.radius.data(), restitution.data(), begin, end, halfCubeSize);
+        bounceAxis(system.z.data(), system.vz.data(), system.radius.data(), restitution.data(), begin, end, halfCubeSize);
+    }, 4096);
+}
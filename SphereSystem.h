@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Sphere.h"
+#include <glm/glm.hpp>
+#include <vector>
+
+
+// Dzen karlatrmasnn (benchmarkSphereLayout) SoA kolu; simlasyonun saklamas deildir. Her admda
+// okunan scak alanlar (konum, hz, yarap, tepki tablosu iin malzeme) ayr dizilerdedir, yalnzca
+// izimde kullanlan souk alanlar (renk) ayr tutulur. Scak diziler SIMD_WIDTH katna tamamlanr;
+// dolgu kreleri merkezde, sfr yarap ve hzla durur.
+// updateSimulation std::vector<Sphere> zerinde koar; SoA gereken geiler kendi durumlarn kurar
+// (ContainerFrame, DemState, LennardJonesState). Adm bana bu yapya evirip geri yazmak, tmleme
+// ve duvar dnglerinden kazanlandan pahaldr.
+struct SphereSystem {
+    size_t count = 0;
+
+    // Scak
+    std::vector<float> x, y, z;
+    std::vector<float> vx, vy, vz;
+    std::vector<float> radius;
+    std::vector<int> material;
+
+    // Souk
+    std::vector<glm::vec3> color;
+};
+
+// std::vector<Sphere> kullanan kod iin dntrcler: tm alanlar iki ynde kopyalanr
+void loadSphereSystem(SphereSystem& system, const std::vector<Sphere>& spheres);
+void storeSphereSystem(const SphereSystem& system, std::vector<Sphere>& spheres);
+
+// Yar rtk Euler: v <- v exp(-drag dt) + a dt, ardndan x <- x + v dt
+void integrateSphereSystem(SphereSystem& system, float deltaTime, const glm::vec3& acceleration, float drag);
+
+// Kutu duvarlar (merkez orijinde): yalnzca duvara doru giden hz sekme katsaysyla yansr, konum
+// ieri kstrlr. wallRestitution duvar malzemesinin satrdr (kre malzemesiyle indekslenir);
+// restitution arann ara tamponudur, kre bana zlen katsayy tutar. Srtnme ve dnme uygulanmaz.
+void bounceSphereSystemOffWalls(SphereSystem& system, float halfCubeSize, const float* wallRestitution,
+    std::vector<float>& restitution);
@@ -0,0 +1,298 @@
+#include "TriangleMesh.h"
+#include "Parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+
+namespace {
+
+const int kBinCount = 16;
+const int kMaxLeafSize = 4;
+const int kMaxContacts = 16; // Kre bana; fazlas atlr (youn kelerde bile yeterli)
+
+struct Bounds {
+    glm::vec3 lo = glm::vec3(1e30f);
+    glm::vec3 hi = glm::vec3(-1e30f);
+
+    void grow(const glm::vec3& p) {
+        lo = glm::min(lo, p);
+        hi = glm::max(hi, p);
+    }
+    void grow(const Bounds& b) {
+        lo = glm::min(lo, b.lo);
+        hi = glm::max(hi, b.hi);
+    }
+    float area() const {
+        glm::vec3 e = glm::max(hi - lo, glm::vec3(0.0f));
+        return e.x * e.y + e.y * e.z + e.z * e.x;
+    }
+};
+
+// OBJ yz kesi "v", "v/t", "v//n" ya da "v/t/n"; yalnzca konum indeksi kullanlr
+bool parseFaceIndex(const std::string& token, int vertexCount, int& index) {
+    int value = std::atoi(token.c_str());
+    if (value == 0) return false;
+    index = value > 0 ? value - 1 : vertexCount + value;
+    return index >= 0 && index < vertexCount;
+}
+
+// Ericson, Real-Time Collision Detection 5.1.5: gen zerinde p'ye en yakn nokta
+glm::vec3 closestPointOnTriangle(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+    glm::vec3 ab = b - a, ac = c - a, ap = p - a;
+    float d1 = glm::dot(ab, ap), d2 = glm::dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f) return a;
+
+    glm::vec3 bp = p - b;
+    float d3 = glm::dot(ab, bp), d4 = glm::dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3) return b;
+
+    float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) return a + ab * (d1 / (d1 - d3));
+
+    glm::vec3 cp = p - c;
+    float d5 = glm::dot(ab, cp), d6 = glm::dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6) return c;
+
+    float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) return a + ac * (d2 / (d2 - d6));
+
+    float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+    float denominator = 1.0f / (va + vb + vc);
+    return a + ab * (vb * denominator) + ac * (vc * denominator);
+}
+
+// |ab x ac|^2 = |ab|^2 |ac|^2 sin^2: a float duyarlnda sfrsa (ya da bir kenar bosa) gen dejeneredir
+bool isDegenerate(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+    glm::vec3 ab = b - a, ac = c - a;
+    glm::vec3 normal = glm::cross(ab, ac);
+    return glm::dot(normal, normal) <= 1e-12f * glm::dot(ab, ab) * glm::dot(ac, ac);
+}
+
+struct MeshContact {
+    glm::vec3 point;
+    glm::vec3 normal; // genden kreye
+};
+
+} // namespace
+
+
+bool loadObjMesh(const std::string& path, TriangleMesh& mesh) {
+    std::ifstream file(path);
+    if (!file) return false;
+
+    mesh.vertices.clear();
+    mesh.triangles.clear();
+    std::string line;
+    std::vector<int> face;
+    while (std::getline(file, line)) {
+        std::istringstream stream(line);
+        std::string keyword;
+        stream >> keyword;
+        if (keyword == "v") {
+            glm::vec3 v(0.0f);
+            stream >> v.x >> v.y >> v.z;
+            mesh.vertices.push_back(v);
+        } else if (keyword == "f") {
+            face.clear();
+            std::string token;
+            int index;
+            while (stream >> token) {
+                if (parseFaceIndex(token, static_cast<int>(mesh.vertices.size()), index)) face.push_back(index);
+            }
+            for (size_t k = 2; k < face.size(); ++k) {
+                glm::ivec3 triangle(face[0], face[k - 1], face[k]);
+                if (isDegenerate(mesh.vertices[triangle.x], mesh.vertices[triangle.y], mesh.vertices[triangle.z])) continue;
+                mesh.triangles.push_back(triangle);
+            }
+        }
+    }
+    return !mesh.triangles.empty();
+}
+
+void buildMeshBvh(TriangleMesh& mesh) {
+    const int count = static_cast<int>(mesh.triangles.size());
+    std::vector<Bounds> bounds(count);
+    std::vector<glm::vec3> centroids(count);
+    std::vector<int> order(count);
+    for (int t = 0; t < count; ++t) {
+        const glm::ivec3& tri = mesh.triangles[t];
+        for (int k = 0; k < 3; ++k) {
+            bounds[t].grow(mesh.vertices[tri[k]]);
+        }
+        centroids[t] = (bounds[t].lo + bounds[t].hi) * 0.5f;
+        order[t] = t;
+    }
+
+    mesh.nodes.clear();
+    mesh.nodes.reserve(std::max(2 * count - 1, 1));
+    mesh.nodes.push_back(BvhNode{ glm::vec3(0.0f), 0, glm::vec3(0.0f), count });
+    mesh.depth = 0;
+
+    // Dmler ak bir ynla blnr; ocuklar her zaman yan yana eklenir. Yn (dm, seviye) tutar.
+    std::vector<glm::ivec2> pending(1, glm::ivec2(0, 0));
+    while (!pending.empty()) {
+        const int nodeIndex = pending.back().x;
+        const int level = pending.back().y;
+        pending.pop_back();
+        mesh.depth = std::max(mesh.depth, level);
+        const int first = mesh.nodes[nodeIndex].first;
+        const int size = mesh.nodes[nodeIndex].count;
+
+        Bounds box, centroidBox;
+        for (int i = first; i < first + size; ++i) {
+            box.grow(bounds[order[i]]);
+            centroidBox.grow(centroids[order[i]]);
+        }
+        mesh.nodes[nodeIndex].lo = box.lo;
+        mesh.nodes[nodeIndex].hi = box.hi;
+        if (size <= kMaxLeafSize) continue;
+
+        // Her eksende arlk merkezleri kutulara datlr; en dk SAH maliyetli kutu snr seilir
+        float bestCost = 1e30f;
+        int bestAxis = -1, bestSplit = 0;
+        for (int axis = 0; axis < 3; ++axis) {
+            float extent = centroidBox.hi[axis] - centroidBox.lo[axis];
+            if (extent <= 0.0f) continue;
+            Bounds binBounds[kBinCount];
+            int binCount[kBinCount] = {};
+            float scale = kBinCount / extent;
+            for (int i = first; i < first + size; ++i) {
+                int bin = std::min(static_cast<int>((centroids[order[i]][axis] - centroidBox.lo[axis]) * scale), kBinCount - 1);
+                binBounds[bin].grow(bounds[order[i]]);
+                ++binCount[bin];
+            }
+            float rightArea[kBinCount];
+            int rightCount[kBinCount];
+            Bounds right;
+            int rightSum = 0;
+            for (int b = kBinCount - 1; b > 0; --b) {
+                right.grow(binBounds[b]);
+                rightSum += binCount[b];
+                rightArea[b] = right.area();
+                rightCount[b] = rightSum;
+            }
+            Bounds left;
+            int leftSum = 0;
+            for (int b = 1; b < kBinCount; ++b) {
+                left.grow(binBounds[b - 1]);
+                leftSum += binCount[b - 1];
+                if (leftSum == 0 || rightCount[b] == 0) continue;
+                float cost = leftSum * left.area() + rightCount[b] * rightArea[b];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = b;
+                }
+            }
+        }
+
+        // Blmek yaprak kalmaktan pahalysa (ya da tm merkezler akksa) yaprak kalr
+        if (bestAxis < 0 || bestCost >= size * box.area()) continue;
+
+        float extent = centroidBox.hi[bestAxis] - centroidBox.lo[bestAxis];
+        float scale = kBinCount / extent;
+        int* middle = std::partition(order.data() + first, order.data() + first + size, [&](int t) {
+            return std::min(static_cast<int>((centroids[t][bestAxis] - centroidBox.lo[bestAxis]) * scale), kBinCount - 1) < bestSplit;
+        });
+        int leftSize = static_cast<int>(middle - (order.data() + first));
+
+        int child = static_cast<int>(mesh.nodes.size());
+        mesh.nodes.push_back(BvhNode{ glm::vec3(0.0f), first, glm::vec3(0.0f), leftSize });
+        mesh.nodes.push_back(BvhNode{ glm::vec3(0.0f), first + leftSize, glm::vec3(0.0f), size - leftSize });
+        mesh.nodes[nodeIndex].first = child;
+        mesh.nodes[nodeIndex].count = 0;
+        pending.push_back(glm::ivec2(child + 1, level + 1));
+        pending.push_back(glm::ivec2(child, level + 1));
+    }
+
+    // Sorgu gen indeksini deil keleri okur: yaprak srasnda ardk diziler
+    mesh.cornerA.resize(count);
+    mesh.cornerB.resize(count);
+    mesh.cornerC.resize(count);
+    for (int i = 0; i < count; ++i) {
+        const glm::ivec3& tri = mesh.triangles[order[i]];
+        mesh.cornerA[i] = mesh.vertices[tri.x];
+        mesh.cornerB[i] = mesh.vertices[tri.y];
+        mesh.cornerC[i] = mesh.vertices[tri.z];
+    }
+}
+
+void collideSpheresWithMeshes(std::vector<Sphere>& spheres, RotationState& rotation,
+    const std::vector<TriangleMesh>& meshes, const MaterialTable& materials) {
+    if (meshes.empty()) return;
+
+    // Derinlik nce dolamada ynda seviye bana en fazla bir bekleyen karde ve son iki ocuk durur
+    int depth = 0;
+    for (const TriangleMesh& mesh : meshes) {
+        depth = std::max(depth, mesh.depth);
+    }
+    const size_t stackSize = static_cast<size_t>(depth) + 2;
+
+    // Engeller sabit olduundan her kre yalnzca kendi durumunu deitirir; kreler bamsz ilenir
+    parallelFor(spheres.size(), [&](size_t begin, size_t end, int) {
+        MeshContact contacts[kMaxContacts];
+        std::vector<int> stack(stackSize);
+        for (size_t s = begin; s < end; ++s) {
+            Sphere& sphere = spheres[s];
+            const float radius = sphere.radius;
+
+            for (const TriangleMesh& mesh : meshes) {
+                if (mesh.nodes.empty()) continue;
+                int contactCount = 0;
+                int top = 0;
+                stack[top++] = 0;
+                while (top > 0) {
+                    const BvhNode& node = mesh.nodes[stack[--top]];
+                    glm::vec3 outside = glm::max(glm::max(node.lo - sphere.position, sphere.position - node.hi), glm::vec3(0.0f));
+                    if (glm::dot(outside, outside) > radius * radius) continue;
+                    if (node.count == 0) {
+                        stack[top++] = node.first + 1;
+                        stack[top++] = node.first;
+                        continue;
+                    }
+                    for (int t = node.first; t < node.first + node.count && contactCount < kMaxContacts; ++t) {
+                        const glm::vec3& a = mesh.cornerA[t];
+                        const glm::vec3& b = mesh.cornerB[t];
+                        const glm::vec3& c = mesh.cornerC[t];
+                        glm::vec3 point = closestPointOnTriangle(sphere.position, a, b, c);
+                        glm::vec3 offset = sphere.position - point;
+                        float distance2 = glm::dot(offset, offset);
+                        if (distance2 >= radius * radius) continue;
+                        // Merkez genin zerindeyse yn yz normalinden alnr
+                        glm::vec3 normal = distance2 > 0.0f ? offset / std::sqrt(distance2) : glm::normalize(glm::cross(b - a, c - a));
+                        contacts[contactCount++] = MeshContact{ point, normal };
+                    }
+                }
+                if (contactCount == 0) continue;
+
+                const int row = mesh.material * MAX_MATERIALS + sphere.material;
+                const float restitution = materials.restitution[row];
+                const float friction = materials.friction[row];
+
+                // Temaslar srayla zlr: ortak kenar ve kelerde ayn yzeyi gren ikinci temas,
+                // ilkinin ardndan hz zaten uzaklat iin tepki vermez
+                for (int k = 0; k < contactCount; ++k) {
+                    const glm::vec3& normal = contacts[k].normal;
+                    float penetration = radius - glm::dot(sphere.position - contacts[k].point, normal);
+                    if (penetration > 0.0f) {
+                        sphere.position += normal * penetration;
+                    }
+                    float normalSpeed = -glm::dot(sphere.velocity, normal);
+                    if (normalSpeed <= 0.0f) continue;
+                    sphere.velocity += normal * ((1.0f + restitution) * normalSpeed);
+
+                    // Srtnme duvarlarla ayndr; a dnya koordinatlarnda olduundan ereve birimdir
+                    glm::vec3 angular = sphereAngularVelocity(rotation, s);
+                    applyWallFriction(rotation, s, radius, -normal, normalSpeed, restitution, friction, glm::mat3(1.0f),
+                        sphere.velocity, angular);
+                }
+            }
+        }
+    }, 256);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Sphere.h"
+#include "Material.h"
+#include "Rotation.h"
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+
+
+// Dzletirilmi BVH dm (32 bayt). count > 0 ise yaprak: genler [first, first + count);
+// deilse ocuklar first ve first + 1 indekslerinde yan yanadr.
+struct BvhNode {
+    glm::vec3 lo;
+    int first;
+    glm::vec3 hi;
+    int count;
+};
+
+// Sabit gen a engeli (dnya koordinatlarnda). Yklemeden sonra buildMeshBvh ile bir kez
+// hiyerari kurulur; gen keleri sorgu iin BVH yaprak srasna kopyalanr.
+struct TriangleMesh {
+    std::vector<glm::vec3> vertices;
+    std::vector<glm::ivec3> triangles;
+    int material = 0;
+
+    std::vector<BvhNode> nodes;
+    int depth = 0; // En derin yapran seviyesi (kk 0); sorgu yn buna gre boyutlanr
+    std::vector<glm::vec3> cornerA, cornerB, cornerC; // Yaprak srasnda
+};
+
+// Wavefront OBJ'den ke (v) ve yz (f) satrlarn okur; okgenler yelpaze ile genlenir,
+// negatif (greli) indeksler desteklenir. Alan sfr olan (keleri dorusal) genler atlanr,
+// normalleri tanmszdr. Dosya alamazsa ya da gen yoksa false dner.
+bool loadObjMesh(const std::string& path, TriangleMesh& mesh);
+
+// Kutu blmeli SAH ile BVH kurar (yaprakta en fazla 4 gen)
+void buildMeshBvh(TriangleMesh& mesh);
+
+// Her kre iin alarla temaslar BVH zerinden paralel bulur ve zer: engel sonsuz ktlelidir,
+// tepki duvarlarla ayndr (malzeme ifti sekme ve srtnmesi, dnme). Kre yzeye geri itilir.
+void collideSpheresWithMeshes(std::vector<Sphere>& spheres, RotationState& rotation,
+    const std::vector<TriangleMesh>& meshes, const MaterialTable& materials);
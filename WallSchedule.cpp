@@ -0,0 +1,116 @@
+#include "WallSchedule.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+void resetWallSchedule(WallSchedule& schedule, size_t sphereCount) {
+    schedule.step = 0;
+    schedule.dueStep.assign(sphereCount, 0);
+    schedule.visitedStep.assign(sphereCount, -1);
+    schedule.buckets.resize(WALL_BUCKET_COUNT);
+    for (std::vector<int>& bucket : schedule.buckets) {
+        bucket.clear();
+    }
+    schedule.invalidated.clear();
+    schedule.due.clear();
+
+    std::vector<int>& first = schedule.buckets[0];
+    first.resize(sphereCount);
+    for (size_t s = 0; s < sphereCount; ++s) {
+        first[s] = static_cast<int>(s);
+    }
+}
+
+void collectDueSpheres(WallSchedule& schedule) {
+    schedule.due.clear();
+    const long long step = schedule.step;
+    auto take = [&](int s) {
+        if (schedule.visitedStep[s] == step) return;
+        schedule.visitedStep[s] = step;
+        schedule.due.push_back(s);
+    };
+
+    // Kovada, tahmini sonradan deimi ya da havuzdan km krelerin eski girdileri de durur;
+    // yalnzca hl var olan ve adm tutanlar alnr
+    const int count = static_cast<int>(schedule.dueStep.size());
+    for (int s : schedule.buckets[step % WALL_BUCKET_COUNT]) {
+        if (s < count && schedule.dueStep[s] == step) take(s);
+    }
+    for (int s : schedule.invalidated) {
+        if (s < count) take(s);
+    }
+    schedule.invalidated.clear();
+}
+
+void scheduleWallCheck(WallSchedule& schedule, int sphere, const glm::vec3& position, const glm::vec3& velocity,
+    float radius, float halfCubeSize, const glm::vec3& acceleration, float deltaTime) {
+    // n admda yar rtk Euler ile alnan yol eksen bana en fazla
+    // n dt (|v| + |a| (n + 1) dt / 2); bu yolun boluu amad en byk n bulunur.
+    float steps = static_cast<float>(WALL_BUCKET_COUNT);
+    for (int i = 0; i < 3; ++i) {
+        float gap = halfCubeSize - radius - std::abs(position[i]);
+        if (gap <= 0.0f) {
+            steps = 0.0f;
+            break;
+        }
+        float a = 0.5f * std::abs(acceleration[i]) * deltaTime * deltaTime;
+        float b = std::abs(velocity[i]) * deltaTime + a;
+        if (b <= 0.0f) continue;
+        float n = a > 0.0f ? (std::sqrt(b * b + 4.0f * a * gap) - b) / (2.0f * a) : gap / b;
+        steps = std::min(steps, n * 0.999f); // Yuvarlama pay
+    }
+
+    // Boluk floor(n) adm boyunca kapanmaz; ilk olas temas bir sonraki admdadr
+    long long ahead = 1 + static_cast<long long>(steps);
+    ahead = std::min<long long>(ahead, WALL_BUCKET_COUNT - 1);
+    long long due = schedule.step + ahead;
+    schedule.dueStep[sphere] = due;
+    schedule.buckets[due % WALL_BUCKET_COUNT].push_back(sphere);
+}
+
+void addWallScheduleSphere(WallSchedule& schedule, int sphere) {
+    if (schedule.dueStep.empty()) return; // Takvim kurulmam; ilk kullanmda sfrlanr
+    schedule.dueStep.push_back(schedule.step);
+    schedule.visitedStep.push_back(-1);
+    schedule.invalidated.push_back(sphere);
+}
+
+void removeWallScheduleSphere(WallSchedule& schedule, int sphere) {
+    if (schedule.dueStep.empty()) return;
+    const int last = static_cast<int>(schedule.dueStep.size()) - 1;
+    schedule.dueStep[sphere] = schedule.dueStep[last];
+    schedule.visitedStep[sphere] = -1;
+    schedule.dueStep.pop_back();
+    schedule.visitedStep.pop_back();
+    if (sphere != last) schedule.invalidated.push_back(sphere);
+}
+
+void permuteWallSchedule(WallSchedule& schedule, const std::vector<int>& order, const std::vector<int>& newIndex) {
+    const int count = static_cast<int>(schedule.dueStep.size());
+    if (count == 0 || count != static_cast<int>(order.size())) return;
+
+    std::vector<long long> dueStep(count), visitedStep(count);
+    for (int i = 0; i < count; ++i) {
+        dueStep[i] = schedule.dueStep[order[i]];
+        visitedStep[i] = schedule.visitedStep[order[i]];
+    }
+    schedule.dueStep.swap(dueStep);
+    schedule.visitedStep.swap(visitedStep);
+
+    // Artk var olmayan krelerin girdileri (s >= count) olduu gibi kalr ve yine atlanr
+    auto remap = [&](std::vector<int>& entries) {
+        for (int& s : entries) {
+            if (s < count) s = newIndex[s];
+        }
+    };
+    for (std::vector<int>& bucket : schedule.buckets) {
+        remap(bucket);
+    }
+    remap(schedule.invalidated);
+}
+
+void advanceWallSchedule(WallSchedule& schedule) {
+    schedule.buckets[schedule.step % WALL_BUCKET_COUNT].clear();
+    ++schedule.step;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+
+
+// Halkadaki kova says; daha uzak tahminler bu kadar adm sonra yeniden hesaplanr
+const int WALL_BUCKET_COUNT = 64;
+
+// Duvar denetimi takvimi. Her kre iin, hz ve duvarlara uzaklndan duvara en erken
+// deebilecei adm tahmin edilir; kre o admn kovasna konur ve yalnzca o admda denetlenir.
+// arpmayla hz deien kreler invalidated listesine eklenir ve ayn admda yeniden tahmin edilir.
+// Tahmin muhafazakrdr: sabit d ivme hesaba katlr, snm yalnzca hz azaltt iin gz ard edilir.
+struct WallSchedule {
+    bool enabled = false;
+    long long step = 0; // lenmekte olan adm
+
+    std::vector<long long> dueStep;     // Kre bana: denetimin gerektii ilk adm
+    std::vector<long long> visitedStep; // Ayn admda iki kez denetlemeyi nler
+    std::vector<std::vector<int>> buckets; // Halka: kova = adm % WALL_BUCKET_COUNT; eskimi girdiler atlanr
+    std::vector<int> invalidated;       // Bu admda hz arpmayla deien kreler (tekrarl olabilir)
+    std::vector<int> due;               // Bu admda denetlenecek kreler
+};
+
+// Takvimi sfrlar: tm kreler bir sonraki admda denetlenir. Kreler dardan tandnda arlmaldr.
+void resetWallSchedule(WallSchedule& schedule, size_t sphereCount);
+
+// Bu admn kovasn ve geersiz klnan kreleri schedule.due'ya toplar (her kre bir kez)
+void collectDueSpheres(WallSchedule& schedule);
+
+// Kreyi, kap erevesindeki konum ve hzndan (duvara gre) hesaplanan en erken temas admnn kovasna koyar
+void scheduleWallCheck(WallSchedule& schedule, int sphere, const glm::vec3& position, const glm::vec3& velocity,
+    float radius, float halfCubeSize, const glm::vec3& acceleration, float deltaTime);
+
+// Havuz gncellemeleri (takvim etkinse): eklenen kre hemen denetlenir. karmada son kre boalan
+// yere tanr; tanan krenin eski kova girdileri geersizletii iin o da hemen denetlenir.
+void addWallScheduleSphere(WallSchedule& schedule, int sphere);
+void removeWallScheduleSphere(WallSchedule& schedule, int sphere);
+
+// Kreler yeniden dizildiinde (order[yeni] = eski, newIndex[eski] = yeni) tahminler krelerle tanr,
+// kova girdileri yeni indekslere evrilir; takvim sfrlanmaz
+void permuteWallSchedule(WallSchedule& schedule, const std::vector<int>& order, const std::vector<int>& newIndex);
+
+// Adm bitirir: ilenen kova boaltlr
+void advanceWallSchedule(WallSchedule& schedule);
@@ -3,6 +3,11 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include "Sphere.h"
+#include "Packing.h"
+#include "Simulation.h"
+#include "SphereBlocks.h"
+#include <cstdlib>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -30,62 +35,6 @@ std::vector<glm::vec3> calculateSphereVertices(float radius, int segments) {
 
 
 
-struct Sphere {
-    glm::vec3 position;
-    float radius;
-    glm::vec3 color;
-    glm::vec3 velocity; // Hz vektr eklendi
-};
-
-// Kreler aras arpmay kontrol et
-void checkCollisions(std::vector<Sphere>& spheres) {
-    for (size_t i = 0; i < spheres.size(); ++i) {
-        for (size_t j = i + 1; j < spheres.size(); ++j) {
-            glm::vec3 diff = spheres[i].position - spheres[j].position;
-            float distance = glm::length(diff);
-            if (distance < (spheres[i].radius + spheres[j].radius)) {
-                // Basit arpma tepkisi: hz vektrlerini takas et
-                std::swap(spheres[i].velocity, spheres[j].velocity);
-            }
-        }
-    }
-}
-
-// Krelerin ve kp snrlarnn arpmasn kontrol et
-void checkCubeCollisions(std::vector<Sphere>& spheres, float cubeSize) {
-    float halfCubeSize = cubeSize / 2.0f;
-    for (auto& sphere : spheres) {
-        for (int i = 0; i < 3; ++i) {
-            if (sphere.position[i] + sphere.radius > halfCubeSize || sphere.position[i] - sphere.radius < -halfCubeSize) {
-                sphere.velocity[i] *= -1; // arpma duvar ile ters ynde hz
-            }
-        }
-    }
-}
-
-// Krelerin pozisyonunu gncelle
-void updateSpherePositions(std::vector<Sphere>& spheres, float deltaTime) {
-    for (auto& sphere : spheres) {
-        // Krenin pozisyonunu hzna gre gncelle
-        sphere.position += sphere.velocity * deltaTime;
-    }
-}
-
-
-
-void updateSimulation(std::vector<Sphere>& spheres, float cubeSize, float deltaTime) {
-    // Pozisyonlar gncelle
-    updateSpherePositions(spheres, deltaTime);
-
-    // arpmalar kontrol et
-    checkCollisions(spheres);
-
-    // Kp snrlar ile arpmay kontrol et
-    checkCubeCollisions(spheres, cubeSize);
-}
-
-
-
 // Her kre iin model matrisi olutur
 std::vector<glm::mat4> createModelMatrices(const std::vector<Sphere>& spheres) {
     std::vector<glm::mat4> modelMatrices;
@@ -172,25 +121,6 @@ glm::vec3 cameraFront = glm::vec3(0.0f, 0.0f, -1.0f);
 glm::vec3 cameraUp = glm::vec3(0.0f, 1.0f, 0.0f);
 
 
-// Global Deikenler
-glm::vec3 position = glm::vec3(0.0f, 0.0f, 0.0f); // Balang pozisyonu
-glm::vec3 velocity = glm::vec3(0.0f, 0.0f, 0.0f); // Balang hz
-float gravity = -9.81f; // Yerekimi ivmesi
-
-
-// Fizik Gncellemesi Fonksiyonu
-void updatePhysics(float deltaTime) {
-    velocity.y += gravity * deltaTime; // Dikey hz gncelle
-    position.y += velocity.y * deltaTime; // Dikey pozisyonu gncelle
-
-    // arpma Alglama ve Tepkisi
-    float groundLevel = -5.0f; // Zemin seviyesi
-    if (position.y < groundLevel) {
-        velocity.y = -velocity.y; // Yansma
-        position.y = groundLevel; // Zemin seviyesine ayarla
-    }
-}
-
 void processInput(GLFWwindow* window) {
     const float cameraSpeed = 0.001f; // Hz sabiti, daha yava bir hz iin 0.05'ten 0.02'ye drld
     if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
@@ -220,6 +150,49 @@ void drawCube(GLuint shaderProgram, GLuint cubeVAO) {
     glDisable(GL_BLEND);
 }
 
+// Kutular kp ayla, kapsller ekseni boyunca uzatlm kre ayla (yaklak), gvdeler yeleriyle izilir
+void drawShapes(const SimulationContext& simulation, const glm::mat4& view, const glm::mat4& projection, GLuint shaderProgram,
+    GLuint sphereVAO, GLsizei sphereVertexCount, GLuint cubeVAO) {
+    glUseProgram(shaderProgram);
+    unsigned int modelLoc = glGetUniformLocation(shaderProgram, "model");
+    unsigned int viewLoc = glGetUniformLocation(shaderProgram, "view");
+    unsigned int projLoc = glGetUniformLocation(shaderProgram, "projection");
+    unsigned int colorLoc = glGetUniformLocation(shaderProgram, "sphereColor");
+    glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
+    glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
+
+    for (const Box& box : simulation.boxes) {
+        glm::mat4 modelMatrix = glm::translate(glm::mat4(1.0f), box.position) * glm::mat4_cast(box.orientation);
+        modelMatrix = glm::scale(modelMatrix, 2.0f * box.halfExtents);
+        glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(modelMatrix));
+        glUniform3fv(colorLoc, 1, &box.color[0]);
+        glBindVertexArray(cubeVAO);
+        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+    }
+
+    for (const Capsule& capsule : simulation.capsules) {
+        glm::mat4 modelMatrix = glm::translate(glm::mat4(1.0f), capsule.position) * glm::mat4_cast(capsule.orientation);
+        modelMatrix = glm::scale(modelMatrix, glm::vec3(capsule.radius, capsule.halfLength + capsule.radius, capsule.radius));
+        glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(modelMatrix));
+        glUniform3fv(colorLoc, 1, &capsule.color[0]);
+        glBindVertexArray(sphereVAO);
+        glDrawArrays(GL_TRIANGLES, 0, sphereVertexCount);
+    }
+
+    // Gvde yeleri, gvdenin ynelimiyle dndrlm kreler olarak
+    const ClumpSystem& clumps = simulation.clumps;
+    for (size_t i = 0; i < clumps.memberCount; ++i) {
+        size_t body = clumps.owner[i];
+        glm::mat4 modelMatrix = glm::translate(glm::mat4(1.0f), clumpMemberPosition(clumps, i)) * glm::mat4_cast(sphereOrientation(clumps.rotation, body));
+        modelMatrix = glm::scale(modelMatrix, glm::vec3(clumps.memberRadius[i]));
+        glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(modelMatrix));
+        glUniform3fv(colorLoc, 1, &clumps.color[body][0]);
+        glBindVertexArray(sphereVAO);
+        glDrawArrays(GL_TRIANGLES, 0, sphereVertexCount);
+    }
+    glBindVertexArray(0);
+}
+
 
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods) {
     if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS) {
@@ -227,7 +200,33 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
     }
 }
 
-int main() {
+// --layout-benchmark [kre says]: AoS, SoA ve AoSoA dzenlerini pencere amadan karlatrr
+int runLayoutBenchmark(int sphereCount) {
+    const float cubeSize = 2.0f;
+    const float deltaTime = 1.0f / 600.0f;
+    const int steps = 50;
+    std::vector<Sphere> spheres = generateJammedPacking(sphereCount, cubeSize, 0.4f);
+    MaterialTable materials;
+    int material = addMaterial(materials, 0.7f, 0.0f);
+    for (Sphere& sphere : spheres) {
+        sphere.material = material;
+    }
+
+    const char* names[] = { "AoS", "SoA", "AoSoA" };
+    for (int layout = SPHERE_LAYOUT_AOS; layout <= SPHERE_LAYOUT_AOSOA; ++layout) {
+        LayoutBenchmark result = benchmarkSphereLayout(spheres, static_cast<SphereLayout>(layout), cubeSize, deltaTime, steps,
+            materials, material, glm::vec3(0.0f, -9.81f, 0.0f));
+        std::cout << names[layout] << ": tmleme " << result.integrateMs << " ms, duvar " << result.wallMs
+                  << " ms, iftler " << result.pairMs << " ms, temas " << result.contacts << std::endl;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "--layout-benchmark") {
+        return runLayoutBenchmark(argc > 2 ? std::atoi(argv[2]) : 200000);
+    }
+
     // GLFW balatma ve pencere oluturma ilemleri
     if (!glfwInit()) {
         std::cerr << "GLFW balatlamad!" << std::endl;
@@ -262,30 +261,25 @@ int main() {
 
     const float cubeSize = 2.0f; // Kpn kenar uzunluu
     const float maxSphereRadius = 0.2f; // Kreler iin maksimum yarap
-// Krelerin konumlandrlaca maksimum uzaklk, kpn kenarnn yars kre yarap karlm olmal
-    const float maxPositionOffset = (cubeSize / 2.0f) - maxSphereRadius;
-
-    // Krelerin oluturulduu dng iinde
-    std::vector<Sphere> spheres;
-    for (int i = 0; i < sphereCount; ++i) {
-        // Kpn iinde yer alacak ekilde kreler iin rastgele pozisyonlar
-        float xPos = ((float)rand() / RAND_MAX) * (maxPositionOffset * 2) - maxPositionOffset;
-        float yPos = ((float)rand() / RAND_MAX) * (maxPositionOffset * 2) - maxPositionOffset;
-        float zPos = ((float)rand() / RAND_MAX) * (maxPositionOffset * 2) - maxPositionOffset;
-
-        // Rastgele renkler iin
-        glm::vec3 color = glm::vec3(static_cast<float>(rand()) / static_cast<float>(RAND_MAX),
-            static_cast<float>(rand()) / static_cast<float>(RAND_MAX),
-            static_cast<float>(rand()) / static_cast<float>(RAND_MAX));
-
-        // Kreleri olutur ve hz vektrleri ile birlikte kaydet
-        float radius = maxSphereRadius; // Bu rnekte tm kreler ayn yarapa sahip
-        float randVelocityX = ((float)rand() / RAND_MAX) * 2.0f - 1.0f; // -1.0 ile 1.0 arasnda
-        float randVelocityY = ((float)rand() / RAND_MAX) * 2.0f - 1.0f;
-        float randVelocityZ = ((float)rand() / RAND_MAX) * 2.0f - 1.0f;
-
-        Sphere sphere = { glm::vec3(xPos, yPos, zPos), radius, color, glm::vec3(randVelocityX, randVelocityY, randVelocityZ) };
-        spheres.push_back(sphere);
+    // Bu rnekte tm kreler ayn yarapa sahip, doluluk oran bu yaraptan hesaplanr
+    const float packingFraction = sphereCount * (4.0f / 3.0f) * glm::pi<float>() * maxSphereRadius * maxSphereRadius * maxSphereRadius
+        / (cubeSize * cubeSize * cubeSize);
+
+    // Kreleri kpn iine akmadan yerletir, rastgele renk ve hzlaryla birlikte
+    std::vector<Sphere> spheres = generateJammedPacking(sphereCount, cubeSize, packingFraction);
+
+    // Malzeme tablolar, geni faz tamponlar ve dier simlasyon durumu
+    SimulationContext simulation;
+    resizeRotationState(simulation.rotation, spheres.size());
+
+    // Esnek ama srtnmeli kreler ve duvarlar; temaslarda dnme kazanrlar
+    int ballMaterial = addMaterial(simulation.materials, 1.0f, 0.3f);
+    simulation.wallMaterial = ballMaterial;
+    simulation.bodyForces.gravity = glm::vec3(0.0f, -9.81f, 0.0f); // Yerekimi ivmesi
+    // Kap (0.5, 1, 0) ekseni etrafnda saniyede bir radyan dner
+    simulation.container.angularVelocity = glm::normalize(glm::vec3(0.5f, 1.0f, 0.0f));
+    for (Sphere& sphere : spheres) {
+        sphere.material = ballMaterial;
     }
 
 
@@ -435,20 +429,17 @@ int main() {
         deltaTime = currentFrameTime - lastFrameTime;
         lastFrameTime = currentFrameTime;
 
-        updatePhysics(deltaTime);
-
         glm::mat4 view = glm::lookAt(cameraPos, cameraPos + cameraFront, cameraUp);
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::rotate(model, (float)glfwGetTime(), glm::vec3(0.5f, 1.0f, 0.0f));
+        // Kp, simlasyonun kulland kap dnmyle izilir
+        glm::mat4 model = containerTransform(simulation.container, cubeSize);
 
 
         for (size_t i = 0; i < spheres.size(); ++i) {
             glm::mat4 modelMatrix = glm::mat4(1.0f);
             modelMatrix = glm::translate(modelMatrix, spheres[i].position);
 
-            // Dnme ilemi eklenebilir
-            float rotationSpeed = 1.0f; // Dnme hz
-            modelMatrix = glm::rotate(modelMatrix, (float)glfwGetTime() * rotationSpeed, glm::vec3(0.5f, 1.0f, 0.0f));
+            // Simlasyondaki ynelimle dndr
+            modelMatrix = modelMatrix * glm::mat4_cast(sphereOrientation(simulation.rotation, i));
 
             // Krenin boyutunu kltmek iin radius deerini drn
             float scaleFactor = 0.25f; // Kltme faktr
@@ -456,9 +447,10 @@ int main() {
 
             drawSphere(spheres[i], view, projection, shaderProgram, sphereVAO, sphereVertices, modelMatrix);
         }
+        drawShapes(simulation, view, projection, shaderProgram, sphereVAO, static_cast<GLsizei>(sphereVertices.size()), cubeVAO);
 
         // Krelerin ve arpmalarn simlasyonunu gncelle
-        updateSimulation(spheres, cubeSize, deltaTime);
+        updateSimulation(spheres, cubeSize, deltaTime, simulation);
 
 
         glUseProgram(shaderProgram);
@@ -466,9 +458,10 @@ int main() {
         glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
         glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
 
-        glBindVertexArray(sphereVAO);
-        glDrawArrays(GL_TRIANGLES, 0, sphereVertices.size());
-        glBindVertexArray(0);
+        // Krelerin grnmesi iin kap tel kafes olarak izilir
+        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+        drawCube(shaderProgram, cubeVAO);
+        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 
         glfwSwapBuffers(window);
         glfwPollEvents();